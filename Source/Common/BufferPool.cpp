@@ -0,0 +1,261 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "BufferPool.h"
+
+#include <cstdlib>
+
+std::atomic<BufferPool*> BufferPool::s_Current(nullptr);
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BufferPool::BufferPool(qint64 maxPooledBytes)
+: m_State(new State)
+{
+  m_State->maxPooledBytes = qMax(Q_INT64_C(0), maxPooledBytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BufferPool::~BufferPool()
+{
+  std::lock_guard<std::mutex> lock(m_State->mutex);
+  m_State->closed = true;
+  Trim(*m_State);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t BufferPool::ClassSize(size_t size)
+{
+  size_t power = 4096;
+  while(power * 2 <= size)
+  {
+    power *= 2;
+  }
+  size_t step = qMax(power / 8, size_t(4096));
+  return qMax((size + step - 1) / step * step, step);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void* BufferPool::allocate(size_t size)
+{
+  return Allocate(*m_State, size);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BufferPool::release(void* ptr, size_t size)
+{
+  Release(*m_State, ptr, size);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BufferPool::trim()
+{
+  std::lock_guard<std::mutex> lock(m_State->mutex);
+  Trim(*m_State);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject BufferPool::statistics() const
+{
+  std::lock_guard<std::mutex> lock(m_State->mutex);
+  QJsonObject statistics;
+  statistics["allocations"] = m_State->allocations;
+  statistics["hits"] = m_State->hits;
+  statistics["misses"] = m_State->misses;
+  statistics["pooledBytes"] = m_State->pooledBytes;
+  statistics["highWaterBytes"] = m_State->highWaterBytes;
+  statistics["peakPooledBytes"] = m_State->peakPooledBytes;
+  return statistics;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString BufferPool::Summary(const QJsonObject& statistics)
+{
+  const double megabyte = 1024.0 * 1024.0;
+  qint64 allocations = static_cast<qint64>(statistics["allocations"].toDouble());
+  qint64 hits = static_cast<qint64>(statistics["hits"].toDouble());
+  double hitRate = allocations > 0 ? 100.0 * hits / allocations : 0.0;
+  return QString("Buffer pool: %1 of %2 large allocations reused (%3%), high water %4 MB, most kept for reuse %5 MB")
+      .arg(hits)
+      .arg(allocations)
+      .arg(hitRate, 0, 'f', 1)
+      .arg(statistics["highWaterBytes"].toDouble() / megabyte, 0, 'f', 0)
+      .arg(statistics["peakPooledBytes"].toDouble() / megabyte, 0, 'f', 0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BufferPool* BufferPool::Current()
+{
+  return s_Current.load();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BufferPool::Scope::Scope(BufferPool* pool)
+{
+  BufferPool* expected = nullptr;
+  if(nullptr != pool && s_Current.compare_exchange_strong(expected, pool))
+  {
+    m_Pool = pool;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BufferPool::Scope::~Scope()
+{
+  if(nullptr != m_Pool)
+  {
+    s_Current.store(nullptr);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool BufferPool::Scope::isInstalled() const
+{
+  return nullptr != m_Pool;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BufferPool::Lease::Lease(std::shared_ptr<State> state, void* block, size_t bytes)
+: state(state)
+, block(block)
+, bytes(bytes)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+BufferPool::Lease::~Lease()
+{
+  array.reset();
+  Release(*state, block, bytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void* BufferPool::Allocate(State& state, size_t size)
+{
+  size_t classSize = ClassSize(size);
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.allocations++;
+  void* block = nullptr;
+  auto iter = state.freeBlocks.find(classSize);
+  if(iter != state.freeBlocks.end() && !iter->second.empty())
+  {
+    block = iter->second.back();
+    iter->second.pop_back();
+    state.pooledBytes -= classSize;
+    state.hits++;
+  }
+  else
+  {
+    block = std::malloc(classSize);
+    if(nullptr == block)
+    {
+      return nullptr;
+    }
+    state.misses++;
+  }
+  state.liveBytes += classSize;
+  state.highWaterBytes = qMax(state.highWaterBytes, state.liveBytes + state.pooledBytes);
+  return block;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BufferPool::Release(State& state, void* ptr, size_t size)
+{
+  if(nullptr == ptr)
+  {
+    return;
+  }
+  size_t classSize = ClassSize(size);
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.liveBytes -= classSize;
+  if(!state.closed && state.pooledBytes + static_cast<qint64>(classSize) <= state.maxPooledBytes)
+  {
+    state.freeBlocks[classSize].push_back(ptr);
+    state.pooledBytes += classSize;
+    state.peakPooledBytes = qMax(state.peakPooledBytes, state.pooledBytes);
+  }
+  else
+  {
+    std::free(ptr);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void BufferPool::Trim(State& state)
+{
+  for(auto& sizeClass : state.freeBlocks)
+  {
+    for(void* block : sizeClass.second)
+    {
+      std::free(block);
+    }
+  }
+  state.freeBlocks.clear();
+  state.pooledBytes = 0;
+}
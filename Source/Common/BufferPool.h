@@ -0,0 +1,224 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+
+/**
+ * @brief The BufferPool class recycles the storage of large arrays between the filters of a pipeline run.
+ * A freed block is kept in a free list of its size class instead of being returned to the operating system,
+ * and a later allocation of the same size class gets it back with its pages already faulted in. The size
+ * classes are an eighth of the power of two below the size, so at most an eighth of a block is wasted. The
+ * free lists keep at most 'maxPooledBytes'; trim() and the destructor return them to the system.
+ *
+ * The pool is an explicit allocator hook: a run installs its pool with a Scope, and code that creates arrays
+ * during the run calls CreateArray(), which takes the storage from the installed pool and gives it back
+ * when the last reference to the array goes away. Without an installed pool, and for arrays below
+ * k_MinimumBytes, CreateArray() is DataArray<T>::CreateArray(). The arrays do not own their storage, so
+ * DataArray copies it instead of calling realloc() when it is resized.
+ */
+class BufferPool
+{
+public:
+  static const size_t k_MinimumBytes = 1024 * 1024;
+
+  /**
+   * @brief BufferPool
+   * @param maxPooledBytes The most memory that freed blocks may keep while they wait to be reused
+   */
+  explicit BufferPool(qint64 maxPooledBytes);
+
+  /**
+   * @brief Returns the free blocks to the system. Blocks that are still in use are freed when they are
+   * released.
+   */
+  ~BufferPool();
+
+  /**
+   * @brief Returns the number of bytes that a block for 'size' bytes has
+   * @param size
+   * @return
+   */
+  static size_t ClassSize(size_t size);
+
+  /**
+   * @brief Returns a block of at least 'size' bytes, a freed block of the same size class if there is one
+   * @param size
+   * @return nullptr if the memory could not be allocated
+   */
+  void* allocate(size_t size);
+
+  /**
+   * @brief Takes back a block that allocate() returned for 'size' bytes
+   * @param ptr
+   * @param size
+   */
+  void release(void* ptr, size_t size);
+
+  /**
+   * @brief Returns the free blocks to the system
+   */
+  void trim();
+
+  /**
+   * @brief Returns "allocations", "hits" and "misses", "pooledBytes", the memory that freed blocks keep now,
+   * "highWaterBytes", the most memory that the pool managed at once in use or free, and "peakPooledBytes",
+   * the most memory that freed blocks kept
+   * @return
+   */
+  QJsonObject statistics() const;
+
+  /**
+   * @brief Returns one line describing the statistics for a log
+   * @param statistics
+   * @return
+   */
+  static QString Summary(const QJsonObject& statistics);
+
+  /**
+   * @brief Returns the pool of the run that is executing, or nullptr
+   * @return
+   */
+  static BufferPool* Current();
+
+  /**
+   * @brief The Scope class installs a pool as Current() for its lifetime. Only one pool is installed at a
+   * time; the scope of a run that overlaps another one installs nothing.
+   */
+  class Scope
+  {
+  public:
+    explicit Scope(BufferPool* pool);
+    ~Scope();
+
+    /**
+     * @brief Returns true if the pool of this scope is Current()
+     * @return
+     */
+    bool isInstalled() const;
+
+  private:
+    BufferPool* m_Pool = nullptr;
+
+  public:
+    Scope(const Scope&) = delete;            // Copy Constructor Not Implemented
+    Scope(Scope&&) = delete;                 // Move Constructor Not Implemented
+    Scope& operator=(const Scope&) = delete; // Copy Assignment Not Implemented
+    Scope& operator=(Scope&&) = delete;      // Move Assignment Not Implemented
+  };
+
+  /**
+   * @brief Creates an array whose storage comes from Current()
+   * @param numTuples
+   * @param cDims
+   * @param name
+   * @return
+   */
+  template <typename T>
+  static typename DataArray<T>::Pointer CreateArray(size_t numTuples, const QVector<size_t>& cDims, const QString& name)
+  {
+    size_t bytes = std::accumulate(cDims.begin(), cDims.end(), numTuples, std::multiplies<size_t>()) * sizeof(T);
+    BufferPool* pool = Current();
+    void* block = nullptr != pool && bytes >= k_MinimumBytes ? pool->allocate(bytes) : nullptr;
+    if(nullptr == block)
+    {
+      return DataArray<T>::CreateArray(numTuples, cDims, name, true);
+    }
+
+    // The array is destroyed before its block goes back, however long the array is held
+    std::shared_ptr<Lease> lease(new Lease(pool->m_State, block, bytes));
+    typename DataArray<T>::Pointer array = DataArray<T>::WrapPointer(static_cast<T*>(block), numTuples, cDims, name, false);
+    lease->array = array;
+    return typename DataArray<T>::Pointer(lease, array.get());
+  }
+
+private:
+  struct State
+  {
+    std::mutex mutex;
+    bool closed = false;
+    qint64 maxPooledBytes = 0;
+    std::map<size_t, std::vector<void*>> freeBlocks;
+    qint64 pooledBytes = 0;
+    qint64 liveBytes = 0;
+    qint64 allocations = 0;
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 highWaterBytes = 0;
+    qint64 peakPooledBytes = 0;
+  };
+
+  /**
+   * @brief The storage of an array from CreateArray()
+   */
+  struct Lease
+  {
+    Lease(std::shared_ptr<State> state, void* block, size_t bytes);
+    ~Lease();
+
+    std::shared_ptr<State> state;
+    void* block = nullptr;
+    size_t bytes = 0;
+    IDataArray::Pointer array;
+  };
+
+  static void* Allocate(State& state, size_t size);
+  static void Release(State& state, void* ptr, size_t size);
+  static void Trim(State& state);
+
+  // Leases keep the state, so blocks that outlive the pool can still be freed
+  std::shared_ptr<State> m_State;
+  static std::atomic<BufferPool*> s_Current;
+
+public:
+  BufferPool(const BufferPool&) = delete;            // Copy Constructor Not Implemented
+  BufferPool(BufferPool&&) = delete;                 // Move Constructor Not Implemented
+  BufferPool& operator=(const BufferPool&) = delete; // Copy Assignment Not Implemented
+  BufferPool& operator=(BufferPool&&) = delete;      // Move Assignment Not Implemented
+};
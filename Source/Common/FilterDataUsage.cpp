@@ -0,0 +1,134 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "FilterDataUsage.h"
+
+#include <QtCore/QSet>
+
+#include "SIMPLib/FilterParameters/FilterParameter.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterDataUsage FilterDataUsage::Scan(AbstractFilter::Pointer filter)
+{
+  FilterDataUsage usage;
+
+  static const QSet<QString> fileWidgets = {"InputFileWidget", "OutputFileWidget", "InputPathWidget", "OutputPathWidget", "DataContainerReaderWidget", "FileListInfoWidget"};
+  static const QSet<QString> pathWidgets = {"DataContainerSelectionWidget",   "DataContainerCreationWidget", "AttributeMatrixSelectionWidget", "AttributeMatrixCreationWidget",
+                                            "DataArraySelectionWidget",       "DataArrayCreationWidget",     "MultiDataArraySelectionWidget",  "LinkedPathCreationWidget"};
+  static const QSet<QString> valueWidgets = {"IntWidget",
+                                             "UInt64Widget",
+                                             "DoubleWidget",
+                                             "StringWidget",
+                                             "BooleanWidget",
+                                             "ChoiceWidget",
+                                             "DynamicChoiceWidget",
+                                             "LinkedBooleanWidget",
+                                             "LinkedChoicesWidget",
+                                             "IntVec2Widget",
+                                             "IntVec3Widget",
+                                             "FloatVec2Widget",
+                                             "FloatVec3Widget",
+                                             "FloatVec4Widget",
+                                             "RangeWidget",
+                                             "AxisAngleWidget",
+                                             "NumericTypeWidget",
+                                             "ScalarTypeWidget",
+                                             "SecondOrderPolynomialWidget",
+                                             "ThirdOrderPolynomialWidget",
+                                             "FourthOrderPolynomialWidget",
+                                             "DynamicTableWidget",
+                                             "ShapeTypeSelectionWidget",
+                                             "PhaseTypeSelectionWidget",
+                                             "PreflightUpdatedValueWidget",
+                                             "SeparatorWidget",
+                                             "ParagraphWidget"};
+
+  for(FilterParameter::Pointer parameter : filter->getFilterParameters())
+  {
+    QString widgetType = parameter->getWidgetType();
+    if(fileWidgets.contains(widgetType))
+    {
+      usage.fileAccess = true;
+      continue;
+    }
+    if(valueWidgets.contains(widgetType))
+    {
+      continue;
+    }
+    if(!pathWidgets.contains(widgetType))
+    {
+      usage.unknown = true;
+      continue;
+    }
+
+    QVariant value = filter->property(parameter->getPropertyName().toLatin1().constData());
+    if(value.userType() == qMetaTypeId<DataArrayPath>())
+    {
+      usage.paths.push_back(value.value<DataArrayPath>());
+    }
+    else if(value.userType() == qMetaTypeId<QVector<DataArrayPath>>())
+    {
+      for(const DataArrayPath& path : value.value<QVector<DataArrayPath>>())
+      {
+        usage.paths.push_back(path);
+      }
+    }
+    else if(value.type() == QVariant::String)
+    {
+      // Data container parameters hold a name; the other names are relative to a path parameter
+      if(widgetType.startsWith("DataContainer"))
+      {
+        usage.paths.push_back(DataArrayPath(value.toString(), QString(), QString()));
+      }
+    }
+    else
+    {
+      usage.unknown = true;
+    }
+  }
+
+  QVector<DataArrayPath> paths;
+  for(const DataArrayPath& path : usage.paths)
+  {
+    if(!path.getDataContainerName().isEmpty())
+    {
+      paths.push_back(path);
+    }
+  }
+  usage.paths = paths;
+  return usage;
+}
@@ -0,0 +1,456 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineCheckpoint.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QTemporaryFile>
+
+#include "SIMPLib/CoreFilters/DataContainerReader.h"
+#include "SIMPLib/CoreFilters/DataContainerWriter.h"
+#include "SIMPLib/FilterParameters/DataContainerReaderFilterParameter.h"
+#include "SIMPLib/FilterParameters/FileListInfoFilterParameter.h"
+#include "SIMPLib/FilterParameters/FilterParameter.h"
+#include "SIMPLib/SIMPLibVersion.h"
+#include "SIMPLib/Utilities/FilePathGenerator.h"
+
+#include "Common/FilterDataUsage.h"
+
+namespace
+{
+// Changing how checkpoints are written or hashed must change this so old checkpoints are not found again
+const QByteArray k_CheckpointVersion("SIMPLView Checkpoint 3");
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerWriter::Pointer CreateWriter(const QString& checkpointFile)
+{
+  DataContainerWriter::Pointer writer = DataContainerWriter::New();
+  writer->setOutputFile(checkpointFile);
+  writer->setWriteXdmfFile(false);
+  writer->setWriteTimeSeries(false);
+  return writer;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerReader::Pointer CreateReader(const QString& checkpointFile)
+{
+  DataContainerReader::Pointer reader = DataContainerReader::New();
+  reader->setInputFile(checkpointFile);
+  DataContainerArrayProxy proxy = reader->readDataContainerArrayStructure(checkpointFile);
+  proxy.setAllFlags(Qt::Checked);
+  reader->setInputFileDataContainerArrayProxy(proxy);
+  reader->setOverwriteExistingDataContainers(true);
+  return reader;
+}
+
+// -----------------------------------------------------------------------------
+// Returns the identity of one input file or directory, or an empty array if its content can not be read
+// -----------------------------------------------------------------------------
+QByteArray InputFileIdentity(const QString& name, const QString& path, PipelineCheckpoint::InputIdentity identity)
+{
+  QFileInfo fi(path);
+  if(identity == PipelineCheckpoint::InputIdentity::FileContent)
+  {
+    QByteArray contentHash = PipelineCheckpoint::ContentHash(fi.absoluteFilePath());
+    if(contentHash.isEmpty())
+    {
+      return QByteArray();
+    }
+    return name.toUtf8() + "|" + contentHash + "\n";
+  }
+  return QString("%1|%2|%3\n").arg(fi.absoluteFilePath()).arg(fi.size()).arg(fi.lastModified().toMSecsSinceEpoch()).toUtf8();
+}
+
+// -----------------------------------------------------------------------------
+// Appends an identity for every input file or directory of a filter to 'identities', so that a changed input
+// invalidates a checkpoint just like a changed parameter. With FileContent the input paths are also taken out
+// of 'parameters', so the same data under another path or on another machine gets the same hash. Returns
+// false if the filter may read files that can not be identified, such as through the widgets of plugins.
+// -----------------------------------------------------------------------------
+bool InputFileIdentities(AbstractFilter::Pointer filter, PipelineCheckpoint::InputIdentity identity, QJsonObject& parameters, QByteArray& identities)
+{
+  // A disabled filter reads nothing
+  if(!filter->getEnabled())
+  {
+    return true;
+  }
+  if(FilterDataUsage::Scan(filter).unknown)
+  {
+    return false;
+  }
+
+  for(FilterParameter::Pointer parameter : filter->getFilterParameters())
+  {
+    QString widgetType = parameter->getWidgetType();
+    QString propertyName = parameter->getPropertyName();
+    if(widgetType == "DataContainerReaderWidget")
+    {
+      // The parameter itself holds the selection; the file is in a property of its own
+      DataContainerReaderFilterParameter::Pointer readerParameter = std::dynamic_pointer_cast<DataContainerReaderFilterParameter>(parameter);
+      if(nullptr == readerParameter.get())
+      {
+        return false;
+      }
+      propertyName = readerParameter->getInputFileProperty();
+    }
+    else if(widgetType == "FileListInfoWidget")
+    {
+      QVariant value = filter->property(propertyName.toLatin1().constData());
+      if(value.userType() != qMetaTypeId<FileListInfo_t>())
+      {
+        return false;
+      }
+      FileListInfo_t info = value.value<FileListInfo_t>();
+      bool hasMissingFiles = false;
+      QVector<QString> files = FilePathGenerator::GenerateFileList(info.StartIndex, info.EndIndex, info.IncrementIndex, hasMissingFiles, info.Ordering == 0, info.InputPath,
+                                                                   info.FilePrefix, info.FileSuffix, info.FileExtension, info.PaddingDigits);
+      if(identity == PipelineCheckpoint::InputIdentity::FileContent)
+      {
+        parameters.remove(propertyName);
+      }
+      for(int i = 0; i < files.size(); i++)
+      {
+        QByteArray fileIdentity = InputFileIdentity(QString("%1[%2]").arg(propertyName).arg(i), files[i], identity);
+        if(fileIdentity.isEmpty())
+        {
+          return false;
+        }
+        identities.append(fileIdentity);
+      }
+      continue;
+    }
+    else if(widgetType != "InputFileWidget" && widgetType != "InputPathWidget")
+    {
+      continue;
+    }
+
+    QVariant value = filter->property(propertyName.toLatin1().constData());
+    if(value.type() != QVariant::String)
+    {
+      return false;
+    }
+    QString path = value.toString();
+    if(path.isEmpty())
+    {
+      continue;
+    }
+    if(identity == PipelineCheckpoint::InputIdentity::FileContent)
+    {
+      parameters.remove(propertyName);
+    }
+    QByteArray fileIdentity = InputFileIdentity(propertyName, path, identity);
+    if(fileIdentity.isEmpty())
+    {
+      return false;
+    }
+    identities.append(fileIdentity);
+  }
+  return true;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineCheckpointPolicy::isEnabled() const
+{
+  return !directory.isEmpty() && (resume || everyFilters > 0 || minimumSeconds > 0.0 || !afterFilters.isEmpty());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineCheckpointPolicy::wantsCheckpointAfter(int filterIndex, double seconds) const
+{
+  if(everyFilters > 0 && (filterIndex + 1) % everyFilters == 0)
+  {
+    return true;
+  }
+  if(minimumSeconds > 0.0 && seconds >= minimumSeconds)
+  {
+    return true;
+  }
+  return afterFilters.contains(filterIndex);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineCheckpointPolicy::toJson() const
+{
+  QJsonObject json;
+  json["directory"] = directory;
+  json["everyFilters"] = everyFilters;
+  json["minimumSeconds"] = minimumSeconds;
+  QJsonArray indices;
+  for(int index : afterFilters)
+  {
+    indices.append(index);
+  }
+  json["afterFilters"] = indices;
+  json["resume"] = resume;
+  return json;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineCheckpointPolicy PipelineCheckpointPolicy::FromJson(const QJsonObject& json)
+{
+  PipelineCheckpointPolicy policy;
+  policy.directory = json["directory"].toString();
+  policy.everyFilters = json["everyFilters"].toInt();
+  policy.minimumSeconds = json["minimumSeconds"].toDouble();
+  for(const QJsonValue& index : json["afterFilters"].toArray())
+  {
+    policy.afterFilters.push_back(index.toInt());
+  }
+  policy.resume = json["resume"].toBool();
+  return policy;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineCheckpoint::PipelineCheckpoint() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineCheckpoint::~PipelineCheckpoint() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineCheckpoint::WriteAfter(FilterPipeline::Pointer pipeline, int filterCount, const QString& checkpointFile)
+{
+  while(pipeline->getFilterContainer().size() > filterCount)
+  {
+    pipeline->popBack();
+  }
+
+  pipeline->pushBack(CreateWriter(checkpointFile));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineCheckpoint::StartFrom(FilterPipeline::Pointer pipeline, int filterCount, const QString& checkpointFile)
+{
+  for(int i = 0; i < filterCount && !pipeline->getFilterContainer().isEmpty(); i++)
+  {
+    pipeline->popFront();
+  }
+
+  pipeline->pushFront(CreateReader(checkpointFile));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList PipelineCheckpoint::PrefixHashes(FilterPipeline::Pointer pipeline, InputIdentity identity)
+{
+  // Each hash covers the previous one, so a change to a filter changes the hashes of all later prefixes. The
+  // SIMPLib version is part of it because a filter may compute something else in another version.
+  QByteArray hash = QCryptographicHash::hash(k_CheckpointVersion + SIMPLib::Version::Complete().toUtf8(), QCryptographicHash::Sha1).toHex();
+  QStringList hashes;
+  hashes << QString::fromLatin1(hash);
+  bool identified = true;
+  for(AbstractFilter::Pointer filter : pipeline->getFilterContainer())
+  {
+    QJsonObject parameters;
+    filter->writeFilterParameters(parameters);
+    QByteArray inputs;
+    // Once a filter reads something that is not part of the hash, no later prefix can be found again safely
+    identified = identified && InputFileIdentities(filter, identity, parameters, inputs);
+    if(!identified)
+    {
+      hashes << QString();
+      continue;
+    }
+    QCryptographicHash sha1(QCryptographicHash::Sha1);
+    sha1.addData(hash);
+    sha1.addData(filter->getNameOfClass().toUtf8());
+    sha1.addData(filter->getEnabled() ? "1" : "0");
+    // QJsonObject keeps its keys sorted, so this is a canonical form of the parameters
+    sha1.addData(QJsonDocument(parameters).toJson(QJsonDocument::Compact));
+    sha1.addData(inputs);
+    hash = sha1.result().toHex();
+    hashes << QString::fromLatin1(hash);
+  }
+  return hashes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray PipelineCheckpoint::ContentHash(const QString& path)
+{
+  static QMutex mutex;
+  static QHash<QString, QByteArray> hashes;
+
+  QFileInfo fi(path);
+  QCryptographicHash sha1(QCryptographicHash::Sha1);
+  if(fi.isDir())
+  {
+    // Editing a file does not change the size or modification time of its directory, so the directory is
+    // listed on every call and only the hashes of its files are remembered
+    QDir dir(fi.absoluteFilePath());
+    QStringList files;
+    QDirIterator iter(dir.absolutePath(), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+      files << dir.relativeFilePath(iter.next());
+    }
+    files.sort();
+    for(const QString& file : files)
+    {
+      QByteArray fileHash = ContentHash(dir.filePath(file));
+      if(fileHash.isEmpty())
+      {
+        return QByteArray();
+      }
+      sha1.addData(file.toUtf8());
+      sha1.addData(fileHash);
+    }
+    return sha1.result().toHex();
+  }
+
+  QString memoKey = QString("%1|%2|%3").arg(fi.absoluteFilePath()).arg(fi.size()).arg(fi.lastModified().toMSecsSinceEpoch());
+  {
+    QMutexLocker lock(&mutex);
+    if(hashes.contains(memoKey))
+    {
+      return hashes.value(memoKey);
+    }
+  }
+
+  QFile file(fi.absoluteFilePath());
+  if(!file.open(QIODevice::ReadOnly) || !sha1.addData(&file))
+  {
+    // Missing inputs on two machines must not look like the same data
+    return QByteArray();
+  }
+
+  QByteArray hash = sha1.result().toHex();
+  QMutexLocker lock(&mutex);
+  hashes.insert(memoKey, hash);
+  return hash;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineCheckpoint::CheckpointFile(const QString& directory, int filterCount, const QString& prefixHash)
+{
+  return QDir(directory).filePath(QString("Checkpoint-%1-%2.dream3d").arg(filterCount, 3, 10, QChar('0')).arg(prefixHash));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineCheckpoint::Write(DataContainerArray::Pointer dca, const QString& checkpointFile, QString& errorMessage)
+{
+  QFileInfo fi(checkpointFile);
+  if(!QDir().mkpath(fi.absolutePath()))
+  {
+    errorMessage = QString("The checkpoint directory '%1' could not be created").arg(fi.absolutePath());
+    return false;
+  }
+  // Every writer gets a file of its own, so concurrent writers of the same checkpoint do not clobber each other
+  QTemporaryFile temporaryFile(fi.absoluteDir().filePath(".partial-XXXXXX-" + fi.fileName()));
+  temporaryFile.setAutoRemove(false);
+  if(!temporaryFile.open())
+  {
+    errorMessage = QString("A temporary file for the checkpoint '%1' could not be created").arg(checkpointFile);
+    return false;
+  }
+  QString partialFile = temporaryFile.fileName();
+  temporaryFile.close();
+
+  DataContainerWriter::Pointer writer = CreateWriter(partialFile);
+  writer->setDataContainerArray(dca);
+  writer->execute();
+  int err = writer->getErrorCondition();
+  writer->setDataContainerArray(DataContainerArray::NullPointer());
+  if(err < 0)
+  {
+    QFile::remove(partialFile);
+    errorMessage = QString("The checkpoint '%1' could not be written, error %2").arg(checkpointFile).arg(err);
+    return false;
+  }
+
+  QFile::remove(checkpointFile);
+  if(!QFile::rename(partialFile, checkpointFile))
+  {
+    QFile::remove(partialFile);
+    errorMessage = QString("The checkpoint '%1' could not be renamed into place").arg(checkpointFile);
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer PipelineCheckpoint::Read(const QString& checkpointFile, QString& errorMessage)
+{
+  DataContainerArray::Pointer dca = DataContainerArray::New();
+  DataContainerReader::Pointer reader = CreateReader(checkpointFile);
+  reader->setDataContainerArray(dca);
+  reader->execute();
+  int err = reader->getErrorCondition();
+  reader->setDataContainerArray(DataContainerArray::NullPointer());
+  if(err < 0)
+  {
+    errorMessage = QString("The checkpoint '%1' could not be read, error %2").arg(checkpointFile).arg(err);
+    return DataContainerArray::NullPointer();
+  }
+  return dca;
+}
@@ -0,0 +1,180 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The PipelineCheckpointPolicy struct decides after which filters PipelineExecutor writes the
+ * DataContainerArray to a checkpoint file in 'directory': after every 'everyFilters' filters, after the
+ * filters whose indices are in 'afterFilters' and after any filter that took at least 'minimumSeconds'.
+ * With 'resume' the execution starts from the last checkpoint whose upstream filters are unchanged.
+ */
+struct PipelineCheckpointPolicy
+{
+  QString directory;
+  int everyFilters = 0;
+  double minimumSeconds = 0.0;
+  QVector<int> afterFilters;
+  bool resume = false;
+
+  /**
+   * @brief Returns true if a directory is set and checkpoints are written or resumed from
+   * @return
+   */
+  bool isEnabled() const;
+
+  /**
+   * @brief Returns true if a checkpoint should be written after the filter at 'filterIndex'
+   * @param filterIndex
+   * @param seconds How long the filter took
+   * @return
+   */
+  bool wantsCheckpointAfter(int filterIndex, double seconds) const;
+
+  QJsonObject toJson() const;
+  static PipelineCheckpointPolicy FromJson(const QJsonObject& json);
+};
+
+/**
+ * @brief The PipelineCheckpoint class splits a pipeline at a filter index so that the filters before the split
+ * can be executed once and their DataContainerArray handed to many executions of the filters after it. The
+ * hand over goes through a .dream3d checkpoint file, so the executions may happen in other processes.
+ *
+ * The same files serve PipelineCheckpointPolicy. Such a checkpoint is named after the number of filters it
+ * contains and the PrefixHashes() value of those filters, so a checkpoint is only found again while none of
+ * the filters before it changed.
+ */
+class PipelineCheckpoint
+{
+public:
+  virtual ~PipelineCheckpoint();
+
+  /**
+   * @brief How PrefixHashes() identifies the input files of filters. FileMetadata uses the path, size and
+   * modification time and is cheap. FileContent hashes the contents and leaves the paths out, for caches
+   * that are shared between machines.
+   */
+  enum class InputIdentity
+  {
+    FileMetadata,
+    FileContent
+  };
+
+  /**
+   * @brief Keeps the first 'filterCount' filters of the pipeline and appends a DataContainerWriter that
+   * writes their DataContainerArray to 'checkpointFile'
+   * @param pipeline
+   * @param filterCount
+   * @param checkpointFile
+   */
+  static void WriteAfter(FilterPipeline::Pointer pipeline, int filterCount, const QString& checkpointFile);
+
+  /**
+   * @brief Removes the first 'filterCount' filters of the pipeline and prepends a DataContainerReader that
+   * reads everything in 'checkpointFile'. Overrides must be applied before this because it changes the
+   * filter indices.
+   * @param pipeline
+   * @param filterCount
+   * @param checkpointFile
+   */
+  static void StartFrom(FilterPipeline::Pointer pipeline, int filterCount, const QString& checkpointFile);
+
+  /**
+   * @brief Returns a hash for every prefix of the pipeline. Element n identifies the class names, enabled
+   * states and parameters of the first n filters, their input files and the SIMPLib version, so it has one
+   * element more than the pipeline has filters. The element is empty if one of those filters may read files
+   * that can not be identified; such prefixes must never be stored or looked up.
+   * @param pipeline
+   * @param identity
+   * @return
+   */
+  static QStringList PrefixHashes(FilterPipeline::Pointer pipeline, InputIdentity identity = InputIdentity::FileMetadata);
+
+  /**
+   * @brief Returns the SHA-1 of a file, or of the relative names and contents of all files in a directory.
+   * The hashes of files are remembered by path, size and modification time for the life of the process. The
+   * hash of a directory is built from the hashes of the files it contains on every call. Returns an empty
+   * array if the path, or a file in the directory, can not be read.
+   * @param path
+   * @return
+   */
+  static QByteArray ContentHash(const QString& path);
+
+  /**
+   * @brief Returns the path of the checkpoint that holds the DataContainerArray after the first 'filterCount'
+   * filters
+   * @param directory
+   * @param filterCount
+   * @param prefixHash
+   * @return
+   */
+  static QString CheckpointFile(const QString& directory, int filterCount, const QString& prefixHash);
+
+  /**
+   * @brief Writes a DataContainerArray to a checkpoint file. The file is written under a unique temporary name
+   * in the same directory and only appears under its name once it is complete, so an interrupted write never
+   * leaves a checkpoint that looks valid and concurrent writers do not clobber each other.
+   * @param dca
+   * @param checkpointFile
+   * @param errorMessage
+   * @return
+   */
+  static bool Write(DataContainerArray::Pointer dca, const QString& checkpointFile, QString& errorMessage);
+
+  /**
+   * @brief Reads everything in a checkpoint file
+   * @param checkpointFile
+   * @param errorMessage
+   * @return A null pointer if the file could not be read
+   */
+  static DataContainerArray::Pointer Read(const QString& checkpointFile, QString& errorMessage);
+
+protected:
+  PipelineCheckpoint();
+
+public:
+  PipelineCheckpoint(const PipelineCheckpoint&) = delete;            // Copy Constructor Not Implemented
+  PipelineCheckpoint(PipelineCheckpoint&&) = delete;                 // Move Constructor Not Implemented
+  PipelineCheckpoint& operator=(const PipelineCheckpoint&) = delete; // Copy Assignment Not Implemented
+  PipelineCheckpoint& operator=(PipelineCheckpoint&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,558 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineExecutor.h"
+
+#include <iostream>
+#include <memory>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMap>
+
+#include "SIMPLib/FilterParameters/H5FilterParametersReader.h"
+#include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
+
+#include "Common/BufferPool.h"
+#include "Common/PipelineLiveness.h"
+#include "Common/PipelineScheduler.h"
+#include "Common/ThreadBudget.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineExecutor::PipelineExecutor(QObject* parent)
+: QObject(parent)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineExecutor::~PipelineExecutor() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer PipelineExecutor::ReadPipelineFromFile(const QString& filePath, QString& errorMessage)
+{
+  QFileInfo fi(filePath);
+  if(!fi.exists())
+  {
+    errorMessage = QString("The pipeline file '%1' does not exist").arg(filePath);
+    return FilterPipeline::NullPointer();
+  }
+
+  FilterPipeline::Pointer pipeline;
+  QString ext = fi.suffix();
+  if(ext == "dream3d")
+  {
+    H5FilterParametersReader::Pointer dream3dReader = H5FilterParametersReader::New();
+    pipeline = dream3dReader->readPipelineFromFile(filePath);
+  }
+  else if(ext == "json")
+  {
+    JsonFilterParametersReader::Pointer jsonReader = JsonFilterParametersReader::New();
+    pipeline = jsonReader->readPipelineFromFile(filePath);
+  }
+  else
+  {
+    errorMessage = QString("Unsupported pipeline file extension '%1'. Only .json and .dream3d files can be read").arg(ext);
+    return FilterPipeline::NullPointer();
+  }
+
+  if(nullptr == pipeline.get())
+  {
+    errorMessage = QString("A pipeline could not be read from '%1'").arg(filePath);
+  }
+  return pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineExecutor::ApplyOverrides(FilterPipeline::Pointer pipeline, const QJsonObject& overrides, QString& errorMessage)
+{
+  FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+
+  // Group the overrides by filter so each filter reads its parameters only once
+  QMap<int, QJsonObject> filterOverrides;
+  for(QJsonObject::const_iterator iter = overrides.constBegin(); iter != overrides.constEnd(); ++iter)
+  {
+    QString key = iter.key();
+    int sep = key.indexOf(':');
+    bool ok = false;
+    int index = key.left(sep).toInt(&ok);
+    if(sep < 0 || !ok || key.mid(sep + 1).isEmpty())
+    {
+      errorMessage = QString("The override '%1' must have the form <filter index>:<parameter name>").arg(key);
+      return false;
+    }
+    if(index < 0 || index >= filters.size())
+    {
+      errorMessage = QString("The override '%1' refers to filter %2 but the pipeline has %3 filters").arg(key).arg(index).arg(filters.size());
+      return false;
+    }
+    filterOverrides[index].insert(key.mid(sep + 1), iter.value());
+  }
+
+  for(QMap<int, QJsonObject>::const_iterator iter = filterOverrides.constBegin(); iter != filterOverrides.constEnd(); ++iter)
+  {
+    AbstractFilter::Pointer filter = filters[iter.key()];
+    QJsonObject parameters;
+    filter->writeFilterParameters(parameters);
+    const QJsonObject& values = iter.value();
+    for(QJsonObject::const_iterator value = values.constBegin(); value != values.constEnd(); ++value)
+    {
+      if(!parameters.contains(value.key()))
+      {
+        errorMessage = QString("Filter %1 (%2) has no parameter named '%3'").arg(iter.key()).arg(filter->getHumanLabel()).arg(value.key());
+        return false;
+      }
+      QJsonValue newValue = value.value();
+      QJsonValue::Type storedType = parameters[value.key()].type();
+      if(newValue.isString() && storedType != QJsonValue::String && storedType != QJsonValue::Null)
+      {
+        // Values from a CSV manifest arrive as text, so parse them the way the pipeline file stores the parameter
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson("[" + newValue.toString().toUtf8() + "]", &parseError);
+        if(parseError.error != QJsonParseError::NoError || doc.array().size() != 1)
+        {
+          errorMessage = QString("The value '%1' of filter %2 (%3) parameter '%4' is not valid JSON")
+                             .arg(newValue.toString())
+                             .arg(iter.key())
+                             .arg(filter->getHumanLabel())
+                             .arg(value.key());
+          return false;
+        }
+        newValue = doc.array().first();
+      }
+      parameters[value.key()] = newValue;
+    }
+    filter->readFilterParameters(parameters);
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineExecutor::execute(FilterPipeline::Pointer pipeline)
+{
+  m_FilterCount = pipeline->getFilterContainer().size();
+  m_DataContainerArray.reset();
+  pipeline->addMessageReceiver(this);
+
+  int err = pipeline->preflightPipeline();
+  if(err < 0)
+  {
+    std::cout << "Errors preflighting the pipeline." << std::endl;
+    pipeline->removeMessageReceiver(this);
+    return err;
+  }
+
+  // Arrays that are created through BufferPool::CreateArray() during the run recycle their storage
+  std::unique_ptr<BufferPool> bufferPool;
+  std::unique_ptr<BufferPool::Scope> bufferPoolScope;
+  if(m_BufferPoolBytes > 0)
+  {
+    bufferPool.reset(new BufferPool(m_BufferPoolBytes));
+    bufferPoolScope.reset(new BufferPool::Scope(bufferPool.get()));
+  }
+
+  // The parallel algorithms of the filters only use the threads of the budget
+  ThreadBudget budget(m_MaxThreads);
+  if(m_ReleaseDeadArrays || m_CheckpointPolicy.isEnabled() || (nullptr != m_SnapshotCache && m_SnapshotCache->isEnabled()) || (nullptr != m_ResultCache && m_ResultCache->isEnabled()))
+  {
+    budget.execute([&] { err = executeFilterByFilter(pipeline); });
+  }
+  else if(m_MaxConcurrentFilters > 1)
+  {
+    PipelineScheduler scheduler(qMin(m_MaxConcurrentFilters, budget.getThreads()));
+    scheduler.setThreadBudget(&budget);
+    connect(&scheduler, &PipelineScheduler::pipelineMessage, this, &PipelineExecutor::processPipelineMessage);
+    m_DataContainerArray = DataContainerArray::New();
+    err = scheduler.execute(pipeline->getFilterContainer(), 0, m_DataContainerArray);
+  }
+  else
+  {
+    budget.execute([&] { m_DataContainerArray = pipeline->execute(); });
+    err = pipeline->getErrorCondition();
+  }
+
+  if(nullptr != bufferPool.get())
+  {
+    bufferPoolScope.reset();
+    PipelineMessage pm;
+    pm.setType(PipelineMessage::MessageType::StandardOutputMessage);
+    pm.setText(BufferPool::Summary(bufferPool->statistics()));
+    processPipelineMessage(pm);
+  }
+  pipeline->removeMessageReceiver(this);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setCheckpointPolicy(const PipelineCheckpointPolicy& policy)
+{
+  m_CheckpointPolicy = policy;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setSnapshotCache(PipelineSnapshotCache* cache)
+{
+  m_SnapshotCache = cache;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setResultCache(PipelineResultCache* cache)
+{
+  m_ResultCache = cache;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setMaxConcurrentFilters(int count)
+{
+  m_MaxConcurrentFilters = qMax(1, count);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setMaxThreads(int threads)
+{
+  m_MaxThreads = qMax(0, threads);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setBufferPoolSize(qint64 bytes)
+{
+  m_BufferPoolBytes = qMax(Q_INT64_C(0), bytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::setReleaseDeadArrays(bool enabled, const QString& spillDirectory, bool keepResults)
+{
+  m_ReleaseDeadArrays = enabled;
+  m_SpillDirectory = spillDirectory;
+  m_KeepResults = keepResults;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineExecutor::executeFilterByFilter(FilterPipeline::Pointer pipeline)
+{
+  FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+  QStringList hashes = PipelineCheckpoint::PrefixHashes(pipeline);
+  DataContainerArray::Pointer dca;
+  QString lastCheckpoint;
+  int first = 0;
+
+  bool useSnapshots = nullptr != m_SnapshotCache && m_SnapshotCache->isEnabled();
+  bool useResultCache = nullptr != m_ResultCache && m_ResultCache->isEnabled();
+  QStringList contentHashes;
+  bool resultCacheHit = false;
+  if(useResultCache)
+  {
+    contentHashes = PipelineCheckpoint::PrefixHashes(pipeline, PipelineCheckpoint::InputIdentity::FileContent);
+  }
+
+  // Snapshots, checkpoints and cached results stand for the complete DataContainerArray after a filter
+  std::unique_ptr<PipelineLiveness> liveness;
+  if(m_ReleaseDeadArrays && !useSnapshots && !useResultCache && !m_CheckpointPolicy.isEnabled())
+  {
+    liveness.reset(new PipelineLiveness(m_SpillDirectory));
+    liveness->plan(filters, m_KeepResults);
+  }
+
+  if(m_CheckpointPolicy.resume || useSnapshots || useResultCache)
+  {
+    // The best start is the one that saves the most filters; nothing is kept after the last filter
+    for(int count = filters.size() - 1; count > 0 && nullptr == dca.get(); count--)
+    {
+      if(useSnapshots && m_SnapshotCache->contains(hashes[count]))
+      {
+        dca = m_SnapshotCache->restore(hashes[count]);
+        if(nullptr != dca.get())
+        {
+          first = count;
+          notifyPipelineMessage(PipelineMessage::MessageType::StatusMessage, filters[count - 1], 0, "Resuming after this filter from a snapshot of its results");
+          break;
+        }
+      }
+
+      if(useResultCache && m_ResultCache->contains(contentHashes[count]))
+      {
+        dca = m_ResultCache->fetch(contentHashes[count]);
+        if(nullptr != dca.get())
+        {
+          first = count;
+          resultCacheHit = true;
+          notifyPipelineMessage(PipelineMessage::MessageType::StatusMessage, filters[count - 1], 0, "Resuming after this filter from the shared result cache");
+          break;
+        }
+      }
+
+      if(hashes[count].isEmpty())
+      {
+        continue;
+      }
+      QString checkpointFile = PipelineCheckpoint::CheckpointFile(m_CheckpointPolicy.directory, count, hashes[count]);
+      if(!m_CheckpointPolicy.resume || !QFile::exists(checkpointFile))
+      {
+        continue;
+      }
+      QString errorMessage;
+      dca = PipelineCheckpoint::Read(checkpointFile, errorMessage);
+      if(nullptr == dca.get())
+      {
+        notifyPipelineMessage(PipelineMessage::MessageType::Warning, filters[count - 1], 0, errorMessage);
+        continue;
+      }
+      first = count;
+      lastCheckpoint = checkpointFile;
+      notifyPipelineMessage(PipelineMessage::MessageType::StatusMessage, filters[count - 1], 0, QString("Resuming after this filter from %1").arg(checkpointFile));
+    }
+  }
+  if(useResultCache && !resultCacheHit)
+  {
+    m_ResultCache->countMiss();
+  }
+  if(nullptr == dca.get())
+  {
+    dca = DataContainerArray::New();
+  }
+  m_DataContainerArray = dca;
+
+  bool unidentifiedInputsReported = false;
+  for(int i = first; i < filters.size(); i++)
+  {
+    AbstractFilter::Pointer filter = filters[i];
+    if(!filter->getEnabled())
+    {
+      continue;
+    }
+    notifyPipelineMessage(PipelineMessage::MessageType::ProgressValue, filter, static_cast<int>((i + 1) * 100.0 / (filters.size() + 1)), QString());
+
+    if(nullptr != liveness.get())
+    {
+      QString errorMessage;
+      if(!liveness->restoreBefore(i, dca, errorMessage))
+      {
+        notifyPipelineMessage(PipelineMessage::MessageType::Error, filter, 0, errorMessage);
+        return -1;
+      }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    connect(filter.get(), &AbstractFilter::filterGeneratedMessage, this, &PipelineExecutor::processPipelineMessage);
+    filter->setDataContainerArray(dca);
+    filter->execute();
+    filter->setDataContainerArray(DataContainerArray::NullPointer());
+    disconnect(filter.get(), &AbstractFilter::filterGeneratedMessage, this, &PipelineExecutor::processPipelineMessage);
+    int err = filter->getErrorCondition();
+    if(err < 0)
+    {
+      if(useResultCache)
+      {
+        m_ResultCache->flushStatistics();
+      }
+      return err;
+    }
+
+    if(nullptr != liveness.get())
+    {
+      qint64 bytes = 0;
+      QString warning;
+      int released = liveness->releaseAfter(i, dca, bytes, warning);
+      if(!warning.isEmpty())
+      {
+        // A failed spill only keeps the arrays in memory
+        notifyPipelineMessage(PipelineMessage::MessageType::Warning, filter, 0, warning);
+      }
+      if(released > 0)
+      {
+        notifyPipelineMessage(PipelineMessage::MessageType::StatusMessage, filter, 0,
+                              QString("Released %1 arrays (%2 MB) that the next filters do not read").arg(released).arg(bytes / (1024.0 * 1024.0), 0, 'f', 1));
+      }
+    }
+
+    if(useSnapshots && i + 1 < filters.size() && m_SnapshotCache->wantsSnapshotAfter(timer.elapsed() / 1000.0))
+    {
+      m_SnapshotCache->store(hashes[i + 1], dca);
+    }
+    if(useResultCache && i + 1 < filters.size() && m_ResultCache->wantsResultAfter(timer.elapsed() / 1000.0) && !m_ResultCache->contains(contentHashes[i + 1]))
+    {
+      if(m_ResultCache->store(contentHashes[i + 1], dca))
+      {
+        notifyPipelineMessage(PipelineMessage::MessageType::StatusMessage, filter, 0, "Stored the results of this filter in the shared result cache");
+      }
+    }
+
+    if(i + 1 < filters.size() && m_CheckpointPolicy.isEnabled() && m_CheckpointPolicy.wantsCheckpointAfter(i, timer.elapsed() / 1000.0))
+    {
+      if(hashes[i + 1].isEmpty())
+      {
+        // A checkpoint could be resumed after the unidentified input files changed
+        if(!unidentifiedInputsReported)
+        {
+          notifyPipelineMessage(PipelineMessage::MessageType::Warning, filter, 0, "No checkpoints are written from here on because the input files of a filter can not be identified");
+          unidentifiedInputsReported = true;
+        }
+        continue;
+      }
+      QString checkpointFile = PipelineCheckpoint::CheckpointFile(m_CheckpointPolicy.directory, i + 1, hashes[i + 1]);
+      QString errorMessage;
+      if(!PipelineCheckpoint::Write(dca, checkpointFile, errorMessage))
+      {
+        // A missing checkpoint only costs time on a later resume, so the pipeline goes on
+        notifyPipelineMessage(PipelineMessage::MessageType::Warning, filter, 0, errorMessage);
+        continue;
+      }
+      // Only the newest checkpoint of this execution is needed to resume it
+      if(!lastCheckpoint.isEmpty())
+      {
+        QFile::remove(lastCheckpoint);
+      }
+      lastCheckpoint = checkpointFile;
+      notifyPipelineMessage(PipelineMessage::MessageType::StatusMessage, filter, 0, QString("Wrote checkpoint %1").arg(checkpointFile));
+    }
+  }
+  if(nullptr != liveness.get())
+  {
+    QString errorMessage;
+    if(!liveness->restoreBefore(filters.size(), dca, errorMessage))
+    {
+      notifyPipelineMessage(PipelineMessage::MessageType::Error, filters.last(), 0, errorMessage);
+      return -1;
+    }
+  }
+  if(useResultCache)
+  {
+    m_ResultCache->flushStatistics();
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::notifyPipelineMessage(PipelineMessage::MessageType type, AbstractFilter::Pointer filter, int progress, const QString& text)
+{
+  PipelineMessage pm;
+  pm.setType(type);
+  pm.setPipelineIndex(filter->getPipelineIndex());
+  pm.setFilterHumanLabel(filter->getHumanLabel());
+  pm.setFilterClassName(filter->getNameOfClass());
+  pm.setProgressValue(progress);
+  pm.setText(text);
+  processPipelineMessage(pm);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer PipelineExecutor::getDataContainerArray() const
+{
+  return m_DataContainerArray;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::clearDataContainerArray()
+{
+  m_DataContainerArray.reset();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineExecutor::messagePrefix(const PipelineMessage& pm) const
+{
+  int width = QString::number(m_FilterCount).size();
+  return QString("[%1/%2] %3").arg(pm.getPipelineIndex() + 1, width).arg(m_FilterCount).arg(pm.getFilterHumanLabel());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineExecutor::processPipelineMessage(const PipelineMessage& pm)
+{
+  QString line;
+  switch(pm.getType())
+  {
+  case PipelineMessage::MessageType::Error:
+    line = QString("%1: ERROR %2: %3").arg(messagePrefix(pm)).arg(pm.getCode()).arg(pm.getText());
+    break;
+  case PipelineMessage::MessageType::Warning:
+    line = QString("%1: WARNING %2: %3").arg(messagePrefix(pm)).arg(pm.getCode()).arg(pm.getText());
+    break;
+  case PipelineMessage::MessageType::ProgressValue:
+    line = QString("%1: %2%").arg(messagePrefix(pm)).arg(pm.getProgressValue());
+    break;
+  case PipelineMessage::MessageType::StatusMessageAndProgressValue:
+    line = QString("%1: %2% %3").arg(messagePrefix(pm)).arg(pm.getProgressValue()).arg(pm.getText());
+    break;
+  case PipelineMessage::MessageType::StatusMessage:
+    line = QString("%1: %2").arg(messagePrefix(pm)).arg(pm.getText());
+    break;
+  case PipelineMessage::MessageType::StandardOutputMessage:
+    line = pm.getText();
+    break;
+  default:
+    return;
+  }
+
+  // Flush every line so that progress shows up immediately when stdout is a pipe or a log file
+  std::cout << line.toStdString() << std::endl;
+}
@@ -0,0 +1,209 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "SIMPLib/Common/PipelineMessage.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "Common/PipelineCheckpoint.h"
+#include "Common/PipelineResultCache.h"
+#include "Common/PipelineSnapshotCache.h"
+
+/**
+ * @brief The PipelineExecutor class reads a pipeline file, preflights it and executes it without any user
+ * interface. The messages of the executing pipeline are written to stdout as lines of the form
+ * "[ 3/12] Filter Label: message". Subclasses can report them differently by overriding
+ * processPipelineMessage().
+ */
+class PipelineExecutor : public QObject
+{
+  Q_OBJECT
+
+public:
+  PipelineExecutor(QObject* parent = nullptr);
+  ~PipelineExecutor() override;
+
+  /**
+   * @brief Reads a .json or .dream3d pipeline file
+   * @param filePath
+   * @param errorMessage Receives the reason if the pipeline could not be read
+   * @return The pipeline or a null pointer
+   */
+  static FilterPipeline::Pointer ReadPipelineFromFile(const QString& filePath, QString& errorMessage);
+
+  /**
+   * @brief Changes filter parameters of a pipeline before it is executed. Each key of 'overrides' has the form
+   * "<filter index>:<parameter name>", for example "0:InputFile", and its value is the new value in the same
+   * JSON form that a .json pipeline file uses for that parameter. The values go through the filter's own
+   * readFilterParameters() so any parameter type that can be stored in a pipeline file can be overridden.
+   * A string value for a parameter that the filter does not store as a string is parsed as JSON first, so
+   * "2.5" or "{\"x\": 1, \"y\": 2, \"z\": 3}" can be given as text.
+   * @param pipeline
+   * @param overrides
+   * @param errorMessage Receives the reason if an override could not be applied
+   * @return
+   */
+  static bool ApplyOverrides(FilterPipeline::Pointer pipeline, const QJsonObject& overrides, QString& errorMessage);
+
+  /**
+   * @brief Preflights and then executes the pipeline
+   * @param pipeline
+   * @return 0 on success, otherwise the preflight or execute error condition of the pipeline
+   */
+  int execute(FilterPipeline::Pointer pipeline);
+
+  /**
+   * @brief Sets where and when execute() writes checkpoints and whether it resumes from them. With an
+   * enabled policy, snapshot cache or result cache the filters are executed one by one by this class instead of by the
+   * pipeline.
+   * @param policy
+   */
+  void setCheckpointPolicy(const PipelineCheckpointPolicy& policy);
+
+  /**
+   * @brief Sets a cache that execute() stores a snapshot in after every filter and restarts from when the
+   * same upstream filters are executed again. The cache is not owned and must outlive the executions.
+   * @param cache
+   */
+  void setSnapshotCache(PipelineSnapshotCache* cache);
+
+  /**
+   * @brief Sets a shared cache that execute() looks up the longest cached prefix of the pipeline in and
+   * stores the results of expensive filters in. The cache is not owned and must outlive the executions.
+   * @param cache
+   */
+  void setResultCache(PipelineResultCache* cache);
+
+  /**
+   * @brief Sets how many filters execute() may run at the same time. With more than one, filters that work
+   * on different data containers are executed concurrently by a PipelineScheduler, unless checkpoints or
+   * caches are enabled.
+   * @param count
+   */
+  void setMaxConcurrentFilters(int count);
+
+  /**
+   * @brief Sets how many threads the parallel algorithms of the filters may use during execute(), see
+   * ThreadBudget. 0 uses ThreadBudget::DefaultThreads().
+   * @param threads
+   */
+  void setMaxThreads(int threads);
+
+  /**
+   * @brief Sets how much freed array storage execute() keeps for reuse by later filters, see BufferPool.
+   * 0 turns the pool off. The statistics of the pool are reported as a message at the end of the run.
+   * @param bytes
+   */
+  void setBufferPoolSize(qint64 bytes);
+
+  /**
+   * @brief Sets whether execute() removes arrays from the DataContainerArray once no later filter reads them,
+   * see PipelineLiveness. The filters are then executed one after another, and not at all while checkpoints
+   * or caches are enabled because those keep the complete DataContainerArray.
+   * @param enabled
+   * @param spillDirectory Where arrays that a later filter only writes to a file wait for it, or an empty
+   * string to keep them in memory
+   * @param keepResults True if getDataContainerArray() must return every array that the pipeline leaves
+   */
+  void setReleaseDeadArrays(bool enabled, const QString& spillDirectory = QString(), bool keepResults = false);
+
+  /**
+   * @brief Returns the DataContainerArray that the last execution produced
+   * @return
+   */
+  DataContainerArray::Pointer getDataContainerArray() const;
+
+  /**
+   * @brief Releases the DataContainerArray of the last execution
+   */
+  void clearDataContainerArray();
+
+public slots:
+  /**
+   * @brief Receives the messages of the executing pipeline
+   * @param pm
+   */
+  virtual void processPipelineMessage(const PipelineMessage& pm);
+
+protected:
+  /**
+   * @brief Returns the "[ 3/12] Filter Label" prefix for a message
+   * @param pm
+   * @return
+   */
+  QString messagePrefix(const PipelineMessage& pm) const;
+
+  /**
+   * @brief Executes the preflighted pipeline one filter after another, starting from the best snapshot or
+   * checkpoint and writing new ones as the policy and the cache ask for, or releasing dead arrays
+   * @param pipeline
+   * @return
+   */
+  int executeFilterByFilter(FilterPipeline::Pointer pipeline);
+
+  /**
+   * @brief Sends a message of the executor itself to processPipelineMessage()
+   * @param type
+   * @param filter The filter the message is about
+   * @param progress
+   * @param text
+   */
+  void notifyPipelineMessage(PipelineMessage::MessageType type, AbstractFilter::Pointer filter, int progress, const QString& text);
+
+private:
+  int m_FilterCount = 0;
+  DataContainerArray::Pointer m_DataContainerArray;
+  PipelineCheckpointPolicy m_CheckpointPolicy;
+  PipelineSnapshotCache* m_SnapshotCache = nullptr;
+  PipelineResultCache* m_ResultCache = nullptr;
+  int m_MaxConcurrentFilters = 1;
+  int m_MaxThreads = 0;
+  qint64 m_BufferPoolBytes = 0;
+  bool m_ReleaseDeadArrays = false;
+  QString m_SpillDirectory;
+  bool m_KeepResults = false;
+
+public:
+  PipelineExecutor(const PipelineExecutor&) = delete;            // Copy Constructor Not Implemented
+  PipelineExecutor(PipelineExecutor&&) = delete;                 // Move Constructor Not Implemented
+  PipelineExecutor& operator=(const PipelineExecutor&) = delete; // Copy Assignment Not Implemented
+  PipelineExecutor& operator=(PipelineExecutor&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,387 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineLiveness.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSet>
+#include <QtCore/QTemporaryDir>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "Common/FilterDataUsage.h"
+#include "Common/PipelineCheckpoint.h"
+
+namespace
+{
+struct Entry
+{
+  DataArrayPath path;
+  QByteArray signature;
+};
+
+/**
+ * @brief A signature per data container, attribute matrix and array, keyed by their serialized paths
+ */
+using Structure = QMap<QString, Entry>;
+
+struct Use
+{
+  int index;
+  bool writer;
+};
+
+// -----------------------------------------------------------------------------
+// Returns the signatures of everything in a preflight structure. A signature changes whenever the geometry
+// type of a data container, the type or tuple count of an attribute matrix or the type of an array changes.
+// -----------------------------------------------------------------------------
+Structure Describe(DataContainerArray::Pointer dca)
+{
+  Structure structure;
+  if(nullptr == dca.get())
+  {
+    return structure;
+  }
+  for(DataContainer::Pointer dc : dca->getDataContainers())
+  {
+    IGeometry::Pointer geometry = dc->getGeometry();
+    DataArrayPath dcPath(dc->getName(), QString(), QString());
+    structure.insert(dcPath.serialize(), {dcPath, nullptr != geometry.get() ? geometry->getGeometryTypeAsString().toUtf8() : QByteArray("None")});
+    for(AttributeMatrix::Pointer am : dc->getAttributeMatrices())
+    {
+      DataArrayPath amPath(dc->getName(), am->getName(), QString());
+      structure.insert(amPath.serialize(), {amPath, QByteArray::number(static_cast<int>(am->getType())) + ":" + QByteArray::number(static_cast<qulonglong>(am->getNumberOfTuples()))});
+      for(const QString& arrayName : am->getAttributeArrayNames())
+      {
+        IDataArray::Pointer array = am->getAttributeArray(arrayName);
+        DataArrayPath arrayPath(dc->getName(), am->getName(), arrayName);
+        structure.insert(arrayPath.serialize(), {arrayPath, array->getTypeAsString().toUtf8() + ":" + QByteArray::number(array->getNumberOfComponents())});
+      }
+    }
+  }
+  return structure;
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if 'path' is 'array', its attribute matrix or its data container
+// -----------------------------------------------------------------------------
+bool Covers(const DataArrayPath& path, const DataArrayPath& array)
+{
+  if(path.getDataContainerName() != array.getDataContainerName())
+  {
+    return false;
+  }
+  if(path.getAttributeMatrixName().isEmpty())
+  {
+    return true;
+  }
+  if(path.getAttributeMatrixName() != array.getAttributeMatrixName())
+  {
+    return false;
+  }
+  return path.getDataArrayName().isEmpty() || path.getDataArrayName() == array.getDataArrayName();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AttributeMatrix::Pointer FindAttributeMatrix(DataContainerArray::Pointer dca, const DataArrayPath& path)
+{
+  DataContainer::Pointer dc = dca->getDataContainer(path.getDataContainerName());
+  if(nullptr == dc.get())
+  {
+    return AttributeMatrix::NullPointer();
+  }
+  return dc->getAttributeMatrix(path.getAttributeMatrixName());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 ArrayBytes(AttributeMatrix::Pointer am, IDataArray::Pointer array)
+{
+  return static_cast<qint64>(am->getNumberOfTuples()) * array->getNumberOfComponents() * array->getTypeSize();
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineLiveness::PipelineLiveness(const QString& spillDirectory)
+{
+  if(!spillDirectory.isEmpty() && QDir().mkpath(spillDirectory))
+  {
+    // Every execution spills into a directory of its own that goes away with it
+    m_SpillDirectory.reset(new QTemporaryDir(QDir(spillDirectory).filePath("PipelineSpill-XXXXXX")));
+    if(!m_SpillDirectory->isValid())
+    {
+      m_SpillDirectory.reset();
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineLiveness::~PipelineLiveness() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<PipelineLiveness::Step> PipelineLiveness::Plan(const FilterPipeline::FilterContainerType& filters, bool spill, bool keepResults)
+{
+  QVector<Step> steps(filters.size() + 1);
+  QMap<QString, DataArrayPath> arrays;
+  QMap<QString, QVector<Use>> uses;
+  QMap<int, int> positions;
+  Structure before;
+  DataContainerArray* previousStructure = nullptr;
+  int lastFilter = -1;
+  for(int i = 0; i < filters.size(); i++)
+  {
+    AbstractFilter::Pointer filter = filters[i];
+    if(!filter->getEnabled())
+    {
+      continue;
+    }
+    positions.insert(i, positions.size());
+    lastFilter = i;
+
+    // The preflight left the data structure after this filter in it
+    DataContainerArray::Pointer structure = filter->getDataContainerArray();
+    Structure after = Describe(structure);
+    FilterDataUsage usage = FilterDataUsage::Scan(filter);
+    bool barrier = usage.unknown || nullptr == structure.get() || structure.get() == previousStructure;
+
+    QVector<DataArrayPath> touched = usage.paths;
+    QSet<QString> keys = QSet<QString>::fromList(before.keys()) + QSet<QString>::fromList(after.keys());
+    for(const QString& key : keys)
+    {
+      if(!before.contains(key) || !after.contains(key) || before[key].signature != after[key].signature)
+      {
+        touched.push_back(before.contains(key) ? before[key].path : after[key].path);
+      }
+    }
+    bool writer = !barrier && usage.fileAccess && touched.isEmpty();
+
+    Structure candidates = before;
+    candidates.unite(after);
+    for(Structure::const_iterator iter = candidates.constBegin(); iter != candidates.constEnd(); ++iter)
+    {
+      const DataArrayPath& path = iter.value().path;
+      if(path.getDataArrayName().isEmpty() || (writer && !before.contains(iter.key())))
+      {
+        continue;
+      }
+      bool used = barrier || writer;
+      for(int t = 0; t < touched.size() && !used; t++)
+      {
+        used = Covers(touched[t], path);
+      }
+      if(used)
+      {
+        arrays.insert(iter.key(), path);
+        uses[iter.key()].push_back({i, writer});
+      }
+    }
+
+    before = after;
+    previousStructure = structure.get();
+  }
+
+  positions.insert(filters.size(), positions.size());
+  if(keepResults)
+  {
+    for(Structure::const_iterator iter = before.constBegin(); iter != before.constEnd(); ++iter)
+    {
+      if(!iter.value().path.getDataArrayName().isEmpty())
+      {
+        arrays.insert(iter.key(), iter.value().path);
+        uses[iter.key()].push_back({filters.size(), true});
+      }
+    }
+  }
+
+  for(QMap<QString, QVector<Use>>::const_iterator iter = uses.constBegin(); iter != uses.constEnd(); ++iter)
+  {
+    const DataArrayPath& path = arrays[iter.key()];
+    const QVector<Use>& arrayUses = iter.value();
+    for(int u = 0; spill && u + 1 < arrayUses.size(); u++)
+    {
+      // Only worth it if at least one filter runs while the array is on disk
+      if(arrayUses[u + 1].writer && positions[arrayUses[u + 1].index] - positions[arrayUses[u].index] > 1)
+      {
+        steps[arrayUses[u].index].spillAfter.push_back(path);
+        steps[arrayUses[u + 1].index].restoreBefore.push_back(path);
+      }
+    }
+    if(arrayUses.last().index < lastFilter)
+    {
+      steps[arrayUses.last().index].releaseAfter.push_back(path);
+    }
+  }
+  return steps;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineLiveness::plan(const FilterPipeline::FilterContainerType& filters, bool keepResults)
+{
+  m_Steps = Plan(filters, nullptr != m_SpillDirectory.get(), keepResults);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineLiveness::restoreBefore(int filterIndex, DataContainerArray::Pointer dca, QString& errorMessage)
+{
+  if(filterIndex < 0 || filterIndex >= m_Steps.size())
+  {
+    return true;
+  }
+
+  // Arrays that could not be spilled never left memory
+  QMap<QString, QVector<DataArrayPath>> files;
+  for(const DataArrayPath& path : m_Steps[filterIndex].restoreBefore)
+  {
+    if(m_SpillFiles.contains(path.serialize()))
+    {
+      files[m_SpillFiles.take(path.serialize())].push_back(path);
+    }
+  }
+
+  for(QMap<QString, QVector<DataArrayPath>>::const_iterator iter = files.constBegin(); iter != files.constEnd(); ++iter)
+  {
+    DataContainerArray::Pointer spilled = PipelineCheckpoint::Read(iter.key(), errorMessage);
+    if(nullptr == spilled.get())
+    {
+      return false;
+    }
+    for(const DataArrayPath& path : iter.value())
+    {
+      AttributeMatrix::Pointer source = FindAttributeMatrix(spilled, path);
+      IDataArray::Pointer array = nullptr != source.get() ? source->getAttributeArray(path.getDataArrayName()) : IDataArray::NullPointer();
+      AttributeMatrix::Pointer am = FindAttributeMatrix(dca, path);
+      if(nullptr == array.get() || nullptr == am.get() || am->getNumberOfTuples() != array->getNumberOfTuples())
+      {
+        errorMessage = QString("The spilled array '%1' could not be restored from '%2'").arg(path.serialize("/")).arg(iter.key());
+        return false;
+      }
+      am->addAttributeArray(path.getDataArrayName(), array);
+    }
+
+    m_SpilledArrayCounts[iter.key()] -= iter.value().size();
+    if(m_SpilledArrayCounts[iter.key()] <= 0)
+    {
+      m_SpilledArrayCounts.remove(iter.key());
+      QFile::remove(iter.key());
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineLiveness::releaseAfter(int filterIndex, DataContainerArray::Pointer dca, qint64& bytes, QString& warning)
+{
+  bytes = 0;
+  if(filterIndex < 0 || filterIndex >= m_Steps.size())
+  {
+    return 0;
+  }
+  const Step& step = m_Steps[filterIndex];
+  int count = 0;
+
+  if(!step.spillAfter.isEmpty())
+  {
+    // The spilled arrays are moved into a structure of their own, so writing them copies nothing
+    DataContainerArray::Pointer spill = DataContainerArray::New();
+    QVector<DataArrayPath> spilled;
+    for(const DataArrayPath& path : step.spillAfter)
+    {
+      AttributeMatrix::Pointer source = FindAttributeMatrix(dca, path);
+      IDataArray::Pointer array = nullptr != source.get() ? source->getAttributeArray(path.getDataArrayName()) : IDataArray::NullPointer();
+      if(nullptr == array.get())
+      {
+        continue;
+      }
+      DataContainer::Pointer dc = spill->getDataContainer(path.getDataContainerName());
+      if(nullptr == dc.get())
+      {
+        // The geometry goes along so the file reads back like any other .dream3d file
+        dc = DataContainer::New(path.getDataContainerName());
+        dc->setGeometry(dca->getDataContainer(path.getDataContainerName())->getGeometry());
+        spill->addDataContainer(dc);
+      }
+      AttributeMatrix::Pointer am = dc->getAttributeMatrix(path.getAttributeMatrixName());
+      if(nullptr == am.get())
+      {
+        am = AttributeMatrix::New(source->getTupleDimensions(), path.getAttributeMatrixName(), source->getType());
+        dc->addAttributeMatrix(path.getAttributeMatrixName(), am);
+      }
+      am->addAttributeArray(path.getDataArrayName(), array);
+      spilled.push_back(path);
+    }
+
+    QString spillFile = QDir(m_SpillDirectory->path()).filePath(QString("Spill-%1.dream3d").arg(filterIndex, 3, 10, QChar('0')));
+    if(!spilled.isEmpty() && PipelineCheckpoint::Write(spill, spillFile, warning))
+    {
+      for(const DataArrayPath& path : spilled)
+      {
+        AttributeMatrix::Pointer am = FindAttributeMatrix(dca, path);
+        bytes += ArrayBytes(am, am->removeAttributeArray(path.getDataArrayName()));
+        m_SpillFiles.insert(path.serialize(), spillFile);
+        count++;
+      }
+      m_SpilledArrayCounts.insert(spillFile, spilled.size());
+    }
+  }
+
+  for(const DataArrayPath& path : step.releaseAfter)
+  {
+    AttributeMatrix::Pointer am = FindAttributeMatrix(dca, path);
+    if(nullptr == am.get() || nullptr == am->getAttributeArray(path.getDataArrayName()).get())
+    {
+      continue;
+    }
+    bytes += ArrayBytes(am, am->removeAttributeArray(path.getDataArrayName()));
+    count++;
+  }
+  return count;
+}
@@ -0,0 +1,131 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <memory>
+
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+class QTemporaryDir;
+
+/**
+ * @brief The PipelineLiveness class removes the arrays of an executing pipeline from its DataContainerArray
+ * as soon as no later filter needs them. The filters that need an array are found from the preflight: the
+ * filters whose parameters name it, its attribute matrix or its data container, the filters that add, remove
+ * or change any of those, and the filters that write files without naming any data (see FilterDataUsage),
+ * which need every array that exists before them. A filter whose use of data can not be told needs every array.
+ *
+ * With a spill directory an array whose next use is such a file writer is written to a .dream3d file in that
+ * directory after the filter before the gap and read back just before the writer, so arrays that are only kept
+ * to be written at the end do not hold memory in between. With 'keepResults' the end of the pipeline counts as
+ * a writer of the arrays that remain, so the resulting DataContainerArray is complete.
+ */
+class PipelineLiveness
+{
+public:
+  /**
+   * @brief The arrays to act on around one filter
+   */
+  struct Step
+  {
+    QVector<DataArrayPath> restoreBefore;
+    QVector<DataArrayPath> spillAfter;
+    QVector<DataArrayPath> releaseAfter;
+  };
+
+  /**
+   * @brief PipelineLiveness
+   * @param spillDirectory The directory for spilled arrays, or an empty string to only release arrays
+   */
+  explicit PipelineLiveness(const QString& spillDirectory = QString());
+  ~PipelineLiveness();
+
+  /**
+   * @brief Returns the step of every filter of a preflighted pipeline plus one for the end of the pipeline
+   * @param filters
+   * @param spill True if arrays may be spilled until their next writer
+   * @param keepResults True if the arrays that remain after the last filter are needed
+   * @return
+   */
+  static QVector<Step> Plan(const FilterPipeline::FilterContainerType& filters, bool spill, bool keepResults);
+
+  /**
+   * @brief Plans the execution of a preflighted pipeline. Spilling is only planned if the spill directory
+   * could be used.
+   * @param filters
+   * @param keepResults
+   */
+  void plan(const FilterPipeline::FilterContainerType& filters, bool keepResults);
+
+  /**
+   * @brief Reads back the arrays that were spilled until the filter at 'filterIndex'. Use the number of
+   * filters as the index for the end of the pipeline.
+   * @param filterIndex
+   * @param dca
+   * @param errorMessage
+   * @return False if an array could not be read back
+   */
+  bool restoreBefore(int filterIndex, DataContainerArray::Pointer dca, QString& errorMessage);
+
+  /**
+   * @brief Spills and releases the arrays that the filters after 'filterIndex' do not need. Arrays that
+   * could not be spilled stay in memory.
+   * @param filterIndex
+   * @param dca
+   * @param bytes Receives the number of bytes that were removed from memory
+   * @param warning Receives the reason if arrays could not be spilled
+   * @return The number of arrays that were removed from memory
+   */
+  int releaseAfter(int filterIndex, DataContainerArray::Pointer dca, qint64& bytes, QString& warning);
+
+private:
+  std::unique_ptr<QTemporaryDir> m_SpillDirectory;
+  QVector<Step> m_Steps;
+  QMap<QString, QString> m_SpillFiles;
+  QMap<QString, int> m_SpilledArrayCounts;
+
+public:
+  PipelineLiveness(const PipelineLiveness&) = delete;            // Copy Constructor Not Implemented
+  PipelineLiveness(PipelineLiveness&&) = delete;                 // Move Constructor Not Implemented
+  PipelineLiveness& operator=(const PipelineLiveness&) = delete; // Copy Assignment Not Implemented
+  PipelineLiveness& operator=(PipelineLiveness&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,336 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineResultCache.h"
+
+#if defined(_MSC_VER)
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#include <algorithm>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSysInfo>
+#include <QtCore/QVector>
+
+#include "Common/PipelineCheckpoint.h"
+
+namespace
+{
+const QStringList k_Counters = {"hits", "misses", "stores", "evictions"};
+
+// -----------------------------------------------------------------------------
+// Returns all complete entries, least recently used first
+// -----------------------------------------------------------------------------
+QVector<QFileInfo> ListEntries(const QString& directory)
+{
+  QVector<QFileInfo> entries;
+  QDirIterator iter(QDir(directory).filePath("objects"), QStringList() << "*.dream3d", QDir::Files, QDirIterator::Subdirectories);
+  while(iter.hasNext())
+  {
+    iter.next();
+    // Files that are still being written are hidden on Unix but not on Windows
+    if(!iter.fileName().startsWith(".partial-"))
+    {
+      entries.push_back(iter.fileInfo());
+    }
+  }
+  std::sort(entries.begin(), entries.end(), [](const QFileInfo& a, const QFileInfo& b) { return a.lastModified() < b.lastModified(); });
+  return entries;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineResultCache::PipelineResultCache() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineResultCache::~PipelineResultCache()
+{
+  flushStatistics();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineResultCache::configure(const QJsonObject& settings)
+{
+  QString directory = settings["directory"].toString();
+  if(directory != m_Directory)
+  {
+    flushStatistics();
+    m_Directory = directory;
+  }
+  m_MaxBytes = static_cast<qint64>(settings["maxGB"].toDouble() * 1024 * 1024 * 1024);
+  m_MinimumSeconds = settings["minimumSeconds"].toDouble();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineResultCache::isEnabled() const
+{
+  return !m_Directory.isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineResultCache::wantsResultAfter(double seconds) const
+{
+  return isEnabled() && seconds >= m_MinimumSeconds;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineResultCache::entryFile(const QString& key) const
+{
+  // Two levels keep the number of files per directory small, which matters on network file systems
+  return QDir(m_Directory).filePath(QString("objects/%1/%2.dream3d").arg(key.left(2)).arg(key));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineResultCache::contains(const QString& key) const
+{
+  // An empty key stands for results whose inputs could not be content hashed
+  return isEnabled() && !key.isEmpty() && QFile::exists(entryFile(key));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer PipelineResultCache::fetch(const QString& key)
+{
+  QString file = entryFile(key);
+  if(!contains(key))
+  {
+    return DataContainerArray::NullPointer();
+  }
+
+  QString errorMessage;
+  DataContainerArray::Pointer dca = PipelineCheckpoint::Read(file, errorMessage);
+  if(nullptr == dca.get())
+  {
+    return dca;
+  }
+
+  // The modification time is the last use for the eviction
+  QByteArray nativePath = QFile::encodeName(file);
+#if defined(_MSC_VER)
+  _utime(nativePath.constData(), nullptr);
+#else
+  utime(nativePath.constData(), nullptr);
+#endif
+  m_Hits++;
+  return dca;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineResultCache::countMiss()
+{
+  m_Misses++;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineResultCache::store(const QString& key, DataContainerArray::Pointer dca)
+{
+  if(!isEnabled() || key.isEmpty())
+  {
+    return false;
+  }
+  if(contains(key))
+  {
+    return true;
+  }
+
+  // Every writer writes a temporary file of its own and renames it into place. When two hosts store the same
+  // key at once, the rename of one of them can fail because the other just put its entry there; both entries
+  // hold the same results, so that still counts as stored.
+  QString errorMessage;
+  if(!PipelineCheckpoint::Write(dca, entryFile(key), errorMessage))
+  {
+    return contains(key);
+  }
+  m_Stores++;
+  evict();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineResultCache::evict()
+{
+  if(m_MaxBytes <= 0)
+  {
+    return;
+  }
+
+  QVector<QFileInfo> entries = ListEntries(m_Directory);
+  qint64 bytes = 0;
+  for(const QFileInfo& entry : entries)
+  {
+    bytes += entry.size();
+  }
+  for(int i = 0; i < entries.size() && bytes > m_MaxBytes; i++)
+  {
+    // Another host may have removed it already
+    if(QFile::remove(entries[i].absoluteFilePath()))
+    {
+      m_Evictions++;
+    }
+    bytes -= entries[i].size();
+  }
+
+  // Leftovers of writers that died; a day is far longer than any entry takes to write
+  QDirIterator partials(QDir(m_Directory).filePath("objects"), QStringList() << ".partial-*", QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+  QDateTime yesterday = QDateTime::currentDateTime().addDays(-1);
+  while(partials.hasNext())
+  {
+    partials.next();
+    if(partials.fileInfo().lastModified() < yesterday)
+    {
+      QFile::remove(partials.filePath());
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineResultCache::statistics() const
+{
+  QJsonObject stats;
+  stats["hits"] = m_Hits;
+  stats["misses"] = m_Misses;
+  stats["stores"] = m_Stores;
+  stats["evictions"] = m_Evictions;
+  return stats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineResultCache::flushStatistics()
+{
+  QJsonObject current = statistics();
+  if(!isEnabled() || current == m_Flushed)
+  {
+    return;
+  }
+
+  QDir statsDir(QDir(m_Directory).filePath("stats"));
+  if(!statsDir.mkpath("."))
+  {
+    return;
+  }
+
+  // Every host has its own file, so hosts never overwrite each other's counters
+  QString fileName = statsDir.filePath(QSysInfo::machineHostName() + ".json");
+  QJsonObject hostStats;
+  QFile file(fileName);
+  if(file.open(QIODevice::ReadOnly))
+  {
+    hostStats = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+  }
+  for(const QString& counter : k_Counters)
+  {
+    hostStats[counter] = hostStats[counter].toDouble() + current[counter].toDouble() - m_Flushed[counter].toDouble();
+  }
+
+  QSaveFile saveFile(fileName);
+  if(saveFile.open(QIODevice::WriteOnly))
+  {
+    saveFile.write(QJsonDocument(hostStats).toJson());
+    if(saveFile.commit())
+    {
+      m_Flushed = current;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineResultCache::ReadStatistics(const QString& directory)
+{
+  QJsonObject total;
+  QJsonObject hosts;
+  QDir statsDir(QDir(directory).filePath("stats"));
+  for(const QFileInfo& fi : statsDir.entryInfoList(QStringList() << "*.json", QDir::Files))
+  {
+    QFile file(fi.absoluteFilePath());
+    if(!file.open(QIODevice::ReadOnly))
+    {
+      continue;
+    }
+    QJsonObject hostStats = QJsonDocument::fromJson(file.readAll()).object();
+    hosts[fi.completeBaseName()] = hostStats;
+    for(const QString& counter : k_Counters)
+    {
+      total[counter] = total[counter].toDouble() + hostStats[counter].toDouble();
+    }
+  }
+
+  QVector<QFileInfo> entries = ListEntries(directory);
+  qint64 bytes = 0;
+  for(const QFileInfo& entry : entries)
+  {
+    bytes += entry.size();
+  }
+  total["entries"] = entries.size();
+  total["bytes"] = static_cast<double>(bytes);
+  total["hosts"] = hosts;
+  return total;
+}
@@ -0,0 +1,155 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+/**
+ * @brief The PipelineResultCache class is a content addressed cache of DataContainerArrays in a directory
+ * that may be shared by many sessions and machines, for example on NFS. An entry holds the
+ * DataContainerArray after a prefix of a pipeline and is keyed by the PipelineCheckpoint::PrefixHashes()
+ * value of that prefix computed with InputIdentity::FileContent, so pipelines that start with the same
+ * filters on the same data find each other's results no matter where the data is stored.
+ *
+ * Entries are .dream3d files that appear under their name only once they are complete, so readers never
+ * see partial entries and no locking is needed. The modification time of an entry is its last use; the
+ * least recently used entries are removed when the directory grows beyond its size cap. Hit and miss
+ * counters are kept per host in the "stats" subdirectory.
+ */
+class PipelineResultCache
+{
+public:
+  PipelineResultCache();
+  virtual ~PipelineResultCache();
+
+  /**
+   * @brief Sets the cache from a JSON object of the form {"directory": "/nfs/cache", "maxGB": 200, "minimumSeconds": 30}.
+   * Only the results of filters that took at least 'minimumSeconds' are stored.
+   * @param settings
+   */
+  void configure(const QJsonObject& settings);
+
+  /**
+   * @brief Returns true if a cache directory is set
+   * @return
+   */
+  bool isEnabled() const;
+
+  /**
+   * @brief Returns true if the result after a filter that took 'seconds' should be stored
+   * @param seconds
+   * @return
+   */
+  bool wantsResultAfter(double seconds) const;
+
+  /**
+   * @brief Returns true if there is an entry for 'key'. An empty key, which PrefixHashes() returns for
+   * prefixes whose inputs could not be content hashed, is never found or stored.
+   * @param key
+   * @return
+   */
+  bool contains(const QString& key) const;
+
+  /**
+   * @brief Reads the entry for 'key' and marks it as used. A successful fetch counts as a hit.
+   * @param key
+   * @return A null pointer if there is no readable entry
+   */
+  DataContainerArray::Pointer fetch(const QString& key);
+
+  /**
+   * @brief Counts an execution that found no prefix of its pipeline in the cache
+   */
+  void countMiss();
+
+  /**
+   * @brief Stores 'dca' as the entry for 'key' unless there is one, then removes the least recently used
+   * entries beyond the size cap
+   * @param key
+   * @param dca
+   * @return True if there is an entry for 'key' afterwards, including one another host stored at the same time
+   */
+  bool store(const QString& key, DataContainerArray::Pointer dca);
+
+  /**
+   * @brief Adds the counters of this process to the statistics of this host in the cache directory
+   */
+  void flushStatistics();
+
+  /**
+   * @brief Returns the counters of this process
+   * @return
+   */
+  QJsonObject statistics() const;
+
+  /**
+   * @brief Returns the counters of all hosts that used a cache directory, and its current size
+   * @param directory
+   * @return
+   */
+  static QJsonObject ReadStatistics(const QString& directory);
+
+private:
+  QString m_Directory;
+  qint64 m_MaxBytes = 0;
+  double m_MinimumSeconds = 0.0;
+  int m_Hits = 0;
+  int m_Misses = 0;
+  int m_Stores = 0;
+  int m_Evictions = 0;
+  QJsonObject m_Flushed;
+
+  /**
+   * @brief Returns the file of the entry for 'key'
+   * @param key
+   * @return
+   */
+  QString entryFile(const QString& key) const;
+
+  /**
+   * @brief Removes the least recently used entries until the cache is below its size cap
+   */
+  void evict();
+
+public:
+  PipelineResultCache(const PipelineResultCache&) = delete;            // Copy Constructor Not Implemented
+  PipelineResultCache(PipelineResultCache&&) = delete;                 // Move Constructor Not Implemented
+  PipelineResultCache& operator=(const PipelineResultCache&) = delete; // Copy Assignment Not Implemented
+  PipelineResultCache& operator=(PipelineResultCache&&) = delete;      // Move Assignment Not Implemented
+};
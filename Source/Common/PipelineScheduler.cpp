@@ -0,0 +1,380 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineScheduler.h"
+
+#include <algorithm>
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFutureWatcher>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "Common/FilterDataUsage.h"
+#include "Common/ThreadBudget.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+// Returns a text per data container that changes whenever its geometry type, attribute matrices or arrays change
+// -----------------------------------------------------------------------------
+QMap<QString, QByteArray> StructureSignatures(DataContainerArray::Pointer dca)
+{
+  QMap<QString, QByteArray> signatures;
+  for(DataContainer::Pointer dc : dca->getDataContainers())
+  {
+    IGeometry::Pointer geometry = dc->getGeometry();
+    QByteArray signature = nullptr != geometry.get() ? geometry->getGeometryTypeAsString().toUtf8() : QByteArray("None");
+    for(AttributeMatrix::Pointer am : dc->getAttributeMatrices())
+    {
+      signature += "|" + am->getName().toUtf8() + ":" + QByteArray::number(static_cast<int>(am->getType())) + ":" + QByteArray::number(static_cast<qulonglong>(am->getNumberOfTuples()));
+      for(const QString& arrayName : am->getAttributeArrayNames())
+      {
+        IDataArray::Pointer array = am->getAttributeArray(arrayName);
+        signature += "," + arrayName.toUtf8() + ":" + array->getTypeAsString().toUtf8() + ":" + QByteArray::number(array->getNumberOfComponents());
+      }
+    }
+    signatures.insert(dc->getName(), signature);
+  }
+  return signatures;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineScheduler::PipelineScheduler(int maxConcurrent, QObject* parent)
+: QObject(parent)
+, m_MaxConcurrent(qMax(1, maxConcurrent))
+{
+  qRegisterMetaType<PipelineMessage>("PipelineMessage");
+  m_ThreadPool.setMaxThreadCount(m_MaxConcurrent);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineScheduler::~PipelineScheduler()
+{
+  m_ThreadPool.waitForDone();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<PipelineScheduler::Node> PipelineScheduler::BuildGraph(const FilterPipeline::FilterContainerType& filters, int first)
+{
+  QVector<Node> nodes;
+  QMap<QString, QByteArray> before;
+  DataContainerArray* previousStructure = nullptr;
+  for(int i = 0; i < filters.size(); i++)
+  {
+    AbstractFilter::Pointer filter = filters[i];
+    if(!filter->getEnabled())
+    {
+      continue;
+    }
+
+    // The preflight left the data structure after this filter in it
+    DataContainerArray::Pointer structure = filter->getDataContainerArray();
+    QMap<QString, QByteArray> after;
+    if(nullptr != structure.get())
+    {
+      after = StructureSignatures(structure);
+    }
+
+    if(i >= first)
+    {
+      Node node;
+      node.index = i;
+      node.filter = filter;
+      if(nullptr != structure.get())
+      {
+        for(DataContainer::Pointer dc : structure->getDataContainers())
+        {
+          node.dataContainerOrder << dc->getName();
+        }
+      }
+      // Without a structure of its own the changes of the filter are unknown
+      node.exclusive = nullptr == structure.get() || structure.get() == previousStructure;
+      FilterDataUsage usage = FilterDataUsage::Scan(filter);
+      node.exclusive = node.exclusive || usage.unknown;
+      node.fileAccess = usage.fileAccess;
+      for(const DataArrayPath& path : usage.paths)
+      {
+        node.dataContainers.insert(path.getDataContainerName());
+      }
+      QSet<QString> names = QSet<QString>::fromList(before.keys()) + QSet<QString>::fromList(after.keys());
+      for(const QString& name : names)
+      {
+        if(before.value(name) != after.value(name))
+        {
+          node.dataContainers.insert(name);
+        }
+      }
+      // A file filter that names no data, such as DataContainerWriter, works on everything there is
+      node.exclusive = node.exclusive || (node.fileAccess && node.dataContainers.isEmpty());
+
+      for(int n = 0; n < nodes.size(); n++)
+      {
+        const Node& earlier = nodes[n];
+        // Filters that access files keep their order, so a file is never read before it is written
+        if(earlier.exclusive || node.exclusive || (earlier.fileAccess && node.fileAccess) || earlier.dataContainers.intersects(node.dataContainers))
+        {
+          node.dependencies.push_back(n);
+        }
+      }
+      nodes.push_back(node);
+    }
+    before = after;
+    previousStructure = structure.get();
+  }
+  return nodes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineScheduler::setThreadBudget(ThreadBudget* budget)
+{
+  m_ThreadBudget = budget;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineScheduler::execute(const FilterPipeline::FilterContainerType& filters, int first, DataContainerArray::Pointer dca)
+{
+  m_Nodes = BuildGraph(filters, first);
+  m_States = QVector<State>(m_Nodes.size(), State::Waiting);
+  m_DataContainerArray = dca;
+  m_DoneCount = 0;
+  m_Error = 0;
+
+  QEventLoop eventLoop;
+  m_EventLoop = &eventLoop;
+  startReadyFilters();
+  if(!m_Running.isEmpty())
+  {
+    eventLoop.exec();
+  }
+  m_EventLoop = nullptr;
+  if(m_Error >= 0 && !m_Nodes.isEmpty())
+  {
+    sortDataContainers(m_Nodes.last().dataContainerOrder);
+  }
+  m_DataContainerArray.reset();
+  return m_Error;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineScheduler::startReadyFilters()
+{
+  // After an error only the filters that are still running are waited for
+  for(int n = 0; n < m_Nodes.size() && m_Error >= 0 && m_Running.size() < m_MaxConcurrent; n++)
+  {
+    if(m_States[n] != State::Waiting)
+    {
+      continue;
+    }
+    bool ready = true;
+    for(int dependency : m_Nodes[n].dependencies)
+    {
+      ready = ready && m_States[dependency] == State::Done;
+    }
+    if(ready)
+    {
+      startFilter(n);
+    }
+  }
+
+  if(m_Running.isEmpty() && nullptr != m_EventLoop)
+  {
+    m_EventLoop->quit();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineScheduler::startFilter(int node)
+{
+  const Node& current = m_Nodes[node];
+  AbstractFilter::Pointer filter = current.filter;
+
+  DataContainerArray::Pointer dca = m_DataContainerArray;
+  if(current.exclusive && node > 0)
+  {
+    // Every filter before a barrier is done, so the containers can be put in the order it expects
+    sortDataContainers(m_Nodes[node - 1].dataContainerOrder);
+  }
+  else if(!current.exclusive)
+  {
+    // The containers keep their order, as they would have on the whole array
+    dca = DataContainerArray::New();
+    for(DataContainer::Pointer dc : m_DataContainerArray->getDataContainers())
+    {
+      if(current.dataContainers.contains(dc->getName()))
+      {
+        dca->addDataContainer(dc);
+      }
+    }
+  }
+  m_States[node] = State::Running;
+  m_Running.insert(node, dca);
+
+  PipelineMessage progress;
+  progress.setType(PipelineMessage::MessageType::ProgressValue);
+  progress.setPipelineIndex(filter->getPipelineIndex());
+  progress.setFilterHumanLabel(filter->getHumanLabel());
+  progress.setFilterClassName(filter->getNameOfClass());
+  progress.setProgressValue(static_cast<int>((m_DoneCount + 1) * 100.0 / (m_Nodes.size() + 1)));
+  emit pipelineMessage(progress);
+
+  // Messages are emitted on the pool thread and delivered here in order, before the watcher reports the end
+  connect(filter.get(), &AbstractFilter::filterGeneratedMessage, this, &PipelineScheduler::pipelineMessage, Qt::QueuedConnection);
+  QFutureWatcher<void>* watcher = new QFutureWatcher<void>(this);
+  connect(watcher, &QFutureWatcher<void>::finished, this, [=] {
+    watcher->deleteLater();
+    filterFinished(node);
+  });
+  ThreadBudget* budget = m_ThreadBudget;
+  watcher->setFuture(QtConcurrent::run(&m_ThreadPool, [filter, dca, budget] {
+    filter->setDataContainerArray(dca);
+    if(nullptr != budget)
+    {
+      budget->execute([filter] { filter->execute(); });
+    }
+    else
+    {
+      filter->execute();
+    }
+    filter->setDataContainerArray(DataContainerArray::NullPointer());
+  }));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineScheduler::filterFinished(int node)
+{
+  const Node& current = m_Nodes[node];
+  disconnect(current.filter.get(), &AbstractFilter::filterGeneratedMessage, this, &PipelineScheduler::pipelineMessage);
+  DataContainerArray::Pointer dca = m_Running.take(node);
+  m_States[node] = State::Done;
+  m_DoneCount++;
+
+  int err = current.filter->getErrorCondition();
+  if(err < 0)
+  {
+    if(m_Error >= 0)
+    {
+      m_Error = err;
+    }
+  }
+  else if(!current.exclusive)
+  {
+    mergeResults(current, dca);
+  }
+  startReadyFilters();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineScheduler::mergeResults(const Node& node, DataContainerArray::Pointer dca)
+{
+  // Containers the filter kept or replaced stay where they were, containers it removed or renamed are gone and
+  // the ones it created are appended
+  QList<DataContainer::Pointer> previous = m_DataContainerArray->getDataContainers();
+  QList<DataContainer::Pointer> merged;
+  QSet<QString> names;
+  for(DataContainer::Pointer dc : previous)
+  {
+    names.insert(dc->getName());
+    if(!node.dataContainers.contains(dc->getName()))
+    {
+      merged.push_back(dc);
+    }
+    else if(dca->doesDataContainerExist(dc->getName()))
+    {
+      merged.push_back(dca->getDataContainer(dc->getName()));
+    }
+  }
+  for(DataContainer::Pointer dc : dca->getDataContainers())
+  {
+    if(!names.contains(dc->getName()))
+    {
+      merged.push_back(dc);
+    }
+  }
+
+  setDataContainers(merged);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineScheduler::sortDataContainers(const QStringList& order)
+{
+  QList<DataContainer::Pointer> containers = m_DataContainerArray->getDataContainers();
+  std::stable_sort(containers.begin(), containers.end(), [&order](const DataContainer::Pointer& a, const DataContainer::Pointer& b) {
+    int positionA = order.indexOf(a->getName());
+    int positionB = order.indexOf(b->getName());
+    return (positionA < 0 ? order.size() : positionA) < (positionB < 0 ? order.size() : positionB);
+  });
+  setDataContainers(containers);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineScheduler::setDataContainers(const QList<DataContainer::Pointer>& containers)
+{
+  QList<DataContainer::Pointer> previous = m_DataContainerArray->getDataContainers();
+  for(DataContainer::Pointer dc : previous)
+  {
+    m_DataContainerArray->removeDataContainer(dc->getName());
+  }
+  for(DataContainer::Pointer dc : containers)
+  {
+    m_DataContainerArray->addDataContainer(dc);
+  }
+}
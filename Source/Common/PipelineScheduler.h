@@ -0,0 +1,189 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Common/PipelineMessage.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+class QEventLoop;
+class ThreadBudget;
+
+/**
+ * @brief The PipelineScheduler class executes the filters of a preflighted pipeline as a dataflow graph, so
+ * that filters working on different data containers run at the same time. A filter depends on every earlier
+ * filter that works on one of its data containers. The data containers of a filter are the ones named by its
+ * DataArrayPath and data container parameters plus the ones whose structure its preflight changed, which
+ * covers containers it creates, removes or renames.
+ *
+ * A filter with a parameter that may refer to data in a way this class does not understand runs alone, as a
+ * barrier for everything before and after it, and so does a filter that accesses files without naming any data. Filters that read or write files keep their pipeline order
+ * and never run at the same time, because file libraries such as HDF5 are not thread safe and one filter
+ * may read what an earlier one wrote. Every other filter executes on a
+ * DataContainerArray that only holds its own data containers, and the changes are merged back when it is
+ * done, so filters running at the same time never touch the same container list. Before a barrier and at the
+ * end the data containers are put in the order that the preflight gave them, which is the order a sequential
+ * execution leaves them in.
+ */
+class PipelineScheduler : public QObject
+{
+  Q_OBJECT
+
+public:
+  /**
+   * @brief The Node struct is one filter of the graph
+   */
+  struct Node
+  {
+    int index = -1;
+    AbstractFilter::Pointer filter;
+    QSet<QString> dataContainers;
+    bool exclusive = false;
+    bool fileAccess = false;
+    QVector<int> dependencies;
+    QStringList dataContainerOrder;
+  };
+
+  /**
+   * @brief PipelineScheduler
+   * @param maxConcurrent The number of filters that execute at the same time
+   * @param parent
+   */
+  PipelineScheduler(int maxConcurrent, QObject* parent = nullptr);
+  ~PipelineScheduler() override;
+
+  /**
+   * @brief Builds the graph of the enabled filters from 'first' on. The pipeline must have been preflighted
+   * so every filter holds the data structure after it.
+   * @param filters
+   * @param first
+   * @return The nodes in pipeline order; dependencies are positions in the returned vector
+   */
+  static QVector<Node> BuildGraph(const FilterPipeline::FilterContainerType& filters, int first);
+
+  /**
+   * @brief Sets the budget that the filters execute in, so that the filters running at the same time share
+   * its threads. The budget is not owned.
+   * @param budget
+   */
+  void setThreadBudget(ThreadBudget* budget);
+
+  /**
+   * @brief Executes the filters from 'first' on into 'dca' and returns when all are done or one failed
+   * @param filters
+   * @param first
+   * @param dca
+   * @return 0 or the error condition of the first filter that failed
+   */
+  int execute(const FilterPipeline::FilterContainerType& filters, int first, DataContainerArray::Pointer dca);
+
+signals:
+  /**
+   * @brief Forwards the messages of the filters, and a progress message when a filter starts
+   */
+  void pipelineMessage(const PipelineMessage& pm);
+
+private:
+  enum class State
+  {
+    Waiting,
+    Running,
+    Done
+  };
+
+  QThreadPool m_ThreadPool;
+  int m_MaxConcurrent = 1;
+  QVector<Node> m_Nodes;
+  QVector<State> m_States;
+  QMap<int, DataContainerArray::Pointer> m_Running;
+  DataContainerArray::Pointer m_DataContainerArray;
+  int m_DoneCount = 0;
+  int m_Error = 0;
+  QEventLoop* m_EventLoop = nullptr;
+  ThreadBudget* m_ThreadBudget = nullptr;
+
+  /**
+   * @brief Starts every waiting filter whose dependencies are done, as far as the limits allow
+   */
+  void startReadyFilters();
+
+  /**
+   * @brief Starts one filter on the thread pool
+   * @param node
+   */
+  void startFilter(int node);
+
+  /**
+   * @brief Merges the data containers of a finished filter and starts the filters that were waiting for it
+   * @param node
+   */
+  void filterFinished(int node);
+
+  /**
+   * @brief Puts the data containers of a filter that executed on its own DataContainerArray back into the
+   * DataContainerArray of the pipeline
+   * @param node
+   * @param dca
+   */
+  void mergeResults(const Node& node, DataContainerArray::Pointer dca);
+
+  /**
+   * @brief Sorts the data containers of the pipeline by their position in 'order'. Containers that are not
+   * in it go last.
+   * @param order
+   */
+  void sortDataContainers(const QStringList& order);
+
+  /**
+   * @brief Replaces the data containers of the pipeline with 'containers', in that order
+   * @param containers
+   */
+  void setDataContainers(const QList<DataContainer::Pointer>& containers);
+
+public:
+  PipelineScheduler(const PipelineScheduler&) = delete;            // Copy Constructor Not Implemented
+  PipelineScheduler(PipelineScheduler&&) = delete;                 // Move Constructor Not Implemented
+  PipelineScheduler& operator=(const PipelineScheduler&) = delete; // Copy Assignment Not Implemented
+  PipelineScheduler& operator=(PipelineScheduler&&) = delete;      // Move Assignment Not Implemented
+};
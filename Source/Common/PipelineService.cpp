@@ -0,0 +1,462 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineService.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+#include "Common/PipelineWorkerPool.h"
+
+namespace
+{
+// Bounds on what is remembered for 'status' and 'subscribe'
+const int k_MaxMessagesPerJob = 1000;
+const int k_MaxFinishedJobs = 1000;
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineService::PipelineService(const QString& workerProgram, const QStringList& workerArguments, int maxConcurrent, QObject* parent)
+: QObject(parent)
+{
+  m_Pool = new PipelineWorkerPool(workerProgram, workerArguments, maxConcurrent, this);
+  connect(m_Pool, &PipelineWorkerPool::jobStarted, this, &PipelineService::jobStarted);
+  connect(m_Pool, &PipelineWorkerPool::jobMessage, this, &PipelineService::jobMessage);
+  connect(m_Pool, &PipelineWorkerPool::jobFinished, this, &PipelineService::jobFinished);
+
+  // Load the plugins now instead of when the first job arrives
+  m_Pool->setMinimumWorkers(maxConcurrent);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineService::~PipelineService()
+{
+  disconnect(m_Pool, nullptr, this, nullptr);
+  m_Pool->shutdown();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineService::DefaultServerName()
+{
+  QString user = QString::fromLocal8Bit(qgetenv("USER"));
+  if(user.isEmpty())
+  {
+    user = QString::fromLocal8Bit(qgetenv("USERNAME"));
+  }
+  if(user.isEmpty())
+  {
+    user = QDir::homePath();
+  }
+  QByteArray userHash = QCryptographicHash::hash(user.toUtf8(), QCryptographicHash::Sha1).toHex().left(12);
+  return QString("SIMPLViewPipelineService-%1").arg(QString::fromLatin1(userHash));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineService::listen(const QString& serverName)
+{
+  QLocalServer* server = new QLocalServer(this);
+  server->setSocketOptions(QLocalServer::UserAccessOption);
+  if(!server->listen(serverName))
+  {
+    QLocalSocket probe;
+    probe.connectToServer(serverName);
+    if(probe.waitForConnected(500))
+    {
+      qDebug() << "Another service is already listening on " << serverName;
+      delete server;
+      return false;
+    }
+    QLocalServer::removeServer(serverName);
+    if(!server->listen(serverName))
+    {
+      qDebug() << "Could not listen on " << serverName << ": " << server->errorString();
+      delete server;
+      return false;
+    }
+  }
+
+  connect(server, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+  m_Server = server;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineService::fullServerName() const
+{
+  return m_Server != nullptr ? m_Server->fullServerName() : QString();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineService::acceptConnection()
+{
+  while(m_Server->hasPendingConnections())
+  {
+    QLocalSocket* socket = m_Server->nextPendingConnection();
+    connect(socket, &QLocalSocket::disconnected, this, [this, socket] {
+      m_Subscriptions.remove(socket);
+      socket->deleteLater();
+    });
+    connect(socket, &QLocalSocket::readyRead, this, [this, socket] {
+      while(socket->canReadLine())
+      {
+        QByteArray line = socket->readLine().trimmed();
+        if(line.isEmpty())
+        {
+          continue;
+        }
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+        if(parseError.error != QJsonParseError::NoError || !doc.isObject())
+        {
+          QJsonObject reply;
+          reply["ok"] = false;
+          reply["error"] = QString("The request is not a JSON object: %1").arg(parseError.errorString());
+          Send(socket, reply);
+          continue;
+        }
+        handleRequest(socket, doc.object());
+      }
+    });
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineService::handleRequest(QLocalSocket* socket, const QJsonObject& request)
+{
+  QString command = request["command"].toString();
+  QString id = request["id"].toString();
+  QJsonObject reply;
+  reply["reply"] = command;
+  reply["ok"] = true;
+
+  if(command == "submit")
+  {
+    QJsonObject result = submit(request);
+    for(QJsonObject::const_iterator iter = result.constBegin(); iter != result.constEnd(); ++iter)
+    {
+      reply[iter.key()] = iter.value();
+    }
+  }
+  else if(command == "status")
+  {
+    if(!m_Jobs.contains(id))
+    {
+      reply["ok"] = false;
+      reply["error"] = QString("There is no job '%1'").arg(id);
+    }
+    else
+    {
+      reply["job"] = jobStatus(m_Jobs[id]);
+    }
+  }
+  else if(command == "list")
+  {
+    QJsonArray jobs;
+    for(const Job& job : m_Jobs)
+    {
+      jobs.append(jobStatus(job));
+    }
+    reply["jobs"] = jobs;
+    reply["queued"] = m_Pool->queuedJobCount();
+    reply["running"] = m_Pool->runningJobCount();
+  }
+  else if(command == "cancel")
+  {
+    reply["id"] = id;
+    if(!m_Pool->cancel(id))
+    {
+      reply["ok"] = false;
+      reply["error"] = QString("The job '%1' is not queued or running").arg(id);
+    }
+  }
+  else if(command == "subscribe")
+  {
+    // An empty id subscribes to all jobs
+    if(!id.isEmpty() && !m_Jobs.contains(id))
+    {
+      reply["ok"] = false;
+      reply["error"] = QString("There is no job '%1'").arg(id);
+      Send(socket, reply);
+      return;
+    }
+    m_Subscriptions[socket].insert(id);
+    Send(socket, reply);
+    if(!id.isEmpty())
+    {
+      const Job& job = m_Jobs[id];
+      for(QJsonObject message : job.messages)
+      {
+        message["id"] = id;
+        Send(socket, message);
+      }
+      if(job.state != "queued" && job.state != "running")
+      {
+        QJsonObject event = jobStatus(job);
+        event["event"] = "finished";
+        Send(socket, event);
+      }
+    }
+    return;
+  }
+  else if(command == "unsubscribe")
+  {
+    m_Subscriptions[socket].remove(id);
+  }
+  else if(command == "shutdown")
+  {
+    Send(socket, reply);
+    socket->flush();
+    emit shutdownRequested();
+    return;
+  }
+  else
+  {
+    reply["ok"] = false;
+    reply["error"] = QString("Unknown command '%1'").arg(command);
+  }
+  Send(socket, reply);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineService::setJobSettings(const PipelineJob& settings)
+{
+  m_JobSettings = settings;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineService::submit(const QJsonObject& request)
+{
+  QJsonObject reply;
+  Job job;
+  job.id = request["id"].toString();
+  if(job.id.isEmpty())
+  {
+    do
+    {
+      job.id = QString("job-%1").arg(m_NextJobNumber++);
+    } while(m_Jobs.contains(job.id));
+  }
+  else if(m_Jobs.contains(job.id))
+  {
+    reply["ok"] = false;
+    reply["error"] = QString("The job id '%1' is already in use").arg(job.id);
+    return reply;
+  }
+
+  if(request["pipelineJson"].isObject())
+  {
+    // The workers read pipelines from files, so submitted pipelines are written to the service's directory
+    QString fileName = QString(QCryptographicHash::hash(job.id.toUtf8(), QCryptographicHash::Sha1).toHex()) + ".json";
+    job.temporaryFile = m_PipelineDir.filePath(fileName);
+    QFile file(job.temporaryFile);
+    if(!m_PipelineDir.isValid() || !file.open(QIODevice::WriteOnly))
+    {
+      reply["ok"] = false;
+      reply["error"] = "The submitted pipeline could not be stored";
+      return reply;
+    }
+    file.write(QJsonDocument(request["pipelineJson"].toObject()).toJson(QJsonDocument::Compact));
+    job.pipelineFile = job.temporaryFile;
+  }
+  else
+  {
+    job.pipelineFile = request["pipeline"].toString();
+  }
+  if(job.pipelineFile.isEmpty())
+  {
+    reply["ok"] = false;
+    reply["error"] = "A \"pipelineJson\" object or a \"pipeline\" file must be given";
+    return reply;
+  }
+
+  job.state = "queued";
+  job.priority = request["priority"].toInt();
+  m_Jobs.insert(job.id, job);
+
+  PipelineJob pipelineJob = m_JobSettings;
+  pipelineJob.id = job.id;
+  pipelineJob.pipelineFile = job.pipelineFile;
+  pipelineJob.overrides = request["overrides"].toObject();
+  pipelineJob.priority = job.priority;
+  m_Pool->submit(pipelineJob);
+
+  reply["id"] = job.id;
+  reply["state"] = m_Jobs[job.id].state;
+  return reply;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineService::jobStatus(const Job& job) const
+{
+  QJsonObject status;
+  status["id"] = job.id;
+  status["state"] = job.state;
+  status["priority"] = job.priority;
+  status["pipeline"] = job.temporaryFile.isEmpty() ? job.pipelineFile : QString();
+  status["index"] = job.filterIndex;
+  status["filter"] = job.filter;
+  status["progress"] = job.progress;
+  status["messageCount"] = job.messages.size();
+  if(job.state != "queued" && job.state != "running")
+  {
+    status["error"] = job.error;
+    status["elapsedMs"] = static_cast<double>(job.elapsedMs);
+    status["errorText"] = job.errorText;
+  }
+  return status;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineService::jobStarted(const QString& id)
+{
+  if(!m_Jobs.contains(id))
+  {
+    return;
+  }
+  m_Jobs[id].state = "running";
+  QJsonObject event;
+  event["event"] = "started";
+  event["id"] = id;
+  publish(id, event);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineService::jobMessage(const QString& id, const QJsonObject& message)
+{
+  if(!m_Jobs.contains(id))
+  {
+    return;
+  }
+  Job& job = m_Jobs[id];
+  job.filterIndex = message["index"].toInt();
+  job.filter = message["filter"].toString();
+  QString type = message["type"].toString();
+  if(type == "Progress" || type == "StatusAndProgress")
+  {
+    job.progress = message["progress"].toInt();
+  }
+  job.messages.push_back(message);
+  if(job.messages.size() > k_MaxMessagesPerJob)
+  {
+    job.messages.removeFirst();
+  }
+  publish(id, message);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineService::jobFinished(const QString& id, int error, qint64 elapsedMs, const QString& errorText)
+{
+  if(!m_Jobs.contains(id))
+  {
+    return;
+  }
+  Job& job = m_Jobs[id];
+  job.state = error == PipelineWorkerPool::k_Canceled ? "canceled" : (error < 0 ? "failed" : "finished");
+  job.error = error;
+  job.elapsedMs = elapsedMs;
+  job.errorText = errorText;
+  if(!job.temporaryFile.isEmpty())
+  {
+    QFile::remove(job.temporaryFile);
+  }
+
+  QJsonObject event = jobStatus(job);
+  event["event"] = "finished";
+  publish(id, event);
+
+  m_FinishedJobs.push_back(id);
+  while(m_FinishedJobs.size() > k_MaxFinishedJobs)
+  {
+    m_Jobs.remove(m_FinishedJobs.takeFirst());
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineService::publish(const QString& id, const QJsonObject& event)
+{
+  QJsonObject obj = event;
+  obj["id"] = id;
+  for(QHash<QLocalSocket*, QSet<QString>>::const_iterator iter = m_Subscriptions.constBegin(); iter != m_Subscriptions.constEnd(); ++iter)
+  {
+    if(iter.value().contains(id) || iter.value().contains(QString()))
+    {
+      Send(iter.key(), obj);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineService::Send(QLocalSocket* socket, const QJsonObject& obj)
+{
+  socket->write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+  socket->write("\n");
+}
@@ -0,0 +1,172 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QTemporaryDir>
+
+#include "Common/PipelineWorkerPool.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * @brief The PipelineService class is a long running pipeline execution service on a local socket (a Unix
+ * domain socket or a Windows named pipe that only the current user can open). Jobs are executed by a
+ * PipelineWorkerPool whose workers are started right away and kept running, so plugins are loaded once per
+ * worker and not once per job.
+ *
+ * Clients send one JSON object per line and receive one JSON object per line:
+ *
+ *   {"command": "submit", "pipelineJson": {...}, "overrides": {"0:InputFile": "/data/a.h5"}, "priority": 5}
+ *   {"command": "submit", "pipeline": "/path/to/Pipeline.json", "id": "my-job"}
+ *      -> {"reply": "submit", "ok": true, "id": "job-1", "state": "queued"}
+ *   {"command": "status", "id": "job-1"}  -> {"reply": "status", "ok": true, "job": {...}}
+ *   {"command": "list"}                   -> {"reply": "list", "ok": true, "jobs": [...], "queued": 3, "running": 2}
+ *   {"command": "cancel", "id": "job-1"}  -> {"reply": "cancel", "ok": true, "id": "job-1"}
+ *   {"command": "subscribe", "id": "job-1"} or {"command": "subscribe"} for all jobs
+ *      -> the messages received so far, then every new {"event": "message", ...} and {"event": "finished", ...}
+ *   {"command": "unsubscribe", "id": "job-1"}
+ *   {"command": "shutdown"}
+ *
+ * The "message" events are the PipelineMessages of the executing pipeline in the form of
+ * PipelineWorker::MessageToJson(). Failed requests are answered with "ok": false and an "error" text.
+ */
+class PipelineService : public QObject
+{
+  Q_OBJECT
+
+public:
+  /**
+   * @brief PipelineService
+   * @param workerProgram The worker executable
+   * @param workerArguments The arguments that put the executable into worker mode
+   * @param maxConcurrent The number of jobs that are executed at the same time
+   * @param parent
+   */
+  PipelineService(const QString& workerProgram, const QStringList& workerArguments, int maxConcurrent, QObject* parent = nullptr);
+  ~PipelineService() override;
+
+  /**
+   * @brief Returns the per user socket name that clients connect to if no other name is given
+   * @return
+   */
+  static QString DefaultServerName();
+
+  /**
+   * @brief Starts listening. A socket that is left over from a crashed service is taken over.
+   * @param serverName
+   * @return
+   */
+  bool listen(const QString& serverName);
+
+  /**
+   * @brief Returns the full path of the socket that the service is listening on
+   * @return
+   */
+  QString fullServerName() const;
+
+  /**
+   * @brief Sets the result cache, concurrency, thread, buffer pool and dead array settings that every
+   * submitted job is executed with. The id, pipeline and overrides of 'settings' are not used.
+   * @param settings
+   */
+  void setJobSettings(const PipelineJob& settings);
+
+signals:
+  /**
+   * @brief Emitted when a client sends the "shutdown" command
+   */
+  void shutdownRequested();
+
+protected slots:
+  void acceptConnection();
+  void jobStarted(const QString& id);
+  void jobMessage(const QString& id, const QJsonObject& message);
+  void jobFinished(const QString& id, int error, qint64 elapsedMs, const QString& errorText);
+
+private:
+  struct Job
+  {
+    QString id;
+    QString state;
+    int priority = 0;
+    QString pipelineFile;
+    QString temporaryFile;
+    int filterIndex = -1;
+    QString filter;
+    int progress = 0;
+    int error = 0;
+    qint64 elapsedMs = 0;
+    QString errorText;
+    QList<QJsonObject> messages;
+  };
+
+  QLocalServer* m_Server = nullptr;
+  PipelineWorkerPool* m_Pool = nullptr;
+  PipelineJob m_JobSettings;
+  QTemporaryDir m_PipelineDir;
+  QMap<QString, Job> m_Jobs;
+  QStringList m_FinishedJobs;
+  int m_NextJobNumber = 1;
+  QHash<QLocalSocket*, QSet<QString>> m_Subscriptions;
+
+  void handleRequest(QLocalSocket* socket, const QJsonObject& request);
+  QJsonObject submit(const QJsonObject& request);
+  QJsonObject jobStatus(const Job& job) const;
+
+  /**
+   * @brief Sends an event to every client that subscribed to the job or to all jobs
+   * @param id
+   * @param event
+   */
+  void publish(const QString& id, const QJsonObject& event);
+
+  static void Send(QLocalSocket* socket, const QJsonObject& obj);
+
+public:
+  PipelineService(const PipelineService&) = delete;            // Copy Constructor Not Implemented
+  PipelineService(PipelineService&&) = delete;                 // Move Constructor Not Implemented
+  PipelineService& operator=(const PipelineService&) = delete; // Copy Assignment Not Implemented
+  PipelineService& operator=(PipelineService&&) = delete;      // Move Assignment Not Implemented
+};
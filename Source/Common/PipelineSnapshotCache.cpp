@@ -0,0 +1,305 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineSnapshotCache.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "Common/PipelineCheckpoint.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineSnapshotCache::PipelineSnapshotCache() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineSnapshotCache::~PipelineSnapshotCache()
+{
+  clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSnapshotCache::configure(const QJsonObject& settings)
+{
+  m_MemoryBudget = static_cast<qint64>(settings["memoryMB"].toDouble() * 1024 * 1024);
+  m_DiskBudget = static_cast<qint64>(settings["diskMB"].toDouble() * 1024 * 1024);
+  m_MinimumSeconds = settings["minimumSeconds"].toDouble();
+
+  // Every process spills into its own subdirectory so that workers sharing a directory never see each other's files
+  QString directory;
+  if(!settings["directory"].toString().isEmpty())
+  {
+    directory = QDir(settings["directory"].toString()).filePath(QString("Snapshots-%1").arg(QCoreApplication::applicationPid()));
+  }
+  if(directory != m_Directory)
+  {
+    for(const DiskSnapshot& snapshot : m_Disk)
+    {
+      QFile::remove(snapshot.file);
+    }
+    m_Disk.clear();
+    m_DiskBytes = 0;
+    if(!m_Directory.isEmpty())
+    {
+      QDir(m_Directory).removeRecursively();
+    }
+    m_Directory = directory;
+  }
+  enforceBudgets();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineSnapshotCache::isEnabled() const
+{
+  return m_MemoryBudget > 0 || (!m_Directory.isEmpty() && m_DiskBudget > 0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineSnapshotCache::wantsSnapshotAfter(double seconds) const
+{
+  return isEnabled() && seconds >= m_MinimumSeconds;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSnapshotCache::store(const QString& key, DataContainerArray::Pointer dca)
+{
+  if(!isEnabled() || key.isEmpty())
+  {
+    return;
+  }
+  // A key identifies the content, so an existing snapshot is as good as a new one
+  if(m_Memory.contains(key))
+  {
+    m_Memory[key].lastUse = ++m_UseCount;
+    return;
+  }
+  if(m_Disk.contains(key))
+  {
+    m_Disk[key].lastUse = ++m_UseCount;
+    return;
+  }
+
+  qint64 bytes = EstimateBytes(dca);
+  if(bytes > m_MemoryBudget)
+  {
+    // A snapshot that would be dropped right away is not worth writing
+    if(m_Directory.isEmpty() || bytes > m_DiskBudget)
+    {
+      return;
+    }
+    // Writing does not change 'dca', so a snapshot that never fits into memory is not copied first
+    spill(key, dca, ++m_UseCount);
+    enforceBudgets();
+    return;
+  }
+
+  MemorySnapshot snapshot;
+  snapshot.dca = dca->deepCopy(false);
+  snapshot.bytes = bytes;
+  snapshot.lastUse = ++m_UseCount;
+  m_Memory.insert(key, snapshot);
+  m_MemoryBytes += bytes;
+  enforceBudgets();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineSnapshotCache::contains(const QString& key) const
+{
+  return !key.isEmpty() && (m_Memory.contains(key) || m_Disk.contains(key));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer PipelineSnapshotCache::restore(const QString& key)
+{
+  if(m_Memory.contains(key))
+  {
+    MemorySnapshot& snapshot = m_Memory[key];
+    snapshot.lastUse = ++m_UseCount;
+    m_Hits++;
+    return snapshot.dca->deepCopy(false);
+  }
+
+  if(m_Disk.contains(key))
+  {
+    DiskSnapshot& snapshot = m_Disk[key];
+    snapshot.lastUse = ++m_UseCount;
+    QString errorMessage;
+    DataContainerArray::Pointer dca = PipelineCheckpoint::Read(snapshot.file, errorMessage);
+    if(nullptr != dca.get())
+    {
+      m_Hits++;
+      return dca;
+    }
+    QFile::remove(snapshot.file);
+    m_DiskBytes -= snapshot.bytes;
+    m_Disk.remove(key);
+  }
+
+  m_Misses++;
+  return DataContainerArray::NullPointer();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSnapshotCache::clear()
+{
+  m_Memory.clear();
+  m_MemoryBytes = 0;
+  for(const DiskSnapshot& snapshot : m_Disk)
+  {
+    QFile::remove(snapshot.file);
+  }
+  m_Disk.clear();
+  m_DiskBytes = 0;
+  if(!m_Directory.isEmpty())
+  {
+    QDir(m_Directory).removeRecursively();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineSnapshotCache::statistics() const
+{
+  QJsonObject stats;
+  stats["hits"] = m_Hits;
+  stats["misses"] = m_Misses;
+  stats["memorySnapshots"] = m_Memory.size();
+  stats["memoryBytes"] = static_cast<double>(m_MemoryBytes);
+  stats["diskSnapshots"] = m_Disk.size();
+  stats["diskBytes"] = static_cast<double>(m_DiskBytes);
+  return stats;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 PipelineSnapshotCache::EstimateBytes(DataContainerArray::Pointer dca)
+{
+  qint64 bytes = 0;
+  for(DataContainer::Pointer dc : dca->getDataContainers())
+  {
+    for(AttributeMatrix::Pointer am : dc->getAttributeMatrices())
+    {
+      for(const QString& arrayName : am->getAttributeArrayNames())
+      {
+        IDataArray::Pointer array = am->getAttributeArray(arrayName);
+        bytes += static_cast<qint64>(array->getSize()) * array->getTypeSize();
+      }
+    }
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSnapshotCache::enforceBudgets()
+{
+  while(m_MemoryBytes > m_MemoryBudget && !m_Memory.isEmpty())
+  {
+    QString oldest = m_Memory.firstKey();
+    for(auto iter = m_Memory.constBegin(); iter != m_Memory.constEnd(); ++iter)
+    {
+      if(iter.value().lastUse < m_Memory[oldest].lastUse)
+      {
+        oldest = iter.key();
+      }
+    }
+    MemorySnapshot snapshot = m_Memory.take(oldest);
+    m_MemoryBytes -= snapshot.bytes;
+    spill(oldest, snapshot.dca, snapshot.lastUse);
+  }
+
+  while(m_DiskBytes > m_DiskBudget && !m_Disk.isEmpty())
+  {
+    QString oldest = m_Disk.firstKey();
+    for(auto iter = m_Disk.constBegin(); iter != m_Disk.constEnd(); ++iter)
+    {
+      if(iter.value().lastUse < m_Disk[oldest].lastUse)
+      {
+        oldest = iter.key();
+      }
+    }
+    DiskSnapshot snapshot = m_Disk.take(oldest);
+    m_DiskBytes -= snapshot.bytes;
+    QFile::remove(snapshot.file);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSnapshotCache::spill(const QString& key, DataContainerArray::Pointer dca, quint64 lastUse)
+{
+  if(m_Directory.isEmpty() || m_DiskBudget <= 0)
+  {
+    return;
+  }
+
+  DiskSnapshot snapshot;
+  snapshot.file = QDir(m_Directory).filePath(QString("Snapshot-%1.dream3d").arg(key));
+  QString errorMessage;
+  if(!PipelineCheckpoint::Write(dca, snapshot.file, errorMessage))
+  {
+    return;
+  }
+  snapshot.bytes = QFileInfo(snapshot.file).size();
+  snapshot.lastUse = lastUse;
+  m_Disk.insert(key, snapshot);
+  m_DiskBytes += snapshot.bytes;
+}
@@ -0,0 +1,165 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+/**
+ * @brief The PipelineSnapshotCache class keeps copies of the DataContainerArray after filters of a pipeline
+ * so that executing the pipeline again only executes the filters after the last unchanged one. Snapshots are
+ * keyed by the PipelineCheckpoint::PrefixHashes() value of the filters before them. They are kept in memory
+ * up to the memory budget; the least recently used ones beyond it are written to the spill directory, which
+ * has its own budget, and dropped from there last.
+ */
+class PipelineSnapshotCache
+{
+public:
+  PipelineSnapshotCache();
+  virtual ~PipelineSnapshotCache();
+
+  /**
+   * @brief Sets the budgets from a JSON object of the form {"memoryMB": 1024, "directory": "/scratch", "diskMB": 4096,
+   * "minimumSeconds": 1}. Snapshots beyond a smaller budget are spilled or dropped right away. Only the results
+   * of filters that took at least 'minimumSeconds' are kept, because every snapshot costs a deep copy of the
+   * whole DataContainerArray or a write of it.
+   * @param settings
+   */
+  void configure(const QJsonObject& settings);
+
+  /**
+   * @brief Returns true if snapshots are kept at all
+   * @return
+   */
+  bool isEnabled() const;
+
+  /**
+   * @brief Returns true if the result after a filter that took 'seconds' should be stored
+   * @param seconds
+   * @return
+   */
+  bool wantsSnapshotAfter(double seconds) const;
+
+  /**
+   * @brief Stores a copy of 'dca' as the snapshot for 'key'. Nothing is stored for an empty key, which
+   * PrefixHashes() returns when inputs could not be identified, or if 'dca' fits into neither budget.
+   * @param key
+   * @param dca
+   */
+  void store(const QString& key, DataContainerArray::Pointer dca);
+
+  /**
+   * @brief Returns true if there is a snapshot for 'key' in memory or on disk
+   * @param key
+   * @return
+   */
+  bool contains(const QString& key) const;
+
+  /**
+   * @brief Returns a copy of the snapshot for 'key' that the caller may change
+   * @param key
+   * @return A null pointer if there is no snapshot for 'key' or it could not be read
+   */
+  DataContainerArray::Pointer restore(const QString& key);
+
+  /**
+   * @brief Removes all snapshots
+   */
+  void clear();
+
+  /**
+   * @brief Returns the hit and miss counts and the memory and disk in use
+   * @return
+   */
+  QJsonObject statistics() const;
+
+  /**
+   * @brief Returns the approximate memory used by the arrays of a DataContainerArray
+   * @param dca
+   * @return
+   */
+  static qint64 EstimateBytes(DataContainerArray::Pointer dca);
+
+private:
+  struct MemorySnapshot
+  {
+    DataContainerArray::Pointer dca;
+    qint64 bytes = 0;
+    quint64 lastUse = 0;
+  };
+
+  struct DiskSnapshot
+  {
+    QString file;
+    qint64 bytes = 0;
+    quint64 lastUse = 0;
+  };
+
+  qint64 m_MemoryBudget = 0;
+  qint64 m_DiskBudget = 0;
+  double m_MinimumSeconds = 0.0;
+  QString m_Directory;
+  QMap<QString, MemorySnapshot> m_Memory;
+  QMap<QString, DiskSnapshot> m_Disk;
+  qint64 m_MemoryBytes = 0;
+  qint64 m_DiskBytes = 0;
+  quint64 m_UseCount = 0;
+  int m_Hits = 0;
+  int m_Misses = 0;
+
+  /**
+   * @brief Spills or drops the least recently used snapshots until both budgets are kept
+   */
+  void enforceBudgets();
+
+  /**
+   * @brief Writes a snapshot to the spill directory if there is one. enforceBudgets() drops it again if it
+   * does not fit into the disk budget.
+   * @param key
+   * @param dca
+   * @param lastUse
+   */
+  void spill(const QString& key, DataContainerArray::Pointer dca, quint64 lastUse);
+
+public:
+  PipelineSnapshotCache(const PipelineSnapshotCache&) = delete;            // Copy Constructor Not Implemented
+  PipelineSnapshotCache(PipelineSnapshotCache&&) = delete;                 // Move Constructor Not Implemented
+  PipelineSnapshotCache& operator=(const PipelineSnapshotCache&) = delete; // Copy Assignment Not Implemented
+  PipelineSnapshotCache& operator=(PipelineSnapshotCache&&) = delete;      // Move Assignment Not Implemented
+};
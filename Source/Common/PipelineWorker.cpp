@@ -0,0 +1,330 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineWorker.h"
+
+#include <iostream>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonDocument>
+
+#include "Common/PipelineCheckpoint.h"
+#include "Common/SharedDataContainerArray.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineWorker::PipelineWorker(QObject* parent)
+: PipelineExecutor(parent)
+{
+  std::cout.flush();
+  fflush(stdout);
+#if defined(_MSC_VER)
+  m_Events = _fdopen(_dup(_fileno(stdout)), "w");
+  _dup2(_fileno(stderr), _fileno(stdout));
+#else
+  m_Events = fdopen(dup(fileno(stdout)), "w");
+  dup2(fileno(stderr), fileno(stdout));
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineWorker::~PipelineWorker()
+{
+  if(nullptr != m_Events)
+  {
+    fclose(m_Events);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineWorker::run()
+{
+  QJsonObject ready;
+  ready["event"] = "ready";
+  sendEvent(ready);
+
+  std::string line;
+  while(std::getline(std::cin, line))
+  {
+    if(line.empty())
+    {
+      continue;
+    }
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(line), &parseError);
+    if(parseError.error != QJsonParseError::NoError || !doc.isObject())
+    {
+      std::cerr << "PipelineWorker: Ignoring a request that is not a JSON object: " << parseError.errorString().toStdString() << std::endl;
+      continue;
+    }
+    QJsonObject request = doc.object();
+    if(request["command"].toString() == "quit")
+    {
+      break;
+    }
+    runJob(request);
+  }
+  return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorker::runJob(const QJsonObject& request)
+{
+  QElapsedTimer timer;
+  timer.start();
+  m_JobId = request["id"].toString();
+
+  QJsonObject event;
+  event["id"] = m_JobId;
+  event["event"] = "started";
+  sendEvent(event);
+
+  int err = 0;
+  QString errorText;
+  FilterPipeline::Pointer pipeline = ReadPipelineFromFile(request["pipeline"].toString(), errorText);
+  if(nullptr == pipeline.get())
+  {
+    err = -1;
+  }
+  else if(!ApplyOverrides(pipeline, request["overrides"].toObject(), errorText))
+  {
+    err = -2;
+  }
+  else
+  {
+    QJsonObject checkpoint = request["checkpoint"].toObject();
+    int checkpointFilters = checkpoint["filters"].toInt();
+    if(checkpointFilters > 0 && checkpoint["write"].toBool())
+    {
+      PipelineCheckpoint::WriteAfter(pipeline, checkpointFilters, checkpoint["file"].toString());
+    }
+    else if(checkpointFilters > 0)
+    {
+      PipelineCheckpoint::StartFrom(pipeline, checkpointFilters, checkpoint["file"].toString());
+    }
+    setCheckpointPolicy(PipelineCheckpointPolicy::FromJson(request["checkpoints"].toObject()));
+    // The cache lives as long as the worker, so a later job with the same upstream filters starts after them
+    if(request.contains("snapshots"))
+    {
+      m_SnapshotCache.configure(request["snapshots"].toObject());
+      setSnapshotCache(&m_SnapshotCache);
+    }
+    else
+    {
+      setSnapshotCache(nullptr);
+    }
+    if(request.contains("resultCache"))
+    {
+      m_ResultCache.configure(request["resultCache"].toObject());
+      setResultCache(&m_ResultCache);
+    }
+    else
+    {
+      setResultCache(nullptr);
+    }
+    setMaxConcurrentFilters(request["concurrentFilters"].toInt(1));
+    setMaxThreads(request["threads"].toInt(0));
+    setBufferPoolSize(static_cast<qint64>(request["bufferPoolMB"].toDouble()) * 1024 * 1024);
+    // Published results must contain every array that the pipeline leaves
+    setReleaseDeadArrays(request.contains("releaseDeadArrays"), request["releaseDeadArrays"].toObject()["spillDirectory"].toString(), request.contains("publish"));
+    err = execute(pipeline);
+    if(err < 0)
+    {
+      errorText = QString("The pipeline failed with error %1").arg(err);
+    }
+    else if(request.contains("publish"))
+    {
+      publish(request["publish"].toString());
+    }
+    clearDataContainerArray();
+  }
+
+  event["event"] = "finished";
+  event["error"] = err;
+  event["elapsedMs"] = static_cast<double>(timer.elapsed());
+  event["errorText"] = errorText;
+  if(request.contains("snapshots"))
+  {
+    event["snapshots"] = m_SnapshotCache.statistics();
+  }
+  if(request.contains("resultCache"))
+  {
+    event["resultCache"] = m_ResultCache.statistics();
+  }
+  sendEvent(event);
+  m_JobId.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorker::publish(const QString& directory)
+{
+  QString errorMessage;
+  QJsonObject description = SharedDataContainerArray::Publish(getDataContainerArray(), directory, errorMessage);
+  if(description.isEmpty())
+  {
+    // The pipeline itself succeeded so this is only reported, the receiver sees that nothing was published
+    std::cerr << "PipelineWorker: The results could not be published: " << errorMessage.toStdString() << std::endl;
+    return;
+  }
+
+  QJsonObject event;
+  event["id"] = m_JobId;
+  event["event"] = "published";
+  event["description"] = description;
+  sendEvent(event);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineWorker::MessageToJson(const PipelineMessage& pm)
+{
+  QString type;
+  switch(pm.getType())
+  {
+  case PipelineMessage::MessageType::Error:
+    type = "Error";
+    break;
+  case PipelineMessage::MessageType::Warning:
+    type = "Warning";
+    break;
+  case PipelineMessage::MessageType::ProgressValue:
+    type = "Progress";
+    break;
+  case PipelineMessage::MessageType::StatusMessageAndProgressValue:
+    type = "StatusAndProgress";
+    break;
+  case PipelineMessage::MessageType::StatusMessage:
+    type = "Status";
+    break;
+  case PipelineMessage::MessageType::StandardOutputMessage:
+    type = "StandardOutput";
+    break;
+  default:
+    type = "Unknown";
+    break;
+  }
+
+  QJsonObject obj;
+  obj["event"] = "message";
+  obj["type"] = type;
+  obj["index"] = pm.getPipelineIndex();
+  obj["filter"] = pm.getFilterHumanLabel();
+  obj["className"] = pm.getFilterClassName();
+  obj["code"] = pm.getCode();
+  obj["progress"] = pm.getProgressValue();
+  obj["text"] = pm.getText();
+  return obj;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineMessage PipelineWorker::MessageFromJson(const QJsonObject& obj)
+{
+  QString type = obj["type"].toString();
+  PipelineMessage::MessageType messageType = PipelineMessage::MessageType::UnknownMessageType;
+  if(type == "Error")
+  {
+    messageType = PipelineMessage::MessageType::Error;
+  }
+  else if(type == "Warning")
+  {
+    messageType = PipelineMessage::MessageType::Warning;
+  }
+  else if(type == "Progress")
+  {
+    messageType = PipelineMessage::MessageType::ProgressValue;
+  }
+  else if(type == "StatusAndProgress")
+  {
+    messageType = PipelineMessage::MessageType::StatusMessageAndProgressValue;
+  }
+  else if(type == "Status")
+  {
+    messageType = PipelineMessage::MessageType::StatusMessage;
+  }
+  else if(type == "StandardOutput")
+  {
+    messageType = PipelineMessage::MessageType::StandardOutputMessage;
+  }
+
+  PipelineMessage pm;
+  pm.setType(messageType);
+  pm.setPipelineIndex(obj["index"].toInt());
+  pm.setFilterHumanLabel(obj["filter"].toString());
+  pm.setFilterClassName(obj["className"].toString());
+  pm.setCode(obj["code"].toInt());
+  pm.setProgressValue(obj["progress"].toInt());
+  pm.setText(obj["text"].toString());
+  return pm;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorker::processPipelineMessage(const PipelineMessage& pm)
+{
+  QJsonObject event = MessageToJson(pm);
+  event["id"] = m_JobId;
+  sendEvent(event);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorker::sendEvent(const QJsonObject& event)
+{
+  QByteArray line = QJsonDocument(event).toJson(QJsonDocument::Compact);
+  line.append('\n');
+  fwrite(line.constData(), 1, static_cast<size_t>(line.size()), m_Events);
+  fflush(m_Events);
+}
@@ -0,0 +1,134 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <cstdio>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+#include "Common/PipelineExecutor.h"
+#include "Common/PipelineResultCache.h"
+#include "Common/PipelineSnapshotCache.h"
+
+/**
+ * @brief The PipelineWorker class is the worker side of PipelineWorkerPool. It runs inside a worker process
+ * whose plugins have already been loaded and executes one job after another. Jobs are read from stdin and
+ * events are written back one JSON object per line:
+ *
+ * Request:  {"id": "job-1", "pipeline": "/path/to/Pipeline.json", "overrides": {"0:InputFile": "/path/to/Input.h5"}}
+ *           {"id": "job-2", "pipeline": "/path/to/Pipeline.json", "checkpoint": {"file": "/tmp/Prefix.dream3d", "filters": 4, "write": false}}
+ *           {"id": "job-3", "pipeline": "/path/to/Pipeline.json", "publish": "/dev/shm/SIMPLView-abc123"}
+ *           {"id": "job-4", "pipeline": "/path/to/Pipeline.json", "checkpoints": {"directory": "/scratch", "everyFilters": 5, "resume": true}}
+ *           {"id": "job-5", "pipeline": "/path/to/Pipeline.json", "snapshots": {"memoryMB": 2048, "directory": "/scratch", "diskMB": 8192}}
+ *           {"id": "job-6", "pipeline": "/path/to/Pipeline.json", "resultCache": {"directory": "/nfs/cache", "maxGB": 200, "minimumSeconds": 30}}
+ *           {"command": "quit"}
+ * Events:   {"event": "ready"}
+ *           {"id": "job-1", "event": "started"}
+ *           {"id": "job-1", "event": "message", "type": "Progress", "index": 2, "filter": "Label", "className": "Filter", "code": 0, "progress": 40, "text": ""}
+ *           {"id": "job-3", "event": "published", "description": {...}}
+ *           {"id": "job-1", "event": "finished", "error": 0, "elapsedMs": 1234, "errorText": ""}
+ *
+ * "checkpoints" is a PipelineCheckpointPolicy in the form of PipelineCheckpointPolicy::toJson().
+ * "snapshots" configures the PipelineSnapshotCache that the worker keeps across its jobs; the "finished"
+ * event of such a job carries the cache statistics. "resultCache" does the same for the PipelineResultCache.
+ * A request with "publish" hands the resulting DataContainerArray to the requesting process through
+ * SharedDataContainerArray before the job is reported as finished.
+ *
+ * Filters are free to print to stdout, so the constructor moves the original stdout to a private descriptor
+ * for the events and points stdout at stderr.
+ */
+class PipelineWorker : public PipelineExecutor
+{
+  Q_OBJECT
+
+public:
+  PipelineWorker(QObject* parent = nullptr);
+  ~PipelineWorker() override;
+
+  /**
+   * @brief Executes the requests read from stdin until it is closed or a "quit" command arrives
+   * @return The exit code for the worker process
+   */
+  int run();
+
+  /**
+   * @brief Converts a pipeline message to the JSON object of a "message" event, without the job id
+   * @param pm
+   * @return
+   */
+  static QJsonObject MessageToJson(const PipelineMessage& pm);
+
+  /**
+   * @brief Rebuilds the pipeline message of a "message" event
+   * @param obj
+   * @return
+   */
+  static PipelineMessage MessageFromJson(const QJsonObject& obj);
+
+public slots:
+  void processPipelineMessage(const PipelineMessage& pm) override;
+
+private:
+  FILE* m_Events = nullptr;
+  QString m_JobId;
+  PipelineSnapshotCache m_SnapshotCache;
+  PipelineResultCache m_ResultCache;
+
+  /**
+   * @brief Executes a single request
+   * @param request
+   */
+  void runJob(const QJsonObject& request);
+
+  /**
+   * @brief Publishes the DataContainerArray of the last execution to 'directory' and sends the "published" event
+   * @param directory
+   */
+  void publish(const QString& directory);
+
+  /**
+   * @brief Writes one event line and flushes it
+   * @param event
+   */
+  void sendEvent(const QJsonObject& event);
+
+public:
+  PipelineWorker(const PipelineWorker&) = delete;            // Copy Constructor Not Implemented
+  PipelineWorker(PipelineWorker&&) = delete;                 // Move Constructor Not Implemented
+  PipelineWorker& operator=(const PipelineWorker&) = delete; // Copy Assignment Not Implemented
+  PipelineWorker& operator=(PipelineWorker&&) = delete;      // Move Assignment Not Implemented
+};
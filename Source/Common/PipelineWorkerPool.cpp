@@ -0,0 +1,378 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineWorkerPool.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QJsonDocument>
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineWorkerPool::PipelineWorkerPool(const QString& program, const QStringList& arguments, int maxWorkers, QObject* parent)
+: QObject(parent)
+, m_Program(program)
+, m_Arguments(arguments)
+, m_MaxWorkers(qMax(1, maxWorkers))
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineWorkerPool::~PipelineWorkerPool()
+{
+  shutdown();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorkerPool::submit(const PipelineJob& job)
+{
+  int index = m_Queue.size();
+  while(index > 0 && m_Queue[index - 1].priority < job.priority)
+  {
+    index--;
+  }
+  m_Queue.insert(index, job);
+  m_Busy = true;
+  dispatch();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineWorkerPool::cancel(const QString& id)
+{
+  for(int i = 0; i < m_Queue.size(); i++)
+  {
+    if(m_Queue[i].id == id)
+    {
+      m_Queue.removeAt(i);
+      emit jobFinished(id, k_Canceled, 0, "The job was canceled");
+      dispatch();
+      return true;
+    }
+  }
+
+  // Filters cannot be interrupted from the outside, so the worker is killed and replaced
+  for(Worker* worker : m_Workers)
+  {
+    if(worker->jobId == id)
+    {
+      worker->canceled = true;
+      worker->process->kill();
+      return true;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorkerPool::setMinimumWorkers(int count)
+{
+  m_MinWorkers = qBound(0, count, m_MaxWorkers);
+  dispatch();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineWorkerPool::queuedJobCount() const
+{
+  return m_Queue.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineWorkerPool::runningJobCount() const
+{
+  int count = 0;
+  for(Worker* worker : m_Workers)
+  {
+    if(!worker->jobId.isEmpty())
+    {
+      count++;
+    }
+  }
+  return count;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorkerPool::shutdown(int msecs)
+{
+  QVector<Worker*> workers = m_Workers;
+  m_Workers.clear();
+  for(Worker* worker : workers)
+  {
+    disconnect(worker->process, nullptr, this, nullptr);
+    if(worker->process->state() != QProcess::NotRunning)
+    {
+      worker->process->write("{\"command\":\"quit\"}\n");
+      worker->process->closeWriteChannel();
+    }
+  }
+  for(Worker* worker : workers)
+  {
+    if(worker->process->state() != QProcess::NotRunning && !worker->process->waitForFinished(msecs))
+    {
+      worker->process->kill();
+      worker->process->waitForFinished(msecs);
+    }
+    delete worker->process;
+    delete worker;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorkerPool::dispatch()
+{
+  int starting = 0;
+  for(Worker* worker : m_Workers)
+  {
+    if(!worker->ready)
+    {
+      starting++;
+    }
+    else if(worker->jobId.isEmpty() && !m_Queue.isEmpty())
+    {
+      PipelineJob job = m_Queue.takeFirst();
+      QJsonObject request;
+      request["id"] = job.id;
+      request["pipeline"] = job.pipelineFile;
+      request["overrides"] = job.overrides;
+      if(job.checkpointFilters > 0)
+      {
+        QJsonObject checkpoint;
+        checkpoint["file"] = job.checkpointFile;
+        checkpoint["filters"] = job.checkpointFilters;
+        checkpoint["write"] = job.writeCheckpoint;
+        request["checkpoint"] = checkpoint;
+      }
+      if(!job.checkpointPolicy.isEmpty())
+      {
+        request["checkpoints"] = job.checkpointPolicy;
+      }
+      if(!job.snapshotCache.isEmpty())
+      {
+        request["snapshots"] = job.snapshotCache;
+      }
+      if(!job.resultCache.isEmpty())
+      {
+        request["resultCache"] = job.resultCache;
+      }
+      if(job.concurrentFilters > 1)
+      {
+        request["concurrentFilters"] = job.concurrentFilters;
+      }
+      if(job.threads > 0)
+      {
+        request["threads"] = job.threads;
+      }
+      if(job.bufferPoolMB > 0)
+      {
+        request["bufferPoolMB"] = job.bufferPoolMB;
+      }
+      if(job.releaseDeadArrays)
+      {
+        QJsonObject liveness;
+        liveness["spillDirectory"] = job.spillDirectory;
+        request["releaseDeadArrays"] = liveness;
+      }
+      if(!job.publishDirectory.isEmpty())
+      {
+        request["publish"] = job.publishDirectory;
+      }
+      worker->jobId = job.id;
+      worker->timer.start();
+      worker->process->write(QJsonDocument(request).toJson(QJsonDocument::Compact) + "\n");
+      emit jobStarted(job.id);
+    }
+  }
+
+  // Only start as many workers as there are jobs left that no starting worker will take
+  int needed = qMin(m_Queue.size() - starting, m_MaxWorkers - m_Workers.size());
+  needed = qMax(needed, m_MinWorkers - m_Workers.size());
+  for(int i = 0; i < needed; i++)
+  {
+    startWorker();
+  }
+
+  if(m_Busy && m_Queue.isEmpty() && runningJobCount() == 0)
+  {
+    m_Busy = false;
+    emit idle();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorkerPool::startWorker()
+{
+  Worker* worker = new Worker;
+  worker->process = new QProcess;
+  worker->process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+  m_Workers.push_back(worker);
+
+  connect(worker->process, &QProcess::readyReadStandardOutput, this, [=] { readWorkerOutput(worker); });
+  connect(worker->process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, [=](int exitCode, QProcess::ExitStatus) {
+    readWorkerOutput(worker);
+    removeWorker(worker, QString("The worker process exited unexpectedly with code %1").arg(exitCode));
+  });
+  connect(worker->process, &QProcess::errorOccurred, this, [=](QProcess::ProcessError error) {
+    if(error == QProcess::FailedToStart)
+    {
+      removeWorker(worker, QString("The worker process '%1' could not be started").arg(m_Program));
+    }
+  });
+
+  worker->process->start(m_Program, m_Arguments);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorkerPool::readWorkerOutput(Worker* worker)
+{
+  worker->buffer.append(worker->process->readAllStandardOutput());
+  int newline = worker->buffer.indexOf('\n');
+  while(newline >= 0)
+  {
+    QByteArray line = worker->buffer.left(newline);
+    worker->buffer.remove(0, newline + 1);
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+    if(parseError.error == QJsonParseError::NoError && doc.isObject())
+    {
+      handleEvent(worker, doc.object());
+    }
+    else
+    {
+      qDebug() << "PipelineWorkerPool: Ignoring unexpected worker output" << line;
+    }
+    newline = worker->buffer.indexOf('\n');
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorkerPool::handleEvent(Worker* worker, const QJsonObject& event)
+{
+  QString type = event["event"].toString();
+  if(type == "ready")
+  {
+    worker->ready = true;
+    dispatch();
+  }
+  else if(type == "message")
+  {
+    emit jobMessage(worker->jobId, event);
+  }
+  else if(type == "published")
+  {
+    emit jobPublished(worker->jobId, event["description"].toObject());
+  }
+  else if(type == "finished")
+  {
+    QString id = worker->jobId;
+    worker->jobId.clear();
+    emit jobFinished(id, event["error"].toInt(), static_cast<qint64>(event["elapsedMs"].toDouble()), event["errorText"].toString());
+    dispatch();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorkerPool::removeWorker(Worker* worker, const QString& reason)
+{
+  if(!m_Workers.contains(worker))
+  {
+    return;
+  }
+  m_Workers.removeAll(worker);
+  disconnect(worker->process, nullptr, this, nullptr);
+  worker->process->deleteLater();
+
+  if(!worker->jobId.isEmpty())
+  {
+    if(worker->canceled)
+    {
+      emit jobFinished(worker->jobId, k_Canceled, worker->timer.elapsed(), "The job was canceled");
+    }
+    else
+    {
+      emit jobFinished(worker->jobId, -1, worker->timer.elapsed(), reason);
+    }
+  }
+  else if(!worker->ready)
+  {
+    // A worker that cannot start or load its plugins would fail the same way again, so do not replace it
+    m_MinWorkers = qMin(m_MinWorkers, m_Workers.size());
+    if(m_Workers.isEmpty())
+    {
+      failQueuedJobs(reason);
+    }
+    else
+    {
+      m_MaxWorkers = m_Workers.size();
+      qDebug() << "PipelineWorkerPool:" << reason << "- continuing with" << m_MaxWorkers << "workers";
+    }
+  }
+  delete worker;
+  dispatch();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineWorkerPool::failQueuedJobs(const QString& reason)
+{
+  while(!m_Queue.isEmpty())
+  {
+    PipelineJob job = m_Queue.takeFirst();
+    emit jobFinished(job.id, -1, 0, reason);
+  }
+}
@@ -0,0 +1,205 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QProcess>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+/**
+ * @brief The PipelineJob struct describes one execution of a pipeline file. The overrides use the
+ * "<filter index>:<parameter name>" keys of PipelineExecutor::ApplyOverrides(). If 'checkpointFilters' is
+ * greater than zero the job either executes only that many filters and writes 'checkpointFile'
+ * ('writeCheckpoint') or starts from 'checkpointFile' and executes the rest, see PipelineCheckpoint.
+ * Jobs with a higher 'priority' are started first. If 'publishDirectory' is set the resulting
+ * DataContainerArray is published there, see SharedDataContainerArray. 'checkpointPolicy' is a
+ * PipelineCheckpointPolicy::toJson() object for checkpoints that a failed job can be resumed from, and
+ * 'snapshotCache' and 'resultCache' configure the PipelineSnapshotCache and PipelineResultCache of the
+ * worker that executes the job. 'concurrentFilters' is the number of independent filters that the worker
+ * may execute at the same time, see PipelineScheduler, and 'threads' is the number of threads the job may
+ * use, see ThreadBudget. 0 leaves it to SIMPL_NUM_THREADS or the number of cores. 'bufferPoolMB' is the
+ * size of the BufferPool of the job, 0 for none. With 'releaseDeadArrays' arrays are released as soon as no
+ * later filter reads them, and spilled to 'spillDirectory' until a later writer needs them, see PipelineLiveness.
+ */
+struct PipelineJob
+{
+  QString id;
+  QString pipelineFile;
+  QJsonObject overrides;
+  QString checkpointFile;
+  int checkpointFilters = 0;
+  bool writeCheckpoint = false;
+  int priority = 0;
+  QString publishDirectory;
+  QJsonObject checkpointPolicy;
+  QJsonObject snapshotCache;
+  QJsonObject resultCache;
+  int concurrentFilters = 1;
+  int threads = 0;
+  int bufferPoolMB = 0;
+  bool releaseDeadArrays = false;
+  QString spillDirectory;
+};
+
+/**
+ * @brief The PipelineWorkerPool class executes pipeline jobs in at most 'maxWorkers' worker processes that
+ * run a PipelineWorker. Each worker loads the plugins once when it starts and then executes one job after
+ * another, so the cost of loading the plugins is paid once per worker instead of once per job. Separate
+ * processes are used instead of threads because filters and the HDF5 library keep global state. A worker
+ * that crashes only fails the job it was executing and is replaced for the remaining jobs.
+ */
+class PipelineWorkerPool : public QObject
+{
+  Q_OBJECT
+
+public:
+  static const int k_Canceled = -100;
+
+  /**
+   * @brief PipelineWorkerPool
+   * @param program The worker executable
+   * @param arguments The arguments that put the executable into worker mode
+   * @param maxWorkers
+   * @param parent
+   */
+  PipelineWorkerPool(const QString& program, const QStringList& arguments, int maxWorkers, QObject* parent = nullptr);
+  ~PipelineWorkerPool() override;
+
+  /**
+   * @brief Queues a job after all queued jobs of the same or a higher priority. Workers are started as they
+   * are needed.
+   * @param job
+   */
+  void submit(const PipelineJob& job);
+
+  /**
+   * @brief Removes a queued job or kills the worker that executes it. jobFinished() is emitted for the job
+   * with the error k_Canceled.
+   * @param id
+   * @return false if the job is neither queued nor running
+   */
+  bool cancel(const QString& id);
+
+  /**
+   * @brief Keeps at least 'count' workers running even when no jobs are queued, so that a job submitted
+   * later does not wait for a worker to load its plugins
+   * @param count
+   */
+  void setMinimumWorkers(int count);
+
+  /**
+   * @brief Returns the number of jobs that wait for a worker
+   * @return
+   */
+  int queuedJobCount() const;
+
+  /**
+   * @brief Returns the number of jobs that are executing
+   * @return
+   */
+  int runningJobCount() const;
+
+  /**
+   * @brief Asks all workers to exit and waits up to 'msecs' for them before killing them
+   * @param msecs
+   */
+  void shutdown(int msecs = 5000);
+
+signals:
+  void jobStarted(const QString& id);
+
+  /**
+   * @brief Forwards a "message" event of a worker, see PipelineWorker::MessageToJson()
+   */
+  void jobMessage(const QString& id, const QJsonObject& message);
+
+  /**
+   * @brief Emitted before jobFinished() when a job with a 'publishDirectory' has published its results.
+   * 'description' is the argument for SharedDataContainerArray::Attach().
+   */
+  void jobPublished(const QString& id, const QJsonObject& description);
+
+  /**
+   * @brief Emitted once for every submitted job. 'error' is negative if the job failed.
+   */
+  void jobFinished(const QString& id, int error, qint64 elapsedMs, const QString& errorText);
+
+  /**
+   * @brief Emitted when the last queued job has finished
+   */
+  void idle();
+
+private:
+  struct Worker
+  {
+    QProcess* process = nullptr;
+    bool ready = false;
+    QString jobId;
+    bool canceled = false;
+    QElapsedTimer timer;
+    QByteArray buffer;
+  };
+
+  QString m_Program;
+  QStringList m_Arguments;
+  int m_MaxWorkers = 1;
+  int m_MinWorkers = 0;
+  bool m_Busy = false;
+  QList<PipelineJob> m_Queue;
+  QVector<Worker*> m_Workers;
+
+  /**
+   * @brief Hands queued jobs to idle workers and starts new workers while jobs are left
+   */
+  void dispatch();
+
+  void startWorker();
+  void readWorkerOutput(Worker* worker);
+  void handleEvent(Worker* worker, const QJsonObject& event);
+  void removeWorker(Worker* worker, const QString& reason);
+  void failQueuedJobs(const QString& reason);
+
+public:
+  PipelineWorkerPool(const PipelineWorkerPool&) = delete;            // Copy Constructor Not Implemented
+  PipelineWorkerPool(PipelineWorkerPool&&) = delete;                 // Move Constructor Not Implemented
+  PipelineWorkerPool& operator=(const PipelineWorkerPool&) = delete; // Copy Assignment Not Implemented
+  PipelineWorkerPool& operator=(PipelineWorkerPool&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,94 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+class FilterManager;
+class ISIMPLibPlugin;
+class QPluginLoader;
+
+/**
+ * @brief The SIMPLViewPluginLoader class holds the parts of finding and loading plugins that SIMPLView and the
+ * command line tools share. SIMPLView loads the ".guiplugin" libraries, which also register filter widgets,
+ * while the command line tools load the ".plugin" libraries, which only register filters.
+ */
+class SIMPLViewPluginLoader
+{
+public:
+  virtual ~SIMPLViewPluginLoader();
+
+  /**
+   * @brief Returns the directories that are searched for plugins: the application directory, the
+   * Plugins directory of a build tree or installation and the directories in SIMPL_PLUGIN_PATH. On
+   * Linux and macOS the working directory is changed to the installation root as well.
+   * @param applicationDirPath
+   * @return
+   */
+  static QStringList PluginDirectories(const QString& applicationDirPath);
+
+  /**
+   * @brief Returns the absolute paths of the plugin libraries in 'pluginDir'. Debug builds only find the
+   * "_debug" variants and release builds skip them.
+   * @param pluginDir
+   * @param extension The file extension without the dot, "guiplugin" or "plugin"
+   * @return
+   */
+  static QStringList FindPluginFiles(const QString& pluginDir, const QString& extension);
+
+  /**
+   * @brief Loads the plugin libraries, concurrently if 'parallel' is true, and registers their filters with
+   * 'filterManager' on the calling thread in the order of 'pluginFilePaths'. Filter widgets are not
+   * registered. The plugins are added to the PluginManager.
+   * @param pluginFilePaths
+   * @param filterManager
+   * @param parallel
+   * @param loaders Receives the loaders of the plugins that were loaded. They must outlive the plugins.
+   * @return
+   */
+  static QVector<ISIMPLibPlugin*> LoadPlugins(const QStringList& pluginFilePaths, FilterManager* filterManager, bool parallel, QVector<QPluginLoader*>& loaders);
+
+protected:
+  SIMPLViewPluginLoader();
+
+public:
+  SIMPLViewPluginLoader(const SIMPLViewPluginLoader&) = delete;            // Copy Constructor Not Implemented
+  SIMPLViewPluginLoader(SIMPLViewPluginLoader&&) = delete;                 // Move Constructor Not Implemented
+  SIMPLViewPluginLoader& operator=(const SIMPLViewPluginLoader&) = delete; // Copy Assignment Not Implemented
+  SIMPLViewPluginLoader& operator=(SIMPLViewPluginLoader&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,369 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "SharedDataContainerArray.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QMap>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+/**
+ * @brief The mapped files of a SharedDataContainerArray and the directory they are in
+ */
+struct SharedDataContainerArray::Mapping
+{
+  QString directory;
+  QVector<QFile*> files;
+
+  ~Mapping()
+  {
+    // Deleting the files unmaps them
+    qDeleteAll(files);
+    if(!directory.isEmpty())
+    {
+      QDir(directory).removeRecursively();
+    }
+  }
+};
+
+namespace
+{
+/**
+ * @brief Owns an array that wraps mapped memory together with the mapping, which is released after the array
+ */
+struct MappedArrayOwner
+{
+  std::shared_ptr<void> mapping;
+  IDataArray::Pointer array;
+};
+
+// -----------------------------------------------------------------------------
+// Returns the element size of the DataArray types that can be handed over, by their getTypeAsString()
+// -----------------------------------------------------------------------------
+size_t ElementSize(const QString& type)
+{
+  static const QMap<QString, size_t> sizes = {{"int8_t", sizeof(int8_t)},   {"uint8_t", sizeof(uint8_t)},   {"int16_t", sizeof(int16_t)}, {"uint16_t", sizeof(uint16_t)},
+                                              {"int32_t", sizeof(int32_t)}, {"uint32_t", sizeof(uint32_t)}, {"int64_t", sizeof(int64_t)}, {"uint64_t", sizeof(uint64_t)},
+                                              {"float", sizeof(float)},     {"double", sizeof(double)},     {"bool", sizeof(bool)}};
+  return sizes.value(type, 0);
+}
+
+// -----------------------------------------------------------------------------
+// Wraps memory that the array must not free, or allocates an empty array if there is no memory
+// -----------------------------------------------------------------------------
+template <typename T>
+IDataArray::Pointer CreateArray(void* data, size_t numTuples, const QVector<size_t>& cDims, const QString& name)
+{
+  if(nullptr == data)
+  {
+    return DataArray<T>::CreateArray(numTuples, cDims, name, true);
+  }
+  return DataArray<T>::WrapPointer(static_cast<T*>(data), numTuples, cDims, name, false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer CreateArray(const QString& type, void* data, size_t numTuples, const QVector<size_t>& cDims, const QString& name)
+{
+  if(type == "int8_t")
+  {
+    return CreateArray<int8_t>(data, numTuples, cDims, name);
+  }
+  if(type == "uint8_t")
+  {
+    return CreateArray<uint8_t>(data, numTuples, cDims, name);
+  }
+  if(type == "int16_t")
+  {
+    return CreateArray<int16_t>(data, numTuples, cDims, name);
+  }
+  if(type == "uint16_t")
+  {
+    return CreateArray<uint16_t>(data, numTuples, cDims, name);
+  }
+  if(type == "int32_t")
+  {
+    return CreateArray<int32_t>(data, numTuples, cDims, name);
+  }
+  if(type == "uint32_t")
+  {
+    return CreateArray<uint32_t>(data, numTuples, cDims, name);
+  }
+  if(type == "int64_t")
+  {
+    return CreateArray<int64_t>(data, numTuples, cDims, name);
+  }
+  if(type == "uint64_t")
+  {
+    return CreateArray<uint64_t>(data, numTuples, cDims, name);
+  }
+  if(type == "float")
+  {
+    return CreateArray<float>(data, numTuples, cDims, name);
+  }
+  if(type == "double")
+  {
+    return CreateArray<double>(data, numTuples, cDims, name);
+  }
+  if(type == "bool")
+  {
+    return CreateArray<bool>(data, numTuples, cDims, name);
+  }
+  return IDataArray::NullPointer();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonArray DimsToJson(const QVector<size_t>& dims)
+{
+  QJsonArray array;
+  for(size_t dim : dims)
+  {
+    array.append(static_cast<double>(dim));
+  }
+  return array;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<size_t> DimsFromJson(const QJsonArray& array)
+{
+  QVector<size_t> dims;
+  for(const QJsonValue& value : array)
+  {
+    dims.push_back(static_cast<size_t>(value.toDouble()));
+  }
+  return dims;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SharedDataContainerArray::SharedDataContainerArray() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SharedDataContainerArray::~SharedDataContainerArray() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject SharedDataContainerArray::Publish(DataContainerArray::Pointer dca, const QString& directory, QString& errorMessage)
+{
+  QDir dir(directory);
+  int fileCount = 0;
+  QJsonArray containers;
+  for(DataContainer::Pointer dc : dca->getDataContainers())
+  {
+    QJsonObject container;
+    container["name"] = dc->getName();
+
+    IGeometry::Pointer geometry = dc->getGeometry();
+    if(nullptr != geometry.get())
+    {
+      QJsonObject geom;
+      geom["name"] = geometry->getName();
+      geom["type"] = geometry->getGeometryTypeAsString();
+      ImageGeom::Pointer image = std::dynamic_pointer_cast<ImageGeom>(geometry);
+      if(nullptr != image.get())
+      {
+        size_t dims[3] = {0, 0, 0};
+        float resolution[3] = {0.0f, 0.0f, 0.0f};
+        float origin[3] = {0.0f, 0.0f, 0.0f};
+        image->getDimensions(dims);
+        image->getResolution(resolution);
+        image->getOrigin(origin);
+        geom["dimensions"] = QJsonArray({static_cast<double>(dims[0]), static_cast<double>(dims[1]), static_cast<double>(dims[2])});
+        geom["resolution"] = QJsonArray({resolution[0], resolution[1], resolution[2]});
+        geom["origin"] = QJsonArray({origin[0], origin[1], origin[2]});
+      }
+      container["geometry"] = geom;
+    }
+
+    QJsonArray matrices;
+    for(AttributeMatrix::Pointer am : dc->getAttributeMatrices())
+    {
+      QJsonObject matrix;
+      matrix["name"] = am->getName();
+      matrix["type"] = static_cast<int>(am->getType());
+      matrix["tupleDimensions"] = DimsToJson(am->getTupleDimensions());
+
+      QJsonArray arrays;
+      for(const QString& arrayName : am->getAttributeArrayNames())
+      {
+        IDataArray::Pointer array = am->getAttributeArray(arrayName);
+        QJsonObject arrayObj;
+        arrayObj["name"] = arrayName;
+        arrayObj["type"] = array->getTypeAsString();
+        arrayObj["numberOfTuples"] = static_cast<double>(array->getNumberOfTuples());
+        arrayObj["componentDimensions"] = DimsToJson(array->getComponentDimensions());
+
+        size_t elementSize = ElementSize(array->getTypeAsString());
+        arrayObj["shared"] = elementSize > 0;
+        if(elementSize == 0)
+        {
+          arrays.append(arrayObj);
+          continue;
+        }
+
+        qint64 bytes = static_cast<qint64>(array->getNumberOfTuples() * array->getNumberOfComponents() * elementSize);
+        if(bytes > 0)
+        {
+          QString fileName = QString("%1.bin").arg(fileCount++);
+          QFile file(dir.filePath(fileName));
+          if(!file.open(QIODevice::WriteOnly) || file.write(static_cast<const char*>(array->getVoidPointer(0)), bytes) != bytes)
+          {
+            errorMessage = QString("The array '%1' could not be written to '%2': %3").arg(arrayName).arg(file.fileName()).arg(file.errorString());
+            return QJsonObject();
+          }
+          arrayObj["file"] = fileName;
+        }
+
+        // Free the array right away so the worker never holds more than one extra array
+        am->removeAttributeArray(arrayName);
+        array.reset();
+        arrays.append(arrayObj);
+      }
+      matrix["arrays"] = arrays;
+      matrices.append(matrix);
+    }
+    container["attributeMatrices"] = matrices;
+    containers.append(container);
+  }
+
+  QJsonObject description;
+  description["dataContainers"] = containers;
+  return description;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SharedDataContainerArray::Pointer SharedDataContainerArray::Attach(const QJsonObject& description, const QString& directory, QString& errorMessage)
+{
+  Pointer shared(new SharedDataContainerArray);
+  shared->m_Mapping = std::make_shared<Mapping>();
+  shared->m_Mapping->directory = directory;
+  shared->m_DataContainerArray = DataContainerArray::New();
+  QDir dir(directory);
+
+  for(const QJsonValue& containerValue : description["dataContainers"].toArray())
+  {
+    QJsonObject container = containerValue.toObject();
+    DataContainer::Pointer dc = DataContainer::New(container["name"].toString());
+
+    QJsonObject geom = container["geometry"].toObject();
+    if(geom.contains("dimensions"))
+    {
+      QJsonArray dims = geom["dimensions"].toArray();
+      QJsonArray resolution = geom["resolution"].toArray();
+      QJsonArray origin = geom["origin"].toArray();
+      ImageGeom::Pointer image = ImageGeom::CreateGeometry(geom["name"].toString());
+      image->setDimensions(static_cast<size_t>(dims[0].toDouble()), static_cast<size_t>(dims[1].toDouble()), static_cast<size_t>(dims[2].toDouble()));
+      image->setResolution(static_cast<float>(resolution[0].toDouble()), static_cast<float>(resolution[1].toDouble()), static_cast<float>(resolution[2].toDouble()));
+      image->setOrigin(static_cast<float>(origin[0].toDouble()), static_cast<float>(origin[1].toDouble()), static_cast<float>(origin[2].toDouble()));
+      dc->setGeometry(image);
+    }
+    shared->m_DataContainerArray->addDataContainer(dc);
+
+    for(const QJsonValue& matrixValue : container["attributeMatrices"].toArray())
+    {
+      QJsonObject matrix = matrixValue.toObject();
+      QString matrixName = matrix["name"].toString();
+      AttributeMatrix::Pointer am =
+          AttributeMatrix::New(DimsFromJson(matrix["tupleDimensions"].toArray()), matrixName, static_cast<AttributeMatrix::Type>(matrix["type"].toInt()));
+      dc->addAttributeMatrix(matrixName, am);
+
+      for(const QJsonValue& arrayValue : matrix["arrays"].toArray())
+      {
+        QJsonObject arrayObj = arrayValue.toObject();
+        if(!arrayObj["shared"].toBool())
+        {
+          continue;
+        }
+        QString type = arrayObj["type"].toString();
+        size_t numTuples = static_cast<size_t>(arrayObj["numberOfTuples"].toDouble());
+        QVector<size_t> cDims = DimsFromJson(arrayObj["componentDimensions"].toArray());
+
+        void* data = nullptr;
+        if(arrayObj.contains("file"))
+        {
+          QFile* file = new QFile(dir.filePath(arrayObj["file"].toString()));
+          shared->m_Mapping->files.push_back(file);
+          size_t components = 1;
+          for(size_t cDim : cDims)
+          {
+            components *= cDim;
+          }
+          qint64 bytes = static_cast<qint64>(numTuples * components * ElementSize(type));
+          data = file->open(QIODevice::ReadWrite) && file->size() == bytes ? file->map(0, bytes) : nullptr;
+          if(nullptr == data)
+          {
+            errorMessage = QString("The array '%1' could not be mapped from '%2'").arg(arrayObj["name"].toString()).arg(file->fileName());
+            return NullPointer();
+          }
+        }
+        IDataArray::Pointer array = CreateArray(type, data, numTuples, cDims, arrayObj["name"].toString());
+        if(nullptr != data && nullptr != array.get())
+        {
+          // The Data Browser and other holders of the array may outlive this object, so the array keeps the mapping
+          std::shared_ptr<MappedArrayOwner> owner(new MappedArrayOwner{shared->m_Mapping, array});
+          array = IDataArray::Pointer(owner, array.get());
+        }
+        am->addAttributeArray(arrayObj["name"].toString(), array);
+      }
+    }
+  }
+  return shared;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArray::Pointer SharedDataContainerArray::getDataContainerArray() const
+{
+  return m_DataContainerArray;
+}
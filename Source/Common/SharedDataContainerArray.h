@@ -0,0 +1,107 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <memory>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+/**
+ * @brief The SharedDataContainerArray class hands the DataContainerArray of a finished pipeline from a worker
+ * process to SIMPLView without sending the array contents through a pipe or reading an output file again.
+ *
+ * The worker calls Publish(), which writes the contents of every numeric array to its own file in a
+ * directory that the receiving process chose (on Linux a directory in /dev/shm, so the files are shared
+ * memory) and frees each array right after it was written. Publish() returns a JSON description of the
+ * data containers, geometries, attribute matrices and arrays. The receiving process calls Attach() with
+ * that description. It memory maps the files and wraps the mapped memory in DataArrays that do not own it,
+ * so the contents are only paged in when they are looked at. The files and mappings live as long as the
+ * SharedDataContainerArray or any of its arrays, so the arrays stay valid wherever they are held.
+ *
+ * Image geometries are rebuilt. Other geometries and arrays that are not plain numeric DataArrays
+ * (strings, neighbor lists, statistics) are listed in the description but not handed over.
+ */
+class SharedDataContainerArray
+{
+public:
+  SIMPL_SHARED_POINTERS(SharedDataContainerArray)
+
+  virtual ~SharedDataContainerArray();
+
+  /**
+   * @brief Writes the arrays of 'dca' to 'directory' and removes them from 'dca'
+   * @param dca
+   * @param directory
+   * @param errorMessage
+   * @return The description for Attach(), empty if an array could not be written
+   */
+  static QJsonObject Publish(DataContainerArray::Pointer dca, const QString& directory, QString& errorMessage);
+
+  /**
+   * @brief Rebuilds a published DataContainerArray on top of memory mapped files
+   * @param description
+   * @param directory
+   * @param errorMessage
+   * @return A null pointer if a file could not be mapped
+   */
+  static Pointer Attach(const QJsonObject& description, const QString& directory, QString& errorMessage);
+
+  /**
+   * @brief Returns the rebuilt DataContainerArray. Its arrays keep the mapped files alive.
+   * @return
+   */
+  DataContainerArray::Pointer getDataContainerArray() const;
+
+protected:
+  SharedDataContainerArray();
+
+private:
+  struct Mapping;
+
+  DataContainerArray::Pointer m_DataContainerArray;
+  std::shared_ptr<Mapping> m_Mapping;
+
+public:
+  SharedDataContainerArray(const SharedDataContainerArray&) = delete;            // Copy Constructor Not Implemented
+  SharedDataContainerArray(SharedDataContainerArray&&) = delete;                 // Move Constructor Not Implemented
+  SharedDataContainerArray& operator=(const SharedDataContainerArray&) = delete; // Copy Assignment Not Implemented
+  SharedDataContainerArray& operator=(SharedDataContainerArray&&) = delete;      // Move Assignment Not Implemented
+};
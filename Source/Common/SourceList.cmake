@@ -3,6 +3,39 @@ set(AppsCommon_Widgets_HDRS "")
 set(AppsCommon_Widgets_SRCS "")
 set(AppsCommon_Widgets_UIS "")
 
+# --------------------------------------------------------------------
+# List the Classes here that do NOT depend on QtWidgets. These are shared
+# between SIMPLView and the command line tools.
+set(APPS_CORE
+  BufferPool
+  FilterDataUsage
+  PipelineCheckpoint
+  PipelineExecutor
+  PipelineLiveness
+  PipelineResultCache
+  PipelineScheduler
+  PipelineService
+  PipelineSnapshotCache
+  PipelineWorker
+  PipelineWorkerPool
+  SharedDataContainerArray
+  SIMPLViewPluginLoader
+  ThreadBudget
+)
+
+set(AppsCommon_Core_HDRS "")
+set(AppsCommon_Core_SRCS "")
+foreach(FPW ${APPS_CORE})
+  set(AppsCommon_Core_HDRS ${AppsCommon_Core_HDRS}
+    ${SIMPLViewProj_SOURCE_DIR}/Source/Common/${FPW}.h
+    )
+  set(AppsCommon_Core_SRCS ${AppsCommon_Core_SRCS}
+    ${SIMPLViewProj_SOURCE_DIR}/Source/Common/${FPW}.cpp
+    )
+endforeach()
+
+cmp_IDE_SOURCE_PROPERTIES( "Applications/Common" "${AppsCommon_Core_HDRS}" "${AppsCommon_Core_SRCS}" "0")
+
 
 # --------------------------------------------------------------------
 # List the Classes here that are QWidget Derived Classes
@@ -0,0 +1,130 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ThreadBudget.h"
+
+#include <QtCore/QThread>
+#include <QtCore/QtGlobal>
+
+#include "SIMPLib/SIMPLib.h"
+
+#if SIMPL_USE_PARALLEL_ALGORITHMS
+#define TBB_PREVIEW_GLOBAL_CONTROL 1
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+#endif
+
+#if SIMPL_USE_PARALLEL_ALGORITHMS
+struct ThreadBudget::Arena
+{
+  explicit Arena(int threads)
+  : arena(threads)
+  {
+  }
+  tbb::task_arena arena;
+};
+
+namespace
+{
+std::unique_ptr<tbb::global_control> s_ProcessLimit;
+}
+#else
+struct ThreadBudget::Arena
+{
+};
+#endif
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::ThreadBudget(int threads)
+: m_Threads(threads > 0 ? threads : DefaultThreads())
+{
+#if SIMPL_USE_PARALLEL_ALGORITHMS
+  m_Arena.reset(new Arena(m_Threads));
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ThreadBudget::~ThreadBudget() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ThreadBudget::DefaultThreads()
+{
+  bool ok = false;
+  int threads = qEnvironmentVariableIntValue("SIMPL_NUM_THREADS", &ok);
+  if(ok && threads > 0)
+  {
+    return threads;
+  }
+  return qMax(1, QThread::idealThreadCount());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadBudget::LimitProcess(int threads)
+{
+#if SIMPL_USE_PARALLEL_ALGORITHMS
+  s_ProcessLimit.reset();
+  s_ProcessLimit.reset(new tbb::global_control(tbb::global_control::max_allowed_parallelism, static_cast<size_t>(threads > 0 ? threads : DefaultThreads())));
+#else
+  Q_UNUSED(threads)
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int ThreadBudget::getThreads() const
+{
+  return m_Threads;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ThreadBudget::execute(const std::function<void()>& function)
+{
+#if SIMPL_USE_PARALLEL_ALGORITHMS
+  m_Arena->arena.execute(function);
+#else
+  function();
+#endif
+}
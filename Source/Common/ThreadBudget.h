@@ -0,0 +1,96 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+/**
+ * @brief The ThreadBudget class limits how many threads the parallel algorithms of the filters use. The
+ * filters parallelize with TBB, so a budget is a tbb::task_arena with that many slots, and everything that
+ * executes through execute() shares those threads no matter how many threads call it. Without
+ * SIMPL_USE_PARALLEL_ALGORITHMS the filters are serial and execute() just calls the function.
+ *
+ * The budget of a run is the first of: the value given for the run, the SIMPL_NUM_THREADS environment
+ * variable and the number of cores.
+ */
+class ThreadBudget
+{
+public:
+  /**
+   * @brief ThreadBudget
+   * @param threads The number of threads, or 0 for DefaultThreads()
+   */
+  explicit ThreadBudget(int threads = 0);
+  ~ThreadBudget();
+
+  /**
+   * @brief Returns SIMPL_NUM_THREADS if it is set to a positive number, otherwise the number of cores
+   * @return
+   */
+  static int DefaultThreads();
+
+  /**
+   * @brief Caps the threads of all parallel algorithms in this process, including the ones that do not
+   * execute through a ThreadBudget, for the rest of its lifetime. Later calls change the cap.
+   * @param threads The number of threads, or 0 for DefaultThreads()
+   */
+  static void LimitProcess(int threads);
+
+  /**
+   * @brief Returns the number of threads of this budget
+   * @return
+   */
+  int getThreads() const;
+
+  /**
+   * @brief Calls 'function' so that the parallel algorithms it starts use the threads of this budget
+   * @param function
+   */
+  void execute(const std::function<void()>& function);
+
+private:
+  struct Arena;
+
+  int m_Threads = 1;
+  std::unique_ptr<Arena> m_Arena;
+
+public:
+  ThreadBudget(const ThreadBudget&) = delete;            // Copy Constructor Not Implemented
+  ThreadBudget(ThreadBudget&&) = delete;                 // Move Constructor Not Implemented
+  ThreadBudget& operator=(const ThreadBudget&) = delete; // Copy Assignment Not Implemented
+  ThreadBudget& operator=(ThreadBudget&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,248 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "DeferredPlugin.h"
+
+#include "SIMPLView/LazyPluginRegistry.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DeferredPlugin::DeferredPlugin(const PluginManifest::PluginEntry& entry)
+: m_Entry(entry)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DeferredPlugin::~DeferredPlugin() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredPlugin::setPlugin(ISIMPLibPlugin* plugin)
+{
+  m_Plugin = plugin;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ISIMPLibPlugin* DeferredPlugin::plugin()
+{
+  if(nullptr == m_Plugin)
+  {
+    LazyPluginRegistry::Instance()->activatePlugin(m_Entry.filePath);
+  }
+  return m_Plugin;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getPluginFileName()
+{
+  return m_Entry.pluginName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getPluginDisplayName()
+{
+  return m_Entry.displayName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getPluginBaseName()
+{
+  return m_Entry.baseName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getVersion()
+{
+  return m_Entry.version;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getCompatibilityVersion()
+{
+  return m_Entry.compatibilityVersion;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getVendor()
+{
+  return m_Entry.vendor;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getURL()
+{
+  return m_Entry.url;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getLocation()
+{
+  return m_Entry.filePath;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getDescription()
+{
+  return m_Entry.description;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getCopyright()
+{
+  return m_Entry.copyright;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DeferredPlugin::getLicense()
+{
+  return m_Entry.license;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QList<QString> DeferredPlugin::getFilters()
+{
+  QList<QString> filters;
+  for(const PluginManifest::FilterEntry& filterEntry : m_Entry.filters)
+  {
+    filters.push_back(filterEntry.className);
+  }
+  return filters;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QMap<QString, QString> DeferredPlugin::getThirdPartyLicenses()
+{
+  ISIMPLibPlugin* realPlugin = plugin();
+  return nullptr != realPlugin ? realPlugin->getThirdPartyLicenses() : QMap<QString, QString>();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool DeferredPlugin::getDidLoad()
+{
+  // The filters of the plugin are registered, which is what a loaded plugin means to the rest of the application
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredPlugin::setDidLoad(bool didLoad)
+{
+  Q_UNUSED(didLoad)
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredPlugin::setLocation(QString filePath)
+{
+  Q_UNUSED(filePath)
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredPlugin::registerFilterWidgets(FilterWidgetManager* fwm)
+{
+  // LazyPluginRegistry registers the widgets of the real plugin when it loads it
+  Q_UNUSED(fwm)
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredPlugin::registerFilters(FilterManager* fm)
+{
+  // The proxy factories of LazyPluginRegistry::addPlugin() stand for the filters until the plugin is loaded
+  Q_UNUSED(fm)
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredPlugin::writeSettings(QSettings& prefs)
+{
+  // A plugin that was never loaded has not changed its settings
+  if(nullptr != m_Plugin)
+  {
+    m_Plugin->writeSettings(prefs);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void DeferredPlugin::readSettings(QSettings& prefs)
+{
+  if(nullptr != m_Plugin)
+  {
+    m_Plugin->readSettings(prefs);
+  }
+}
@@ -0,0 +1,99 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <QtCore/QSettings>
+
+#include "SIMPLib/Plugin/ISIMPLibPlugin.h"
+
+#include "SIMPLView/PluginManifest.h"
+
+/**
+ * @brief The DeferredPlugin class is the PluginManager entry of a plugin that was registered from the plugin
+ * manifest and has not been loaded yet, so that About Plugins and the plugin load preferences list it. It
+ * answers the descriptive queries from the manifest. Once LazyPluginRegistry loaded the plugin it forwards
+ * everything else to the real plugin; before that, queries that the manifest can not answer load the plugin.
+ */
+class DeferredPlugin : public ISIMPLibPlugin
+{
+public:
+  DeferredPlugin(const PluginManifest::PluginEntry& entry);
+  ~DeferredPlugin() override;
+
+  /**
+   * @brief Sets the plugin that was loaded for this entry
+   * @param plugin
+   */
+  void setPlugin(ISIMPLibPlugin* plugin);
+
+  QString getPluginFileName() override;
+  QString getPluginDisplayName() override;
+  QString getPluginBaseName() override;
+  QString getVersion() override;
+  QString getCompatibilityVersion() override;
+  QString getVendor() override;
+  QString getURL() override;
+  QString getLocation() override;
+  QString getDescription() override;
+  QString getCopyright() override;
+  QString getLicense() override;
+  QList<QString> getFilters() override;
+  QMap<QString, QString> getThirdPartyLicenses() override;
+  bool getDidLoad() override;
+  void setDidLoad(bool didLoad) override;
+  void setLocation(QString filePath) override;
+  void registerFilterWidgets(FilterWidgetManager* fwm) override;
+  void registerFilters(FilterManager* fm) override;
+  void writeSettings(QSettings& prefs) override;
+  void readSettings(QSettings& prefs) override;
+
+private:
+  PluginManifest::PluginEntry m_Entry;
+  ISIMPLibPlugin* m_Plugin = nullptr;
+
+  /**
+   * @brief Returns the real plugin, loading it first if needed
+   * @return A null pointer if the plugin could not be loaded
+   */
+  ISIMPLibPlugin* plugin();
+
+public:
+  DeferredPlugin(const DeferredPlugin&) = delete;            // Copy Constructor Not Implemented
+  DeferredPlugin(DeferredPlugin&&) = delete;                 // Move Constructor Not Implemented
+  DeferredPlugin& operator=(const DeferredPlugin&) = delete; // Copy Assignment Not Implemented
+  DeferredPlugin& operator=(DeferredPlugin&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,178 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "LazyPluginRegistry.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QThread>
+
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Plugin/ISIMPLibPlugin.h"
+#include "SIMPLib/Plugin/PluginManager.h"
+
+#include "SVWidgetsLib/Core/FilterWidgetManager.h"
+
+#include "SIMPLView/DeferredPlugin.h"
+#include "SIMPLView/ProxyFilterFactory.h"
+
+LazyPluginRegistry* LazyPluginRegistry::self = nullptr;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+LazyPluginRegistry::LazyPluginRegistry()
+: m_Mutex(QMutex::Recursive)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+LazyPluginRegistry::~LazyPluginRegistry()
+{
+  for(int i = 0; i < m_PluginLoaders.size(); i++)
+  {
+    delete m_PluginLoaders[i];
+  }
+  qDeleteAll(m_DeferredPlugins);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+LazyPluginRegistry* LazyPluginRegistry::Instance()
+{
+  if(self == nullptr)
+  {
+    self = new LazyPluginRegistry();
+  }
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void LazyPluginRegistry::addPlugin(const PluginManifest::PluginEntry& entry)
+{
+  QMutexLocker locker(&m_Mutex);
+
+  FilterManager* filterManager = FilterManager::Instance();
+  for(const PluginManifest::FilterEntry& filterEntry : entry.filters)
+  {
+    filterManager->addFilterFactory(filterEntry.className, ProxyFilterFactory::New(filterEntry, entry.filePath));
+    m_FilterToPluginPath.insert(filterEntry.className, entry.filePath);
+  }
+  m_PendingPlugins.insert(entry.filePath, entry);
+
+  // About Plugins and the plugin load preferences list what the PluginManager knows
+  DeferredPlugin* deferredPlugin = new DeferredPlugin(entry);
+  m_DeferredPlugins.insert(entry.filePath, deferredPlugin);
+  PluginManager::Instance()->addPlugin(deferredPlugin);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IFilterFactory::Pointer LazyPluginRegistry::activatePluginForFilter(const QString& filterClassName)
+{
+  QString pluginPath;
+  {
+    QMutexLocker locker(&m_Mutex);
+    pluginPath = m_FilterToPluginPath.value(filterClassName);
+  }
+  if(!pluginPath.isEmpty())
+  {
+    activatePlugin(pluginPath);
+  }
+  return FilterManager::Instance()->getFactoryFromClassName(filterClassName);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool LazyPluginRegistry::activatePlugin(const QString& pluginPath)
+{
+  // The mutex is not held while waiting, so the GUI thread can take it to load the plugin
+  if(QThread::currentThread() != thread())
+  {
+    bool loaded = false;
+    QMetaObject::invokeMethod(this, "activatePlugin", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, loaded), Q_ARG(QString, pluginPath));
+    return loaded;
+  }
+
+  QMutexLocker locker(&m_Mutex);
+
+  if(!m_PendingPlugins.contains(pluginPath))
+  {
+    return true;
+  }
+  PluginManifest::PluginEntry entry = m_PendingPlugins.take(pluginPath);
+  for(const PluginManifest::FilterEntry& filterEntry : entry.filters)
+  {
+    m_FilterToPluginPath.remove(filterEntry.className);
+  }
+
+  qDebug() << "Plugin Being Loaded On Demand:" << pluginPath;
+  QPluginLoader* loader = new QPluginLoader(pluginPath);
+  QObject* plugin = loader->instance();
+  ISIMPLibPlugin* ipPlugin = qobject_cast<ISIMPLibPlugin*>(plugin);
+  if(nullptr == ipPlugin)
+  {
+    qDebug() << "The plugin did not load with the following error: " << loader->errorString();
+    delete loader;
+    return false;
+  }
+
+  // The plugin's own factories replace the proxies that were registered under the same class names. The
+  // DeferredPlugin stays in the PluginManager and forwards to the plugin from now on.
+  ipPlugin->registerFilterWidgets(FilterWidgetManager::Instance());
+  ipPlugin->registerFilters(FilterManager::Instance());
+  ipPlugin->setDidLoad(true);
+  ipPlugin->setLocation(pluginPath);
+  m_DeferredPlugins.value(pluginPath)->setPlugin(ipPlugin);
+
+  m_PluginLoaders.push_back(loader);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int LazyPluginRegistry::pendingPluginCount() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_PendingPlugins.size();
+}
@@ -0,0 +1,118 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Filtering/IFilterFactory.hpp"
+
+#include "SIMPLView/PluginManifest.h"
+
+class QPluginLoader;
+class DeferredPlugin;
+
+/**
+ * @brief The LazyPluginRegistry class keeps track of the plugins whose filters were registered from the
+ * plugin manifest with ProxyFilterFactory instances instead of by loading the plugin. A plugin is loaded and
+ * registered for real the first time one of its filters is created or its documentation is shown. Until then a
+ * DeferredPlugin stands for it in the PluginManager.
+ *
+ * Plugins are always loaded on the GUI thread, which owns the registry, because their root objects and filter
+ * widgets belong there. Calls from other threads, such as ProxyFilterFactory::create() in a pipeline thread,
+ * block until the GUI thread has loaded the plugin.
+ */
+class LazyPluginRegistry : public QObject
+{
+  Q_OBJECT
+
+public:
+  ~LazyPluginRegistry() override;
+
+  /**
+   * @brief Returns the singleton instance
+   * @return
+   */
+  static LazyPluginRegistry* Instance();
+
+  /**
+   * @brief Registers proxy factories with the FilterManager for every filter in the manifest entry and a
+   * DeferredPlugin with the PluginManager
+   * @param entry
+   */
+  void addPlugin(const PluginManifest::PluginEntry& entry);
+
+  /**
+   * @brief Loads the plugin that provides 'filterClassName' if it has not been loaded yet
+   * @param filterClassName
+   * @return The factory that is registered for the filter after the plugin was loaded
+   */
+  IFilterFactory::Pointer activatePluginForFilter(const QString& filterClassName);
+
+  /**
+   * @brief Loads the plugin at 'pluginPath' on the GUI thread and registers its filters and filter widgets
+   * @param pluginPath
+   * @return True if the plugin was loaded, either now or earlier
+   */
+  Q_INVOKABLE bool activatePlugin(const QString& pluginPath);
+
+  /**
+   * @brief Returns the number of plugins that are still waiting to be loaded
+   * @return
+   */
+  int pendingPluginCount() const;
+
+protected:
+  LazyPluginRegistry();
+
+private:
+  static LazyPluginRegistry* self;
+
+  mutable QMutex m_Mutex;
+  QHash<QString, PluginManifest::PluginEntry> m_PendingPlugins;
+  QHash<QString, QString> m_FilterToPluginPath;
+  QHash<QString, DeferredPlugin*> m_DeferredPlugins;
+  QVector<QPluginLoader*> m_PluginLoaders;
+
+public:
+  LazyPluginRegistry(const LazyPluginRegistry&) = delete;            // Copy Constructor Not Implemented
+  LazyPluginRegistry(LazyPluginRegistry&&) = delete;                 // Move Constructor Not Implemented
+  LazyPluginRegistry& operator=(const LazyPluginRegistry&) = delete; // Copy Assignment Not Implemented
+  LazyPluginRegistry& operator=(LazyPluginRegistry&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,395 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineJobScheduler.h"
+
+#include <QtCore/QTimer>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+#include "SVWidgetsLib/QtSupport/QtSSettings.h"
+
+#include "Common/ThreadBudget.h"
+
+namespace
+{
+const int k_FinishedHistory = 50;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineJobScheduler::PipelineJobScheduler(QObject* parent)
+: QObject(parent)
+{
+  readSettings();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineJobScheduler::~PipelineJobScheduler() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineJobScheduler::ThreadsPerPipelineFromPreferences()
+{
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  int threads = prefs.value("Threads Per Pipeline", QVariant(qMax(1, ThreadBudget::DefaultThreads() / 2))).toInt();
+  prefs.endGroup();
+  return qMax(1, threads);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 PipelineJobScheduler::EstimatePeakBytes(const QVector<AbstractFilter::Pointer>& filters)
+{
+  qint64 peak = 0;
+  for(AbstractFilter::Pointer filter : filters)
+  {
+    DataContainerArray::Pointer dca = nullptr != filter.get() ? filter->getDataContainerArray() : DataContainerArray::NullPointer();
+    if(nullptr == dca.get() || !filter->getEnabled())
+    {
+      continue;
+    }
+    // The preflight does not allocate the arrays, so their size comes from the tuples of the attribute matrix
+    qint64 bytes = 0;
+    for(DataContainer::Pointer dc : dca->getDataContainers())
+    {
+      for(AttributeMatrix::Pointer am : dc->getAttributeMatrices())
+      {
+        for(const QString& arrayName : am->getAttributeArrayNames())
+        {
+          IDataArray::Pointer array = am->getAttributeArray(arrayName);
+          bytes += static_cast<qint64>(am->getNumberOfTuples()) * array->getNumberOfComponents() * array->getTypeSize();
+        }
+      }
+    }
+    peak = qMax(peak, bytes);
+  }
+  return peak;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobScheduler::readSettings()
+{
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  m_MaxThreads = qMax(1, prefs.value("Maximum Pipeline Threads", QVariant(ThreadBudget::DefaultThreads())).toInt());
+  m_MaxMemoryBytes = prefs.value("Maximum Pipeline Memory (MB)", QVariant(0)).toLongLong() * 1024 * 1024;
+  prefs.endGroup();
+  // The pipelines that run in this process share the threads of the parallel algorithms
+  ThreadBudget::LimitProcess(m_MaxThreads);
+  scheduleAdmit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineJobScheduler::getMaxThreads() const
+{
+  return m_MaxThreads;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 PipelineJobScheduler::getMaxMemoryBytes() const
+{
+  return m_MaxMemoryBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineJobScheduler::getUsedThreads() const
+{
+  int threads = 0;
+  for(const Entry& entry : m_Entries)
+  {
+    if(entry.job.state == JobState::Running)
+    {
+      threads += entry.job.threads;
+    }
+  }
+  return threads;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 PipelineJobScheduler::getUsedMemoryBytes() const
+{
+  qint64 bytes = 0;
+  for(const Entry& entry : m_Entries)
+  {
+    if(entry.job.state == JobState::Running)
+    {
+      bytes += entry.job.memoryBytes;
+    }
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineJobScheduler::submit(const QString& title, int priority, int threads, qint64 memoryBytes, QObject* owner, std::function<void()> start)
+{
+  Entry entry;
+  entry.job.id = m_NextId++;
+  entry.job.title = title;
+  entry.job.priority = priority;
+  entry.job.threads = qMax(1, threads);
+  entry.job.memoryBytes = memoryBytes;
+  entry.job.submitted = QDateTime::currentDateTime();
+  entry.owner = owner;
+  entry.start = start;
+  m_Entries.push_back(entry);
+  emit jobsChanged();
+  scheduleAdmit();
+  return entry.job.id;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobScheduler::finish(int id, int error)
+{
+  for(Entry& entry : m_Entries)
+  {
+    if(entry.job.id == id && (entry.job.state == JobState::Running || entry.job.state == JobState::Queued))
+    {
+      entry.job.state = error < 0 ? JobState::Failed : JobState::Finished;
+      entry.job.finished = QDateTime::currentDateTime();
+      entry.start = nullptr;
+      pruneFinished();
+      emit jobsChanged();
+      scheduleAdmit();
+      return;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineJobScheduler::isQueued(int id) const
+{
+  for(const Entry& entry : m_Entries)
+  {
+    if(entry.job.id == id)
+    {
+      return entry.job.state == JobState::Queued;
+    }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<PipelineJobScheduler::Job> PipelineJobScheduler::getJobs() const
+{
+  QVector<Job> jobs;
+  for(const Entry& entry : m_Entries)
+  {
+    jobs.push_back(entry.job);
+  }
+  return jobs;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobScheduler::setPriority(int id, int priority)
+{
+  for(Entry& entry : m_Entries)
+  {
+    if(entry.job.id == id && entry.job.priority != priority)
+    {
+      entry.job.priority = priority;
+      emit jobsChanged();
+      scheduleAdmit();
+      return;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobScheduler::cancelQueued(int id)
+{
+  for(Entry& entry : m_Entries)
+  {
+    if(entry.job.id == id && entry.job.state == JobState::Queued)
+    {
+      entry.job.state = JobState::Canceled;
+      entry.job.finished = QDateTime::currentDateTime();
+      entry.start = nullptr;
+      pruneFinished();
+      emit jobCanceled(id);
+      emit jobsChanged();
+      scheduleAdmit();
+      return;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobScheduler::clearFinished()
+{
+  QVector<Entry> entries;
+  for(const Entry& entry : m_Entries)
+  {
+    if(entry.job.state == JobState::Queued || entry.job.state == JobState::Running)
+    {
+      entries.push_back(entry);
+    }
+  }
+  m_Entries = entries;
+  emit jobsChanged();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobScheduler::scheduleAdmit()
+{
+  if(m_AdmitScheduled)
+  {
+    return;
+  }
+  m_AdmitScheduled = true;
+  QTimer::singleShot(0, this, [this] {
+    m_AdmitScheduled = false;
+    admit();
+  });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobScheduler::admit()
+{
+  bool changed = false;
+  while(true)
+  {
+    int next = -1;
+    bool running = false;
+    for(int i = 0; i < m_Entries.size(); i++)
+    {
+      Job& job = m_Entries[i].job;
+      running = running || job.state == JobState::Running;
+      if(job.state != JobState::Queued)
+      {
+        continue;
+      }
+      if(m_Entries[i].owner.isNull())
+      {
+        // The window was closed while its run was waiting
+        job.state = JobState::Canceled;
+        job.finished = QDateTime::currentDateTime();
+        m_Entries[i].start = nullptr;
+        changed = true;
+        continue;
+      }
+      if(next < 0 || job.priority > m_Entries[next].job.priority)
+      {
+        next = i;
+      }
+    }
+    if(next < 0)
+    {
+      break;
+    }
+
+    Job& job = m_Entries[next].job;
+    bool fitsThreads = getUsedThreads() + job.threads <= m_MaxThreads;
+    bool fitsMemory = m_MaxMemoryBytes <= 0 || getUsedMemoryBytes() + job.memoryBytes <= m_MaxMemoryBytes;
+    if(running && (!fitsThreads || !fitsMemory))
+    {
+      break;
+    }
+
+    job.state = JobState::Running;
+    job.started = QDateTime::currentDateTime();
+    std::function<void()> start = m_Entries[next].start;
+    m_Entries[next].start = nullptr;
+    emit jobsChanged();
+    // The window may finish the run right away if it can not be started, which only schedules the next admit
+    start();
+  }
+
+  if(changed)
+  {
+    pruneFinished();
+    emit jobsChanged();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobScheduler::pruneFinished()
+{
+  int finished = 0;
+  for(const Entry& entry : m_Entries)
+  {
+    finished += (entry.job.state != JobState::Queued && entry.job.state != JobState::Running) ? 1 : 0;
+  }
+  for(int i = 0; i < m_Entries.size() && finished > k_FinishedHistory;)
+  {
+    if(m_Entries[i].job.state != JobState::Queued && m_Entries[i].job.state != JobState::Running)
+    {
+      m_Entries.remove(i);
+      finished--;
+    }
+    else
+    {
+      i++;
+    }
+  }
+}
@@ -0,0 +1,206 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The PipelineJobScheduler class admits the pipeline executions of all SIMPLView windows. A window
+ * submits a run with the number of threads it will use and the memory its preflight says it needs, and the
+ * run is started once it fits under the "Maximum Pipeline Threads" and "Maximum Pipeline Memory (MB)"
+ * preferences together with the runs that are already executing. Queued runs are admitted by priority and
+ * then in the order they were submitted; a run never overtakes a queued run with a higher priority, so a
+ * large run is not starved by small ones. A run that is larger than the caps on its own still runs once
+ * nothing else is executing. A window has at most one run here at a time, and runs that are started with
+ * the Start button of the pipeline view execute through SVPipelineView without being admitted. The thread
+ * cap is also the limit of the parallel algorithms of this process, see ThreadBudget::LimitProcess().
+ */
+class PipelineJobScheduler : public QObject
+{
+  Q_OBJECT
+
+public:
+  enum class JobState
+  {
+    Queued,
+    Running,
+    Finished,
+    Failed,
+    Canceled
+  };
+
+  /**
+   * @brief The Job struct describes one submitted run
+   */
+  struct Job
+  {
+    int id = 0;
+    QString title;
+    int priority = 0;
+    int threads = 1;
+    qint64 memoryBytes = 0;
+    JobState state = JobState::Queued;
+    QDateTime submitted;
+    QDateTime started;
+    QDateTime finished;
+  };
+
+  PipelineJobScheduler(QObject* parent = nullptr);
+  ~PipelineJobScheduler() override;
+
+  /**
+   * @brief Returns the "Threads Per Pipeline" preference, by default half of ThreadBudget::DefaultThreads()
+   * @return
+   */
+  static int ThreadsPerPipelineFromPreferences();
+
+  /**
+   * @brief Estimates the memory a pipeline needs from the data structures its preflight left in the
+   * filters. This is the largest structure after any filter, counting every array at its full size.
+   * @param filters
+   * @return
+   */
+  static qint64 EstimatePeakBytes(const QVector<AbstractFilter::Pointer>& filters);
+
+  /**
+   * @brief Reads the caps from the preferences. "Maximum Pipeline Threads" defaults to
+   * ThreadBudget::DefaultThreads().
+   */
+  void readSettings();
+
+  int getMaxThreads() const;
+  qint64 getMaxMemoryBytes() const;
+  int getUsedThreads() const;
+  qint64 getUsedMemoryBytes() const;
+
+  /**
+   * @brief Queues a run. 'start' is called when the run is admitted, at the earliest from the event loop
+   * after this returns, and the owner must call finish() when the run is over. The run is canceled if the
+   * owner is deleted while it is queued.
+   * @param title
+   * @param priority Higher priorities are admitted first
+   * @param threads
+   * @param memoryBytes
+   * @param owner
+   * @param start
+   * @return The id of the run
+   */
+  int submit(const QString& title, int priority, int threads, qint64 memoryBytes, QObject* owner, std::function<void()> start);
+
+  /**
+   * @brief Marks a run as done and admits the next ones
+   * @param id
+   * @param error Negative if the run failed or was canceled
+   */
+  void finish(int id, int error);
+
+  /**
+   * @brief Returns true if the run is waiting to be admitted
+   * @param id
+   * @return
+   */
+  bool isQueued(int id) const;
+
+  /**
+   * @brief Returns the queued and running runs and the most recent finished ones
+   * @return
+   */
+  QVector<Job> getJobs() const;
+
+public slots:
+  void setPriority(int id, int priority);
+
+  /**
+   * @brief Removes a run from the queue. Running runs are canceled by their window.
+   * @param id
+   */
+  void cancelQueued(int id);
+
+  void clearFinished();
+
+signals:
+  void jobsChanged();
+
+  /**
+   * @brief Emitted when a queued run is canceled before it was started
+   * @param id
+   */
+  void jobCanceled(int id);
+
+private:
+  struct Entry
+  {
+    Job job;
+    QPointer<QObject> owner;
+    std::function<void()> start;
+  };
+
+  QVector<Entry> m_Entries;
+  int m_NextId = 1;
+  int m_MaxThreads = 1;
+  qint64 m_MaxMemoryBytes = 0;
+  bool m_AdmitScheduled = false;
+
+  /**
+   * @brief Admits the queued runs from the event loop, so a run is never started from inside submit()
+   * or finish()
+   */
+  void scheduleAdmit();
+
+  /**
+   * @brief Starts the queued runs that fit under the caps
+   */
+  void admit();
+
+  /**
+   * @brief Removes the oldest finished runs beyond the history that is kept
+   */
+  void pruneFinished();
+
+public:
+  PipelineJobScheduler(const PipelineJobScheduler&) = delete;            // Copy Constructor Not Implemented
+  PipelineJobScheduler(PipelineJobScheduler&&) = delete;                 // Move Constructor Not Implemented
+  PipelineJobScheduler& operator=(const PipelineJobScheduler&) = delete; // Copy Assignment Not Implemented
+  PipelineJobScheduler& operator=(PipelineJobScheduler&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,251 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineJobsDialog.h"
+
+#include <QtCore/QTimer>
+#include <QtWidgets/QDialogButtonBox>
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QTreeWidget>
+#include <QtWidgets/QVBoxLayout>
+
+#include "SIMPLView/PipelineJobScheduler.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString StateText(PipelineJobScheduler::JobState state)
+{
+  switch(state)
+  {
+  case PipelineJobScheduler::JobState::Queued:
+    return "Queued";
+  case PipelineJobScheduler::JobState::Running:
+    return "Running";
+  case PipelineJobScheduler::JobState::Finished:
+    return "Finished";
+  case PipelineJobScheduler::JobState::Failed:
+    return "Failed";
+  case PipelineJobScheduler::JobState::Canceled:
+    return "Canceled";
+  }
+  return QString();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString DurationText(const QDateTime& from, const QDateTime& to)
+{
+  if(!from.isValid())
+  {
+    return QString();
+  }
+  qint64 seconds = from.secsTo(to.isValid() ? to : QDateTime::currentDateTime());
+  return QString("%1:%2:%3").arg(seconds / 3600).arg((seconds / 60) % 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString MegabytesText(qint64 bytes)
+{
+  return QString("%1 MB").arg(bytes / (1024 * 1024));
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineJobsDialog::PipelineJobsDialog(PipelineJobScheduler* scheduler, QWidget* parent)
+: QDialog(parent)
+, m_Scheduler(scheduler)
+{
+  setWindowTitle("Pipeline Jobs");
+  resize(720, 360);
+
+  m_JobsTree = new QTreeWidget(this);
+  m_JobsTree->setRootIsDecorated(false);
+  m_JobsTree->setHeaderLabels(QStringList() << "Pipeline"
+                                            << "State"
+                                            << "Priority"
+                                            << "Threads"
+                                            << "Memory"
+                                            << "Waited"
+                                            << "Ran");
+  m_JobsTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+  m_JobsTree->header()->setStretchLastSection(false);
+
+  m_UsageLabel = new QLabel(this);
+
+  m_RaiseButton = new QPushButton("Raise Priority", this);
+  m_LowerButton = new QPushButton("Lower Priority", this);
+  m_CancelButton = new QPushButton("Remove From Queue", this);
+  QPushButton* clearButton = new QPushButton("Clear Finished", this);
+  QHBoxLayout* buttonLayout = new QHBoxLayout;
+  buttonLayout->addWidget(m_RaiseButton);
+  buttonLayout->addWidget(m_LowerButton);
+  buttonLayout->addWidget(m_CancelButton);
+  buttonLayout->addStretch();
+  buttonLayout->addWidget(clearButton);
+
+  QDialogButtonBox* buttonBox = new QDialogButtonBox(QDialogButtonBox::Close, this);
+
+  QVBoxLayout* layout = new QVBoxLayout(this);
+  layout->addWidget(m_JobsTree);
+  layout->addWidget(m_UsageLabel);
+  layout->addLayout(buttonLayout);
+  layout->addWidget(buttonBox);
+
+  connect(m_RaiseButton, &QPushButton::clicked, this, &PipelineJobsDialog::raiseSelectedPriority);
+  connect(m_LowerButton, &QPushButton::clicked, this, &PipelineJobsDialog::lowerSelectedPriority);
+  connect(m_CancelButton, &QPushButton::clicked, this, &PipelineJobsDialog::cancelSelected);
+  connect(clearButton, &QPushButton::clicked, m_Scheduler, &PipelineJobScheduler::clearFinished);
+  connect(buttonBox, &QDialogButtonBox::rejected, this, &PipelineJobsDialog::reject);
+  connect(m_JobsTree, &QTreeWidget::itemSelectionChanged, this, &PipelineJobsDialog::updateButtons);
+  connect(m_Scheduler, &PipelineJobScheduler::jobsChanged, this, &PipelineJobsDialog::updateJobs);
+
+  // The waiting and running times change without the scheduler changing
+  m_ElapsedTimer = new QTimer(this);
+  m_ElapsedTimer->setInterval(1000);
+  connect(m_ElapsedTimer, &QTimer::timeout, this, &PipelineJobsDialog::updateJobs);
+  m_ElapsedTimer->start();
+
+  updateJobs();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineJobsDialog::~PipelineJobsDialog() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobsDialog::updateJobs()
+{
+  int selected = selectedJob();
+  m_JobsTree->clear();
+  for(const PipelineJobScheduler::Job& job : m_Scheduler->getJobs())
+  {
+    QTreeWidgetItem* item = new QTreeWidgetItem(m_JobsTree);
+    item->setData(0, Qt::UserRole, job.id);
+    item->setText(0, job.title);
+    item->setText(1, StateText(job.state));
+    item->setText(2, QString::number(job.priority));
+    item->setText(3, QString::number(job.threads));
+    item->setText(4, MegabytesText(job.memoryBytes));
+    item->setText(5, DurationText(job.submitted, job.started.isValid() ? job.started : job.finished));
+    item->setText(6, DurationText(job.started, job.finished));
+    item->setSelected(job.id == selected);
+  }
+
+  QString memoryCap = m_Scheduler->getMaxMemoryBytes() > 0 ? MegabytesText(m_Scheduler->getMaxMemoryBytes()) : QString("no limit");
+  m_UsageLabel->setText(QString("Threads in use: %1 of %2    Estimated memory in use: %3 of %4")
+                            .arg(m_Scheduler->getUsedThreads())
+                            .arg(m_Scheduler->getMaxThreads())
+                            .arg(MegabytesText(m_Scheduler->getUsedMemoryBytes()))
+                            .arg(memoryCap));
+  updateButtons();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobsDialog::raiseSelectedPriority()
+{
+  changeSelectedPriority(1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobsDialog::lowerSelectedPriority()
+{
+  changeSelectedPriority(-1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobsDialog::cancelSelected()
+{
+  int id = selectedJob();
+  if(id >= 0)
+  {
+    m_Scheduler->cancelQueued(id);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobsDialog::updateButtons()
+{
+  bool queued = m_Scheduler->isQueued(selectedJob());
+  m_RaiseButton->setEnabled(queued);
+  m_LowerButton->setEnabled(queued);
+  m_CancelButton->setEnabled(queued);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineJobsDialog::selectedJob() const
+{
+  QList<QTreeWidgetItem*> items = m_JobsTree->selectedItems();
+  return items.isEmpty() ? -1 : items.front()->data(0, Qt::UserRole).toInt();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineJobsDialog::changeSelectedPriority(int delta)
+{
+  int id = selectedJob();
+  for(const PipelineJobScheduler::Job& job : m_Scheduler->getJobs())
+  {
+    if(job.id == id)
+    {
+      m_Scheduler->setPriority(id, job.priority + delta);
+      return;
+    }
+  }
+}
@@ -0,0 +1,95 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtWidgets/QDialog>
+
+class QLabel;
+class QPushButton;
+class QTimer;
+class QTreeWidget;
+class PipelineJobScheduler;
+
+/**
+ * @brief The PipelineJobsDialog class lists the queued, running and finished pipeline runs of all windows
+ * and lets the user change the priority of a queued run or take it out of the queue.
+ */
+class PipelineJobsDialog : public QDialog
+{
+  Q_OBJECT
+
+public:
+  PipelineJobsDialog(PipelineJobScheduler* scheduler, QWidget* parent = nullptr);
+  ~PipelineJobsDialog() override;
+
+protected slots:
+  /**
+   * @brief Rebuilds the list from the scheduler
+   */
+  void updateJobs();
+
+  void raiseSelectedPriority();
+  void lowerSelectedPriority();
+  void cancelSelected();
+  void updateButtons();
+
+private:
+  PipelineJobScheduler* m_Scheduler = nullptr;
+  QTreeWidget* m_JobsTree = nullptr;
+  QLabel* m_UsageLabel = nullptr;
+  QPushButton* m_RaiseButton = nullptr;
+  QPushButton* m_LowerButton = nullptr;
+  QPushButton* m_CancelButton = nullptr;
+  QTimer* m_ElapsedTimer = nullptr;
+
+  /**
+   * @brief Returns the id of the selected run or -1
+   * @return
+   */
+  int selectedJob() const;
+
+  /**
+   * @brief Adds 'delta' to the priority of the selected run
+   * @param delta
+   */
+  void changeSelectedPriority(int delta);
+
+public:
+  PipelineJobsDialog(const PipelineJobsDialog&) = delete;            // Copy Constructor Not Implemented
+  PipelineJobsDialog(PipelineJobsDialog&&) = delete;                 // Move Constructor Not Implemented
+  PipelineJobsDialog& operator=(const PipelineJobsDialog&) = delete; // Copy Assignment Not Implemented
+  PipelineJobsDialog& operator=(PipelineJobsDialog&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,346 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineProcessRunner.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QStringList>
+#include <QtCore/QTemporaryDir>
+
+#include "SVWidgetsLib/QtSupport/QtSSettings.h"
+
+#include "Common/PipelineWorker.h"
+#include "Common/PipelineWorkerPool.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineProcessRunner::PipelineProcessRunner(QObject* parent)
+: QObject(parent)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineProcessRunner::~PipelineProcessRunner()
+{
+  if(m_Pool != nullptr)
+  {
+    disconnect(m_Pool, nullptr, this, nullptr);
+    m_Pool->cancel(m_JobId);
+    delete m_Pool;
+  }
+  removePublishDirectory();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineProcessRunner::OutOfProcessExecutionRequested()
+{
+  QByteArray envValue = qgetenv("SIMPLVIEW_OUT_OF_PROCESS");
+  if(!envValue.isEmpty())
+  {
+    return envValue != "0";
+  }
+
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  // The preference used to be named as if it applied to every execution
+  QVariant oldValue = prefs.value("Execute Pipelines Out Of Process", QVariant(false));
+  bool outOfProcess = prefs.value("Execute Bookmarks Out Of Process", oldValue).toBool();
+  prefs.endGroup();
+  return outOfProcess;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineCheckpointPolicy PipelineProcessRunner::CheckpointPolicyFromPreferences()
+{
+  QString defaultDirectory = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("Checkpoints");
+
+  PipelineCheckpointPolicy policy;
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  policy.everyFilters = prefs.value("Checkpoint Every N Filters", QVariant(0)).toInt();
+  policy.minimumSeconds = prefs.value("Checkpoint After Seconds", QVariant(0.0)).toDouble();
+  policy.resume = prefs.value("Resume From Checkpoints", QVariant(true)).toBool();
+  policy.directory = prefs.value("Checkpoint Directory", QVariant(defaultDirectory)).toString();
+  prefs.endGroup();
+
+  if(policy.everyFilters <= 0 && policy.minimumSeconds <= 0.0)
+  {
+    return PipelineCheckpointPolicy();
+  }
+  return policy;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineProcessRunner::SnapshotCacheFromPreferences()
+{
+  QString defaultDirectory = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("Snapshots");
+
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  double memoryMB = prefs.value("Pipeline Snapshot Memory (MB)", QVariant(0)).toDouble();
+  double diskMB = prefs.value("Pipeline Snapshot Disk (MB)", QVariant(0)).toDouble();
+  QString directory = prefs.value("Pipeline Snapshot Directory", QVariant(defaultDirectory)).toString();
+  double minimumSeconds = prefs.value("Pipeline Snapshot Minimum Seconds", QVariant(1.0)).toDouble();
+  prefs.endGroup();
+
+  QJsonObject settings;
+  if(memoryMB <= 0.0 && diskMB <= 0.0)
+  {
+    return settings;
+  }
+  settings["memoryMB"] = memoryMB;
+  settings["diskMB"] = diskMB;
+  settings["directory"] = directory;
+  settings["minimumSeconds"] = minimumSeconds;
+  return settings;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineProcessRunner::ResultCacheFromPreferences()
+{
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  QString directory = prefs.value("Result Cache Directory", QVariant(QString())).toString();
+  double maxGB = prefs.value("Result Cache Size (GB)", QVariant(50.0)).toDouble();
+  double minimumSeconds = prefs.value("Result Cache Minimum Seconds", QVariant(10.0)).toDouble();
+  prefs.endGroup();
+
+  QJsonObject settings;
+  if(directory.isEmpty())
+  {
+    return settings;
+  }
+  settings["directory"] = directory;
+  settings["maxGB"] = maxGB;
+  settings["minimumSeconds"] = minimumSeconds;
+  return settings;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessRunner::setMaxThreads(int threads)
+{
+  m_MaxThreads = qMax(0, threads);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineProcessRunner::BufferPoolMegabytesFromPreferences()
+{
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  int megabytes = prefs.value("Buffer Pool (MB)", QVariant(0)).toInt();
+  prefs.endGroup();
+  return qMax(0, megabytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineProcessRunner::start(const QString& pipelineFile)
+{
+  if(isRunning())
+  {
+    return false;
+  }
+
+  // Without snapshots a new worker is used for every run, so that everything the pipeline allocated is gone
+  // once it exits. With snapshots the worker and the snapshots in its memory are kept for the next run.
+  QJsonObject snapshotCache = SnapshotCacheFromPreferences();
+  if(m_Pool != nullptr && snapshotCache.isEmpty())
+  {
+    delete m_Pool;
+    m_Pool = nullptr;
+  }
+  m_KeepWorker = !snapshotCache.isEmpty();
+  if(m_Pool == nullptr)
+  {
+    m_Pool = new PipelineWorkerPool(QCoreApplication::applicationFilePath(), QStringList() << "--pipeline-worker", 1);
+    connect(m_Pool, &PipelineWorkerPool::jobMessage, this, &PipelineProcessRunner::jobMessage);
+    connect(m_Pool, &PipelineWorkerPool::jobPublished, this, &PipelineProcessRunner::jobPublished);
+    // The pool may be deleted when the job finishes, which must not happen while it is still emitting
+    connect(m_Pool, &PipelineWorkerPool::jobFinished, this, &PipelineProcessRunner::jobFinished, Qt::QueuedConnection);
+  }
+
+  PipelineJob job;
+  job.id = QString("run-%1").arg(++m_RunCount);
+  job.pipelineFile = pipelineFile;
+  m_PublishDirectory = CreatePublishDirectory();
+  job.publishDirectory = m_PublishDirectory;
+  job.snapshotCache = snapshotCache;
+  job.resultCache = ResultCacheFromPreferences();
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  job.concurrentFilters = prefs.value("Concurrent Filters", QVariant(1)).toInt();
+  job.bufferPoolMB = BufferPoolMegabytesFromPreferences();
+  // The published results keep every array that the pipeline leaves, so only intermediate arrays are released
+  job.releaseDeadArrays = prefs.value("Release Dead Arrays", QVariant(false)).toBool();
+  job.spillDirectory = prefs.value("Spill Directory", QVariant(QString())).toString();
+  prefs.endGroup();
+  job.threads = m_MaxThreads;
+  PipelineCheckpointPolicy checkpointPolicy = CheckpointPolicyFromPreferences();
+  if(checkpointPolicy.isEnabled())
+  {
+    job.checkpointPolicy = checkpointPolicy.toJson();
+  }
+  m_JobId = job.id;
+  m_Pool->submit(job);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PipelineProcessRunner::CreatePublishDirectory()
+{
+  QString root = QDir::tempPath();
+  QFileInfo shm("/dev/shm");
+  if(shm.isDir() && shm.isWritable())
+  {
+    root = shm.absoluteFilePath();
+  }
+
+  QTemporaryDir dir(QDir(root).filePath("SIMPLView-XXXXXX"));
+  if(!dir.isValid())
+  {
+    qDebug() << "PipelineProcessRunner: The results of the pipeline can not be shown, no directory could be created in" << root;
+    return QString();
+  }
+  // From here on SharedDataContainerArray or removePublishDirectory() removes it
+  dir.setAutoRemove(false);
+  return dir.path();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessRunner::removePublishDirectory()
+{
+  if(!m_PublishDirectory.isEmpty())
+  {
+    QDir(m_PublishDirectory).removeRecursively();
+    m_PublishDirectory.clear();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineProcessRunner::isRunning() const
+{
+  return !m_JobId.isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessRunner::cancel()
+{
+  if(m_Pool != nullptr && isRunning())
+  {
+    m_Pool->cancel(m_JobId);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessRunner::jobMessage(const QString& id, const QJsonObject& message)
+{
+  if(id == m_JobId)
+  {
+    emit pipelineHasMessage(PipelineWorker::MessageFromJson(message));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessRunner::jobPublished(const QString& id, const QJsonObject& description)
+{
+  if(id != m_JobId || m_PublishDirectory.isEmpty())
+  {
+    return;
+  }
+
+  // The SharedDataContainerArray owns the directory from here on, even if attaching fails
+  QString directory = m_PublishDirectory;
+  m_PublishDirectory.clear();
+  QString errorMessage;
+  SharedDataContainerArray::Pointer results = SharedDataContainerArray::Attach(description, directory, errorMessage);
+  if(nullptr == results.get())
+  {
+    qDebug() << "PipelineProcessRunner:" << errorMessage;
+    return;
+  }
+  emit dataContainerArrayPublished(results);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineProcessRunner::jobFinished(const QString& id, int error, qint64 elapsedMs, const QString& errorText)
+{
+  Q_UNUSED(elapsedMs)
+  if(id != m_JobId)
+  {
+    return;
+  }
+  m_JobId.clear();
+  removePublishDirectory();
+  if(!m_KeepWorker)
+  {
+    m_Pool->deleteLater();
+    m_Pool = nullptr;
+  }
+  emit pipelineFinished(error, errorText);
+}
@@ -0,0 +1,180 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "SIMPLib/Common/PipelineMessage.h"
+
+#include "Common/PipelineCheckpoint.h"
+#include "Common/SharedDataContainerArray.h"
+
+class PipelineWorkerPool;
+
+/**
+ * @brief The PipelineProcessRunner class executes the pipeline of a SIMPLView_UI in a child process, which is
+ * this executable started with --pipeline-worker. The messages of the pipeline are rebuilt and emitted as
+ * PipelineMessages so the window shows progress exactly as for a pipeline that runs in the GUI process. A
+ * crashing filter only ends the child process, and the memory of the pipeline goes back to the operating
+ * system when the child exits after every run. The DataContainerArray of a successful run is handed back
+ * through SharedDataContainerArray so it can be shown in the Data Browser.
+ */
+class PipelineProcessRunner : public QObject
+{
+  Q_OBJECT
+
+public:
+  PipelineProcessRunner(QObject* parent = nullptr);
+  ~PipelineProcessRunner() override;
+
+  /**
+   * @brief Returns true if pipelines that are executed from a bookmark should run in a child process. This
+   * is the "Execute Bookmarks Out Of Process" preference unless the SIMPLVIEW_OUT_OF_PROCESS environment
+   * variable is set. The Start button of the pipeline view always executes in the SIMPLView process and
+   * "Execute in Separate Process" always in a child process, so neither reads it.
+   * @return
+   */
+  static bool OutOfProcessExecutionRequested();
+
+  /**
+   * @brief Returns the checkpoint policy of the preferences "Checkpoint Every N Filters" and "Checkpoint After
+   * Seconds". Checkpoints go to "Checkpoint Directory", by default in the cache directory, and a run resumes
+   * from them unless "Resume From Checkpoints" is off. The policy is disabled if neither interval is set.
+   * @return
+   */
+  static PipelineCheckpointPolicy CheckpointPolicyFromPreferences();
+
+  /**
+   * @brief Returns the PipelineSnapshotCache settings of the preferences "Pipeline Snapshot Memory (MB)",
+   * "Pipeline Snapshot Disk (MB)", "Pipeline Snapshot Directory" and "Pipeline Snapshot Minimum Seconds". It is
+   * empty if both budgets are zero. With snapshots the child process is kept between runs, so pressing Go
+   * after changing a filter only executes the filters from that one on. Snapshots are not free: after every
+   * filter that took at least the minimum seconds, 1 by default, the whole DataContainerArray is copied in
+   * memory, or written to the directory if it is larger than the memory budget. That can double the memory
+   * a run needs and add a full write per filter.
+   * @return
+   */
+  static QJsonObject SnapshotCacheFromPreferences();
+
+  /**
+   * @brief Returns the PipelineResultCache settings of the preferences "Result Cache Directory", "Result
+   * Cache Size (GB)" and "Result Cache Minimum Seconds". It is empty if no directory is set.
+   * @return
+   */
+  static QJsonObject ResultCacheFromPreferences();
+
+  /**
+   * @brief Returns the "Buffer Pool (MB)" preference, the freed array storage that a run keeps for reuse
+   * by later filters, see BufferPool. It is 0, no pool, unless it is set.
+   * @return
+   */
+  static int BufferPoolMegabytesFromPreferences();
+
+  /**
+   * @brief Starts executing a pipeline file
+   * @param pipelineFile
+   * @return false if a pipeline is already running
+   */
+  bool start(const QString& pipelineFile);
+
+  /**
+   * @brief Sets how many threads the next runs may use in the child process, see ThreadBudget
+   * @param threads 0 for ThreadBudget::DefaultThreads()
+   */
+  void setMaxThreads(int threads);
+
+  /**
+   * @brief Returns true while a pipeline is executing
+   * @return
+   */
+  bool isRunning() const;
+
+public slots:
+  /**
+   * @brief Cancels the executing pipeline by ending the child process
+   */
+  void cancel();
+
+signals:
+  void pipelineHasMessage(const PipelineMessage& msg);
+
+  /**
+   * @brief Emitted before pipelineFinished() when the child process has published the DataContainerArray
+   * of a successful run
+   * @param results Keeps the published arrays alive
+   */
+  void dataContainerArrayPublished(SharedDataContainerArray::Pointer results);
+
+  /**
+   * @brief Emitted when the pipeline has finished, failed or was canceled
+   * @param error Negative if the pipeline failed or was canceled
+   * @param errorText
+   */
+  void pipelineFinished(int error, const QString& errorText);
+
+protected slots:
+  void jobMessage(const QString& id, const QJsonObject& message);
+  void jobPublished(const QString& id, const QJsonObject& description);
+  void jobFinished(const QString& id, int error, qint64 elapsedMs, const QString& errorText);
+
+private:
+  PipelineWorkerPool* m_Pool = nullptr;
+  QString m_JobId;
+  int m_RunCount = 0;
+  QString m_PublishDirectory;
+  bool m_KeepWorker = false;
+  int m_MaxThreads = 0;
+
+  /**
+   * @brief Creates the directory the child process publishes its results to. On Linux it is in /dev/shm so
+   * the published arrays never touch the disk.
+   * @return An empty string if no directory could be created
+   */
+  static QString CreatePublishDirectory();
+
+  /**
+   * @brief Removes the publish directory of a run whose results were not attached
+   */
+  void removePublishDirectory();
+
+public:
+  PipelineProcessRunner(const PipelineProcessRunner&) = delete;            // Copy Constructor Not Implemented
+  PipelineProcessRunner(PipelineProcessRunner&&) = delete;                 // Move Constructor Not Implemented
+  PipelineProcessRunner& operator=(const PipelineProcessRunner&) = delete; // Copy Assignment Not Implemented
+  PipelineProcessRunner& operator=(PipelineProcessRunner&&) = delete;      // Move Assignment Not Implemented
+};
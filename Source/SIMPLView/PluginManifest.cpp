@@ -0,0 +1,369 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PluginManifest.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include "SIMPLib/SIMPLibVersion.h"
+
+#include "SIMPLView/SIMPLViewVersion.h"
+
+namespace
+{
+const int k_ManifestVersion = 3;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 lastModifiedStamp(const QFileInfo& fi)
+{
+  if(!fi.exists())
+  {
+    return -1;
+  }
+  return fi.lastModified().toMSecsSinceEpoch();
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginManifest::PluginManifest() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginManifest::~PluginManifest() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PluginManifest::DefaultFilePath()
+{
+  QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  return cacheDir + "/PluginManifest.json";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString PluginManifest::BuildId()
+{
+  return QString("%1-%2|%3-%4|%5").arg(SIMPLView::Version::Complete(), SIMPLView::Version::Revision(), SIMPLib::Version::Complete(), SIMPLib::Version::Revision(), SIMPLView::Version::BuildDate());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginManifest::read(const QString& filePath)
+{
+  m_Directories.clear();
+  m_Plugins.clear();
+  m_Dirty = true;
+
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+
+  QJsonParseError parseError;
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+  if(parseError.error != QJsonParseError::NoError || !doc.isObject())
+  {
+    return false;
+  }
+
+  QJsonObject root = doc.object();
+  if(root["Version"].toInt() != k_ManifestVersion || root["BuildId"].toString() != BuildId())
+  {
+    return false;
+  }
+
+  QJsonArray dirArray = root["Directories"].toArray();
+  for(const QJsonValue& value : dirArray)
+  {
+    QJsonObject dirObj = value.toObject();
+    DirectoryEntry dirEntry;
+    dirEntry.lastModified = static_cast<qint64>(dirObj["LastModified"].toDouble(-1));
+    for(const QJsonValue& fileValue : dirObj["Files"].toArray())
+    {
+      dirEntry.files.push_back(fileValue.toString());
+    }
+    m_Directories.insert(dirObj["Path"].toString(), dirEntry);
+  }
+
+  QJsonArray pluginArray = root["Plugins"].toArray();
+  for(const QJsonValue& value : pluginArray)
+  {
+    PluginEntry pluginEntry = FromJson(value.toObject());
+    m_Plugins.insert(pluginEntry.filePath, pluginEntry);
+  }
+
+  m_Dirty = false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginManifest::write(const QString& filePath)
+{
+  if(!m_Dirty)
+  {
+    return true;
+  }
+
+  QJsonArray dirArray;
+  for(QHash<QString, DirectoryEntry>::const_iterator iter = m_Directories.constBegin(); iter != m_Directories.constEnd(); ++iter)
+  {
+    QJsonObject dirObj;
+    dirObj["Path"] = iter.key();
+    dirObj["LastModified"] = static_cast<double>(iter.value().lastModified);
+    dirObj["Files"] = QJsonArray::fromStringList(iter.value().files);
+    dirArray.push_back(dirObj);
+  }
+
+  QJsonArray pluginArray;
+  for(const PluginEntry& pluginEntry : m_Plugins)
+  {
+    pluginArray.push_back(ToJson(pluginEntry));
+  }
+
+  QJsonObject root;
+  root["Version"] = k_ManifestVersion;
+  root["BuildId"] = BuildId();
+  root["Directories"] = dirArray;
+  root["Plugins"] = pluginArray;
+
+  QFileInfo fi(filePath);
+  QDir().mkpath(fi.absolutePath());
+
+  // Write to a temporary file first so that an interrupted write never leaves a truncated manifest behind
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+  if(!file.commit())
+  {
+    return false;
+  }
+
+  m_Dirty = false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginManifest::findPluginFiles(const QString& dirPath, QStringList& files) const
+{
+  if(!m_Directories.contains(dirPath))
+  {
+    return false;
+  }
+
+  const DirectoryEntry& dirEntry = m_Directories[dirPath];
+  if(dirEntry.lastModified != lastModifiedStamp(QFileInfo(dirPath)))
+  {
+    return false;
+  }
+
+  files = dirEntry.files;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PluginManifest::setPluginFiles(const QString& dirPath, const QStringList& files)
+{
+  DirectoryEntry dirEntry;
+  dirEntry.lastModified = lastModifiedStamp(QFileInfo(dirPath));
+  dirEntry.files = files;
+  m_Directories.insert(dirPath, dirEntry);
+  m_Dirty = true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PluginManifest::isCurrent(const QString& filePath) const
+{
+  if(!m_Plugins.contains(filePath))
+  {
+    return false;
+  }
+
+  const PluginEntry& pluginEntry = m_Plugins[filePath];
+  QFileInfo fi(filePath);
+  return fi.exists() && fi.size() == pluginEntry.size && lastModifiedStamp(fi) == pluginEntry.lastModified;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginManifest::PluginEntry PluginManifest::entry(const QString& filePath) const
+{
+  return m_Plugins.value(filePath, PluginEntry());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PluginManifest::setEntry(PluginEntry entry)
+{
+  QFileInfo fi(entry.filePath);
+  entry.size = fi.size();
+  entry.lastModified = lastModifiedStamp(fi);
+  m_Plugins.insert(entry.filePath, entry);
+  m_Dirty = true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PluginManifest::prune(const QStringList& filePaths)
+{
+  QStringList keys = m_Plugins.keys();
+  for(const QString& key : keys)
+  {
+    if(!filePaths.contains(key))
+    {
+      m_Plugins.remove(key);
+      m_Dirty = true;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<PluginManifest::PluginEntry> PluginManifest::entries() const
+{
+  QVector<PluginEntry> pluginEntries;
+  for(const PluginEntry& pluginEntry : m_Plugins)
+  {
+    pluginEntries.push_back(pluginEntry);
+  }
+  return pluginEntries;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PluginManifest::ToJson(const PluginEntry& entry)
+{
+  QJsonArray filterArray;
+  for(const FilterEntry& filterEntry : entry.filters)
+  {
+    QJsonObject filterObj;
+    filterObj["ClassName"] = filterEntry.className;
+    filterObj["Uuid"] = filterEntry.uuid;
+    filterObj["HumanLabel"] = filterEntry.humanLabel;
+    filterObj["Group"] = filterEntry.group;
+    filterObj["SubGroup"] = filterEntry.subGroup;
+    filterObj["BrandingString"] = filterEntry.brandingString;
+    filterObj["CompiledLibraryName"] = filterEntry.compiledLibraryName;
+    filterObj["HtmlSummary"] = filterEntry.htmlSummary;
+    filterArray.push_back(filterObj);
+  }
+
+  QJsonObject json;
+  json["Path"] = entry.filePath;
+  json["Size"] = static_cast<double>(entry.size);
+  json["LastModified"] = static_cast<double>(entry.lastModified);
+  json["Name"] = entry.pluginName;
+  json["DisplayName"] = entry.displayName;
+  json["BaseName"] = entry.baseName;
+  json["Version"] = entry.version;
+  json["CompatibilityVersion"] = entry.compatibilityVersion;
+  json["Vendor"] = entry.vendor;
+  json["URL"] = entry.url;
+  json["Description"] = entry.description;
+  json["Copyright"] = entry.copyright;
+  json["License"] = entry.license;
+  json["Registered"] = entry.registered;
+  json["Filters"] = filterArray;
+  return json;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginManifest::PluginEntry PluginManifest::FromJson(const QJsonObject& json)
+{
+  PluginEntry entry;
+  entry.filePath = json["Path"].toString();
+  entry.size = static_cast<qint64>(json["Size"].toDouble(-1));
+  entry.lastModified = static_cast<qint64>(json["LastModified"].toDouble(-1));
+  entry.pluginName = json["Name"].toString();
+  entry.displayName = json["DisplayName"].toString();
+  entry.baseName = json["BaseName"].toString();
+  entry.version = json["Version"].toString();
+  entry.compatibilityVersion = json["CompatibilityVersion"].toString();
+  entry.vendor = json["Vendor"].toString();
+  entry.url = json["URL"].toString();
+  entry.description = json["Description"].toString();
+  entry.copyright = json["Copyright"].toString();
+  entry.license = json["License"].toString();
+  entry.registered = json["Registered"].toBool();
+
+  for(const QJsonValue& value : json["Filters"].toArray())
+  {
+    QJsonObject filterObj = value.toObject();
+    FilterEntry filterEntry;
+    filterEntry.className = filterObj["ClassName"].toString();
+    filterEntry.uuid = filterObj["Uuid"].toString();
+    filterEntry.humanLabel = filterObj["HumanLabel"].toString();
+    filterEntry.group = filterObj["Group"].toString();
+    filterEntry.subGroup = filterObj["SubGroup"].toString();
+    filterEntry.brandingString = filterObj["BrandingString"].toString();
+    filterEntry.compiledLibraryName = filterObj["CompiledLibraryName"].toString();
+    filterEntry.htmlSummary = filterObj["HtmlSummary"].toString();
+    entry.filters.push_back(filterEntry);
+  }
+  return entry;
+}
@@ -0,0 +1,185 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+/**
+ * @brief The PluginManifest class is an on-disk index of the plugins that were found during the
+ * previous launch. Each plugin directory is recorded with its modification time and the list of plugin
+ * files it contained, and each plugin file is recorded with its size, modification time and the
+ * filters that it registered. If the directory and file stamps still match then the plugin directories
+ * do not need to be enumerated again. The whole manifest is discarded when the build ID changes.
+ */
+class PluginManifest
+{
+public:
+  struct FilterEntry
+  {
+    QString className;
+    QString uuid;
+    QString humanLabel;
+    QString group;
+    QString subGroup;
+    QString brandingString;
+    QString compiledLibraryName;
+    QString htmlSummary;
+  };
+
+  struct PluginEntry
+  {
+    QString filePath;
+    qint64 size = -1;
+    qint64 lastModified = -1;
+    QString pluginName;
+    QString displayName;
+    QString baseName;
+    QString version;
+    QString compatibilityVersion;
+    QString vendor;
+    QString url;
+    QString description;
+    QString copyright;
+    QString license;
+    bool registered = false;
+    QVector<FilterEntry> filters;
+  };
+
+  PluginManifest();
+  virtual ~PluginManifest();
+
+  /**
+   * @brief Returns the default location of the manifest file in the user's cache directory
+   * @return
+   */
+  static QString DefaultFilePath();
+
+  /**
+   * @brief Returns a string that identifies this build of the application and of SIMPLib. Manifests that
+   * were written by a different build are ignored.
+   * @return
+   */
+  static QString BuildId();
+
+  /**
+   * @brief Reads the manifest from disk. Returns false if the file does not exist, can not be parsed or
+   * was written by a different build; the manifest is empty in that case.
+   * @param filePath
+   * @return
+   */
+  bool read(const QString& filePath = DefaultFilePath());
+
+  /**
+   * @brief Writes the manifest to disk if anything has changed since it was read.
+   * @param filePath
+   * @return
+   */
+  bool write(const QString& filePath = DefaultFilePath());
+
+  /**
+   * @brief Fills 'files' with the plugin files that were found in 'dirPath' during the last scan. Returns
+   * false if the directory was never scanned or has been modified since.
+   * @param dirPath
+   * @param files
+   * @return
+   */
+  bool findPluginFiles(const QString& dirPath, QStringList& files) const;
+
+  /**
+   * @brief Records the result of scanning 'dirPath' for plugin files
+   * @param dirPath
+   * @param files
+   */
+  void setPluginFiles(const QString& dirPath, const QStringList& files);
+
+  /**
+   * @brief Returns true if there is an entry for 'filePath' and the file on disk still has the same
+   * size and modification time.
+   * @param filePath
+   * @return
+   */
+  bool isCurrent(const QString& filePath) const;
+
+  /**
+   * @brief Returns the entry for 'filePath'. The entry's filePath is empty if there is none.
+   * @param filePath
+   * @return
+   */
+  PluginEntry entry(const QString& filePath) const;
+
+  /**
+   * @brief Stores the entry, stamping it with the current size and modification time of the file
+   * @param entry
+   */
+  void setEntry(PluginEntry entry);
+
+  /**
+   * @brief Removes the entries for any plugin file not contained in 'filePaths'
+   * @param filePaths
+   */
+  void prune(const QStringList& filePaths);
+
+  /**
+   * @brief Returns all of the plugin entries
+   * @return
+   */
+  QVector<PluginEntry> entries() const;
+
+protected:
+  static QJsonObject ToJson(const PluginEntry& entry);
+  static PluginEntry FromJson(const QJsonObject& json);
+
+private:
+  struct DirectoryEntry
+  {
+    qint64 lastModified = -1;
+    QStringList files;
+  };
+
+  QHash<QString, DirectoryEntry> m_Directories;
+  QHash<QString, PluginEntry> m_Plugins;
+  bool m_Dirty = false;
+
+public:
+  PluginManifest(const PluginManifest&) = delete;            // Copy Constructor Not Implemented
+  PluginManifest(PluginManifest&&) = delete;                 // Move Constructor Not Implemented
+  PluginManifest& operator=(const PluginManifest&) = delete; // Copy Assignment Not Implemented
+  PluginManifest& operator=(PluginManifest&&) = delete;      // Move Assignment Not Implemented
+};
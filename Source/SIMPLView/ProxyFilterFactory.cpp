@@ -0,0 +1,148 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ProxyFilterFactory.h"
+
+#include "SIMPLView/LazyPluginRegistry.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ProxyFilterFactory::ProxyFilterFactory(const PluginManifest::FilterEntry& entry, const QString& pluginPath)
+: m_Entry(entry)
+, m_PluginPath(pluginPath)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ProxyFilterFactory::~ProxyFilterFactory() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ProxyFilterFactory::Pointer ProxyFilterFactory::New(const PluginManifest::FilterEntry& entry, const QString& pluginPath)
+{
+  Pointer sharedPtr(new ProxyFilterFactory(entry, pluginPath));
+  return sharedPtr;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer ProxyFilterFactory::create() const
+{
+  IFilterFactory::Pointer factory = LazyPluginRegistry::Instance()->activatePluginForFilter(m_Entry.className);
+
+  // If the plugin could not be loaded the proxy is still registered and we must not call ourselves again
+  if(nullptr == factory || factory.get() == this)
+  {
+    return AbstractFilter::NullPointer();
+  }
+  return factory->create();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ProxyFilterFactory::getFilterGroup() const
+{
+  return m_Entry.group;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ProxyFilterFactory::getFilterSubGroup() const
+{
+  return m_Entry.subGroup;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ProxyFilterFactory::getFilterHtmlSummary() const
+{
+  return m_Entry.htmlSummary;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ProxyFilterFactory::getFilterHumanLabel() const
+{
+  return m_Entry.humanLabel;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ProxyFilterFactory::getFilterClassName() const
+{
+  return m_Entry.className;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ProxyFilterFactory::getBrandingString() const
+{
+  return m_Entry.brandingString;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ProxyFilterFactory::getCompiledLibraryName() const
+{
+  return m_Entry.compiledLibraryName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QUuid ProxyFilterFactory::getUuid() const
+{
+  return QUuid(m_Entry.uuid);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ProxyFilterFactory::getPluginPath() const
+{
+  return m_PluginPath;
+}
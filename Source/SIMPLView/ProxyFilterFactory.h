@@ -0,0 +1,98 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include "SIMPLib/Common/SIMPLibSetGetMacros.h"
+#include "SIMPLib/Filtering/IFilterFactory.hpp"
+
+#include "SIMPLView/PluginManifest.h"
+
+/**
+ * @brief The ProxyFilterFactory class stands in for the real filter factory of a plugin that has not been
+ * loaded yet. It answers all of the descriptive queries from the plugin manifest. The first call to create()
+ * loads the owning plugin through the LazyPluginRegistry, which replaces the proxies with the plugin's own
+ * factories, and then forwards the call to the real factory.
+ */
+class ProxyFilterFactory : public IFilterFactory
+{
+public:
+  SIMPL_SHARED_POINTERS(ProxyFilterFactory)
+  SIMPL_TYPE_MACRO_SUPER(ProxyFilterFactory, IFilterFactory)
+
+  /**
+   * @brief New
+   * @param entry The manifest information for the filter
+   * @param pluginPath The path to the plugin that provides the filter
+   * @return
+   */
+  static Pointer New(const PluginManifest::FilterEntry& entry, const QString& pluginPath);
+
+  ~ProxyFilterFactory() override;
+
+  /**
+   * @brief Loads the owning plugin if needed and creates the filter
+   * @return
+   */
+  AbstractFilter::Pointer create() const override;
+
+  QString getFilterGroup() const override;
+  QString getFilterSubGroup() const override;
+  QString getFilterHtmlSummary() const override;
+  QString getFilterHumanLabel() const override;
+  QString getFilterClassName() const override;
+  QString getBrandingString() const override;
+  QString getCompiledLibraryName() const override;
+  QUuid getUuid() const override;
+
+  /**
+   * @brief Returns the path of the plugin that provides this filter
+   * @return
+   */
+  QString getPluginPath() const;
+
+protected:
+  ProxyFilterFactory(const PluginManifest::FilterEntry& entry, const QString& pluginPath);
+
+private:
+  PluginManifest::FilterEntry m_Entry;
+  QString m_PluginPath;
+
+public:
+  ProxyFilterFactory(const ProxyFilterFactory&) = delete;            // Copy Constructor Not Implemented
+  ProxyFilterFactory(ProxyFilterFactory&&) = delete;                 // Move Constructor Not Implemented
+  ProxyFilterFactory& operator=(const ProxyFilterFactory&) = delete; // Copy Assignment Not Implemented
+  ProxyFilterFactory& operator=(ProxyFilterFactory&&) = delete;      // Move Assignment Not Implemented
+};
@@ -38,12 +38,17 @@
 #include <unistd.h>
 #endif
 
-#include <ctime>
 #include <iostream>
 
+#include <QtCore/QEventLoop>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QPluginLoader>
 #include <QtCore/QProcess>
+#include <QtCore/QPointer>
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <QtConcurrent/QtConcurrentMap>
 
 #include <QtGui/QBitmap>
 #include <QtGui/QBitmap>
@@ -56,17 +61,22 @@
 
 #include "SIMPLib/FilterParameters/JsonFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/JsonFilterParametersWriter.h"
+#include "SIMPLib/Filtering/FilterManager.h"
 #include "SIMPLib/Filtering/QMetaObjectUtilities.h"
+#include "SIMPLib/Plugin/ISIMPLibPlugin.h"
 #include "SIMPLib/Plugin/PluginManager.h"
 #include "SIMPLib/Plugin/PluginProxy.h"
 #include "SIMPLib/Utilities/SIMPLDataPathValidator.h"
 #include "SIMPLib/SIMPLibVersion.h"
 
+#include "Common/SIMPLViewPluginLoader.h"
+
 #include "SVWidgetsLib/QtSupport/QtSApplicationAboutBoxDialog.h"
 #include "SVWidgetsLib/QtSupport/QtSDocServer.h"
 #include "SVWidgetsLib/QtSupport/QtSRecentFileList.h"
 
 #include "SIMPLView/SIMPLView.h"
+#include "SIMPLView/StartupTracer.h"
 #ifdef SIMPL_USE_QtWebEngine
 #include "SVWidgetsLib/Widgets/SVUserManualDialog.h"
 #endif
@@ -80,9 +90,15 @@
 #include "SVWidgetsLib/Widgets/SVStyle.h"
 
 #include "SIMPLView/AboutSIMPLView.h"
+#include "SIMPLView/LazyPluginRegistry.h"
+#include "SIMPLView/PipelineJobScheduler.h"
+#include "SIMPLView/PipelineJobsDialog.h"
+#include "SIMPLView/PluginManifest.h"
 #include "SIMPLView/SIMPLView_UI.h"
 #include "SIMPLView/SIMPLViewVersion.h"
 #include "SIMPLView/SIMPLViewConstants.h"
+#include "SIMPLView/SingleInstanceServer.h"
+#include "SIMPLView/StyleSheetCache.h"
 
 #include "BrandedStrings.h"
 
@@ -104,6 +120,19 @@ void fillVersionData(UpdateCheck::SIMPLVersionData_t& data)
   data.buildDate = SIMPLView::Version::BuildDate();
   data.appName = BrandedStrings::ApplicationName;
 }
+
+// -----------------------------------------------------------------------------
+// Returns the settings that SIMPLView_UI applies while it is built and does not follow afterwards. Window
+// geometry, recent files and the like are written all the time and do not make a spare window stale.
+// -----------------------------------------------------------------------------
+QString spareWindowSettings()
+{
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  int refreshDelay = prefs.value("Preflight Refresh Delay (ms)", QVariant(150)).toInt();
+  prefs.endGroup();
+  return QString("%1|%2").arg(SVStyle::Instance()->getCurrentThemeFilePath()).arg(refreshDelay);
+}
 }
 
 // -----------------------------------------------------------------------------
@@ -115,20 +144,49 @@ SIMPLViewApplication::SIMPLViewApplication(int& argc, char** argv)
 , m_OpenDialogLastFilePath("")
 , m_ShowSplash(true)
 , m_SplashScreen(nullptr)
+, m_ParallelPluginLoading(true)
+, m_LazyPluginLoading(false)
+, m_SingleInstanceMode(false)
+, m_SingleInstanceServer(nullptr)
+, m_PreCreateWindows(true)
+, m_SpareWindowsEnabled(true)
+, m_SpareWindow(nullptr)
+, m_SpareWindowScheduled(false)
+, m_PipelineJobScheduler(new PipelineJobScheduler(this))
 , m_minSplashTime(3)
 {
   // Automatically check for updates at startup if the user has indicated that preference before
-  checkForUpdatesAtStartup();
+  {
+    StartupTraceScope traceScope("checkForUpdatesAtStartup");
+    checkForUpdatesAtStartup();
+  }
 
-  // Initialize the Default Stylesheet
-  SVStyle* style = SVStyle::Instance();
-  QString defaultLoadedThemePath = BrandedStrings::DefaultStyleDirectory + "/" + BrandedStrings::DefaultLoadedTheme + ".json";
-  style->loadStyleSheet(defaultLoadedThemePath);
+  // Initialize the Stylesheet. The theme from the preferences is loaded here as well so that only
+  // one theme has to be loaded at startup.
+  {
+    StartupTraceScope traceScope("Load Style Sheet");
+    QString themeFilePath = BrandedStrings::DefaultStyleDirectory + "/" + BrandedStrings::DefaultLoadedTheme + ".json";
+    QtSSettings prefs;
+    prefs.beginGroup("Application Settings");
+    QString prefsThemeFilePath = prefs.value("Theme File Path", QString()).toString();
+    prefs.endGroup();
+    if(!prefsThemeFilePath.isEmpty() && BrandedStrings::LoadedThemeNames.contains(QFileInfo(prefsThemeFilePath).baseName()))
+    {
+      themeFilePath = prefsThemeFilePath;
+    }
+    StyleSheetCache::Instance()->loadTheme(themeFilePath);
+  }
 
-  readSettings();
+  {
+    StartupTraceScope traceScope("readSettings");
+    readSettings();
+  }
 
   // Create the default menu bar
-  createDefaultMenuBar();
+  {
+    StartupTraceScope traceScope("createDefaultMenuBar");
+    createDefaultMenuBar();
+  }
 
   // If on Mac, add custom actions to a dock menu
 #if defined(Q_OS_MAC)
@@ -141,6 +199,9 @@ SIMPLViewApplication::SIMPLViewApplication(int& argc, char** argv)
 
   QSharedPointer<QtSSettings> prefs = QSharedPointer<QtSSettings>(new QtSSettings());
   QtSRecentFileList::Instance()->readList(prefs.data());
+
+  // The spare window is not registered, so nothing else closes it
+  connect(this, &QCoreApplication::aboutToQuit, this, &SIMPLViewApplication::discardSpareWindow);
 }
 
 // -----------------------------------------------------------------------------
@@ -148,6 +209,8 @@ SIMPLViewApplication::SIMPLViewApplication(int& argc, char** argv)
 // -----------------------------------------------------------------------------
 SIMPLViewApplication::~SIMPLViewApplication()
 {
+  discardSpareWindow();
+
   delete this->m_SplashScreen;
   this->m_SplashScreen = nullptr;
 
@@ -200,13 +263,16 @@ bool SIMPLViewApplication::initialize(int argc, char* argv[])
   name.append(".png");
 
   // Create and show the splash screen as the main window is being created.
-  QPixmap pixmap(name);
+  {
+    StartupTraceScope traceScope("Show Splash Screen");
+    QPixmap pixmap(name);
 
-  this->m_SplashScreen = new QSplashScreen(pixmap);
-  this->m_SplashScreen->show();
+    this->m_SplashScreen = new QSplashScreen(pixmap);
+    this->m_SplashScreen->show();
+  }
 
   // start timer;
-  std::clock_t startClock = std::clock();
+  m_SplashTimer.start();
 
   QDir dir(QApplication::applicationDirPath());
 
@@ -226,32 +292,22 @@ bool SIMPLViewApplication::initialize(int argc, char* argv[])
 #endif
   QApplication::addLibraryPath(dir.absolutePath());
 
-  QMetaObjectUtilities::RegisterMetaTypes();
+  {
+    StartupTraceScope traceScope("RegisterMetaTypes");
+    QMetaObjectUtilities::RegisterMetaTypes();
+  }
 
   // Load application plugins.
-  QVector<ISIMPLibPlugin*> plugins = loadPlugins();
-
-  // give GUI components time to update before the mainwindow is shown
-  QApplication::instance()->processEvents();
-  if(m_ShowSplash)
+  QVector<ISIMPLibPlugin*> plugins;
   {
-    //   delay(1);
-    // if official release, enforce the minimum duration for splash screen
-    QString releaseType = QString::fromLatin1(SIMPLViewProj_RELEASE_TYPE);
-    if(releaseType.compare("Official") == 0)
-    {
-      double splashDuration = (std::clock() - startClock) / (double)CLOCKS_PER_SEC;
-      if(splashDuration < m_minSplashTime)
-      {
-        QString msg = QObject::tr("");
-        this->m_SplashScreen->showMessage(msg, Qt::AlignVCenter | Qt::AlignRight, Qt::white);
-
-        unsigned long extendedDuration = static_cast<unsigned long>((m_minSplashTime - splashDuration) * 1000);
-        QThread::msleep(extendedDuration);
-      }
-    }
-    this->m_SplashScreen->finish(nullptr);
+    StartupTraceScope traceScope("loadPlugins");
+    plugins = loadPlugins();
   }
+
+  // give GUI components time to update before the mainwindow is shown. The splash screen stays up
+  // while the first window is created, see finishSplashScreen()
+  QString msg = QObject::tr("");
+  this->m_SplashScreen->showMessage(msg, Qt::AlignVCenter | Qt::AlignRight, Qt::white);
   QApplication::instance()->processEvents();
 
   return true;
@@ -260,121 +316,72 @@ bool SIMPLViewApplication::initialize(int argc, char* argv[])
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-QVector<ISIMPLibPlugin*> SIMPLViewApplication::loadPlugins()
+void SIMPLViewApplication::finishSplashScreen(QWidget* mainWindow)
 {
-  QStringList pluginDirs;
-  pluginDirs << applicationDirPath();
-
-  QDir aPluginDir = QDir(applicationDirPath());
-  qDebug() << "Loading " << BrandedStrings::ApplicationName << " Plugins....";
-  QString thePath;
-
-#if defined(Q_OS_WIN)
-  if(aPluginDir.cd("Plugins"))
+  if(m_SplashScreen == nullptr)
   {
-    thePath = aPluginDir.absolutePath();
-    pluginDirs << thePath;
-  }
-#elif defined(Q_OS_MAC)
-  // Look to see if we are inside an .app package or inside the 'tools' directory
-  if(aPluginDir.dirName() == "MacOS")
-  {
-    aPluginDir.cdUp();
-    thePath = aPluginDir.absolutePath() + "/Plugins";
-    qDebug() << "  Adding Path " << thePath;
-    pluginDirs << thePath;
-    aPluginDir.cdUp();
-    aPluginDir.cdUp();
-    // We need this because Apple (in their infinite wisdom) changed how the current working directory is set in OS X 10.9 and above. Thanks Apple.
-    chdir(aPluginDir.absolutePath().toLatin1().constData());
-  }
-  if(aPluginDir.dirName() == "bin")
-  {
-    aPluginDir.cdUp();
-    // We need this because Apple (in their infinite wisdom) changed how the current working directory is set in OS X 10.9 and above. Thanks Apple.
-    chdir(aPluginDir.absolutePath().toLatin1().constData());
-  }
-  // aPluginDir.cd("Plugins");
-  thePath = aPluginDir.absolutePath() + "/Plugins";
-  qDebug() << "  Adding Path " << thePath;
-  pluginDirs << thePath;
-
-// This is here for Xcode compatibility
-#ifdef CMAKE_INTDIR
-  aPluginDir.cdUp();
-  thePath = aPluginDir.absolutePath() + "/Plugins/" + CMAKE_INTDIR;
-  pluginDirs << thePath;
-#endif
-#else
-  // We are on Linux - I think
-  // Try the current location of where the application was launched from which is
-  // typically the case when debugging from a build tree
-  if(aPluginDir.cd("Plugins"))
-  {
-    thePath = aPluginDir.absolutePath();
-    pluginDirs << thePath;
-    aPluginDir.cdUp(); // Move back up a directory level
+    return;
   }
 
-  if(thePath.isEmpty())
+  // if official release, enforce the minimum duration for splash screen. The time is counted from when
+  // the splash screen was shown so the plugin loading and window creation already count towards it, and
+  // the remainder is waited out in the event loop instead of blocking the GUI thread.
+  qint64 remaining = 0;
+  QString releaseType = QString::fromLatin1(SIMPLViewProj_RELEASE_TYPE);
+  if(m_ShowSplash && releaseType.compare("Official") == 0)
   {
-    // Now try moving up a directory which is what should happen when running from a
-    // proper distribution of SIMPLView
-    aPluginDir.cdUp();
-    if(aPluginDir.cd("Plugins"))
-    {
-      thePath = aPluginDir.absolutePath();
-      pluginDirs << thePath;
-      aPluginDir.cdUp(); // Move back up a directory level
-      int no_error = chdir(aPluginDir.absolutePath().toLatin1().constData());
-      if(no_error < 0)
-      {
-        qDebug() << "Could not set the working directory.";
-      }
-    }
+    remaining = m_minSplashTime * 1000 - m_SplashTimer.elapsed();
   }
-#endif
 
-  QByteArray pluginEnvPath = qgetenv("SIMPL_PLUGIN_PATH");
-  qDebug() << "SIMPL_PLUGIN_PATH:" << pluginEnvPath;
+  QSplashScreen* splashScreen = m_SplashScreen;
+  m_SplashScreen = nullptr;
+  QPointer<QWidget> window(mainWindow);
+  QTimer::singleShot(static_cast<int>(qMax(remaining, static_cast<qint64>(0))), [splashScreen, window] {
+    splashScreen->finish(window.data());
+    splashScreen->deleteLater();
+  });
+}
 
-  char sep = ';';
-#if defined(Q_OS_WIN)
-  sep = ':';
-#endif
-  QList<QByteArray> envPaths = pluginEnvPath.split(sep);
-  foreach(QByteArray envPath, envPaths)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<ISIMPLibPlugin*> SIMPLViewApplication::loadPlugins()
+{
+#ifdef SIMPLView_STATIC_PLUGINS
+  // The plugins are part of the executable so there is nothing to search for on disk
+  return loadStaticPlugins();
+#else
+  qDebug() << "Loading " << BrandedStrings::ApplicationName << " Plugins....";
+  QStringList pluginDirs = SIMPLViewPluginLoader::PluginDirectories(applicationDirPath());
+  QStringList pluginFilePaths;
+
+  // The manifest remembers what was found in each plugin directory during the last launch. A directory
+  // that has not been modified since then does not need to be enumerated again.
+  PluginManifest manifest;
   {
-    if(envPath.size() > 0)
-    {
-      pluginDirs << QString::fromLatin1(envPath);
-    }
+    StartupTraceScope traceScope("Read Plugin Manifest", "plugins");
+    manifest.read();
   }
 
-  int dupes = pluginDirs.removeDuplicates();
-  qDebug() << "Removed " << dupes << " duplicate Plugin Paths";
-  QStringList pluginFilePaths;
-
+  StartupTracer* tracer = StartupTracer::Instance();
+  qint64 scanStart = tracer->now();
   foreach(QString pluginDirString, pluginDirs)
   {
-    qDebug() << "Plugin Directory being Searched: " << pluginDirString;
-    aPluginDir = QDir(pluginDirString);
-    foreach(QString fileName, aPluginDir.entryList(QDir::Files))
+    QStringList dirPluginFilePaths;
+    if(manifest.findPluginFiles(pluginDirString, dirPluginFilePaths))
     {
-//   qDebug() << "File: " << fileName() << "\n";
-#ifdef QT_DEBUG
-      if(fileName.endsWith("_debug.guiplugin", Qt::CaseSensitive))
-#else
-      if(fileName.endsWith(".guiplugin", Qt::CaseSensitive)            // We want ONLY Release plugins
-         && !fileName.endsWith("_debug.guiplugin", Qt::CaseSensitive)) // so ignore these plugins
-#endif
-      {
-        pluginFilePaths << aPluginDir.absoluteFilePath(fileName);
-        // qWarning(aPluginDir.absoluteFilePath(fileName).toLatin1(), "%s");
-        // qDebug() << "Adding " << aPluginDir.absoluteFilePath(fileName)() << "\n";
-      }
+      qDebug() << "Plugin Directory unchanged since last scan: " << pluginDirString;
+      pluginFilePaths << dirPluginFilePaths;
+      continue;
     }
+
+    qDebug() << "Plugin Directory being Searched: " << pluginDirString;
+    dirPluginFilePaths = SIMPLViewPluginLoader::FindPluginFiles(pluginDirString, "guiplugin");
+    manifest.setPluginFiles(pluginDirString, dirPluginFilePaths);
+    pluginFilePaths << dirPluginFilePaths;
   }
+  manifest.prune(pluginFilePaths);
+  tracer->addSpan("Scan Plugin Directories", "plugins", scanStart, tracer->now() - scanStart);
 
   FilterManager* filterManager = FilterManager::Instance();
   FilterWidgetManager* fwm = FilterWidgetManager::Instance();
@@ -382,7 +389,10 @@ QVector<ISIMPLibPlugin*> SIMPLViewApplication::loadPlugins()
   // THIS IS A VERY IMPORTANT LINE: It will register all the known filters in the dream3d library. This
   // will NOT however get filters from plugins. We are going to have to figure out how to compile filters
   // into their own plugin and load the plugins from a command line.
-  FilterManager::RegisterKnownFilters(filterManager);
+  {
+    StartupTraceScope traceScope("RegisterKnownFilters", "plugins");
+    FilterManager::RegisterKnownFilters(filterManager);
+  }
 
   PluginManager* pluginManager = PluginManager::Instance();
   QList<PluginProxy::Pointer> proxies = AboutPlugins::readPluginCache();
@@ -393,16 +403,80 @@ QVector<ISIMPLibPlugin*> SIMPLViewApplication::loadPlugins()
     loadingMap.insert(proxy->getPluginName(), proxy->getEnabled());
   }
 
-  // Now that we have a sorted list of plugins, go ahead and load them all from the
-  // file system and add each to the toolbar and menu
+  // Plugins that are unchanged since the manifest was written can have their filters registered from the
+  // manifest. The plugin library itself is then only loaded once one of its filters is actually used.
+  QStringList eagerPluginFilePaths;
+  LazyPluginRegistry* lazyRegistry = LazyPluginRegistry::Instance();
   foreach(QString path, pluginFilePaths)
   {
+    PluginManifest::PluginEntry entry = manifest.entry(path);
+    if(m_LazyPluginLoading && manifest.isCurrent(path) && entry.registered && loadingMap.value(entry.pluginName, true))
+    {
+      lazyRegistry->addPlugin(entry);
+      continue;
+    }
+    eagerPluginFilePaths << path;
+  }
+  if(lazyRegistry->pendingPluginCount() > 0)
+  {
+    qDebug() << "Deferred loading of " << lazyRegistry->pendingPluginCount() << " Plugins until first use";
+  }
+
+  // Create a loader for every plugin file up front so that the libraries can be resolved concurrently.
+  QVector<QPluginLoader*> loaders;
+  loaders.reserve(eagerPluginFilePaths.size());
+  foreach(QString path, eagerPluginFilePaths)
+  {
+    loaders.push_back(new QPluginLoader(path));
+  }
+
+  if(m_ParallelPluginLoading && loaders.size() > 1)
+  {
+    // QPluginLoader::load() maps the library, resolves its symbols and runs the static initializers. None of
+    // that touches the GUI so it is done on the global thread pool. The root component of each plugin is
+    // still created below on the main thread so that the plugin objects live in the GUI thread and the
+    // filters are registered in the same order as they were found on disk.
+    QString msg = QObject::tr("Loading %1 Plugins  ").arg(loaders.size());
+    this->m_SplashScreen->showMessage(msg, Qt::AlignVCenter | Qt::AlignRight, Qt::white);
+
+    QFutureWatcher<void> watcher;
+    QEventLoop loop;
+    connect(&watcher, &QFutureWatcher<void>::progressValueChanged, [=](int progress) {
+      QString msg = QObject::tr("Loading Plugins (%1 of %2)  ").arg(progress).arg(loaders.size());
+      this->m_SplashScreen->showMessage(msg, Qt::AlignVCenter | Qt::AlignRight, Qt::white);
+    });
+    connect(&watcher, &QFutureWatcher<void>::finished, &loop, &QEventLoop::quit);
+    StartupTraceScope traceScope("Load Plugin Libraries", "plugins");
+    watcher.setFuture(QtConcurrent::map(loaders, [](QPluginLoader* loader) {
+      StartupTraceScope traceScope(QString("Load %1").arg(QFileInfo(loader->fileName()).fileName()), "plugins");
+      loader->load();
+    }));
+    if(!watcher.isFinished())
+    {
+      loop.exec();
+    }
+  }
+
+  // Now that we have a sorted list of plugins, go ahead and instantiate them all and add
+  // each to the toolbar and menu
+  for(int i = 0; i < loaders.size(); i++)
+  {
+    QPluginLoader* loader = loaders[i];
+    QString path = eagerPluginFilePaths[i];
     qDebug() << "Plugin Being Loaded:" << path;
-    QApplication::instance()->processEvents();
-    QPluginLoader* loader = new QPluginLoader(path);
+    if(!m_ParallelPluginLoading)
+    {
+      QApplication::instance()->processEvents();
+    }
     QFileInfo fi(path);
     QString fileName = fi.fileName();
-    QObject* plugin = loader->instance();
+    StartupTraceScope traceScope(QString("Register %1").arg(fileName), "plugins");
+    QObject* plugin = nullptr;
+    {
+      // When the libraries were not loaded in parallel this also includes loading the library
+      StartupTraceScope instanceTraceScope(QString("Instantiate %1").arg(fileName), "plugins");
+      plugin = loader->instance();
+    }
     qDebug() << "    Pointer: " << plugin << "\n";
     if(plugin != nullptr)
     {
@@ -412,7 +486,7 @@ QVector<ISIMPLibPlugin*> SIMPLViewApplication::loadPlugins()
         QString pluginName = ipPlugin->getPluginFileName();
         if(loadingMap.value(pluginName, true))
         {
-          QString msg = QObject::tr("Loading Plugin %1  ").arg(fileName);
+          QString msg = QObject::tr("Loading Plugin %1 (%2 of %3)  ").arg(fileName).arg(i + 1).arg(loaders.size());
           this->m_SplashScreen->showMessage(msg, Qt::AlignVCenter | Qt::AlignRight, Qt::white);
           // ISIMPLibPlugin::Pointer ipPluginPtr(ipPlugin);
           ipPlugin->registerFilterWidgets(fwm);
@@ -426,6 +500,11 @@ QVector<ISIMPLibPlugin*> SIMPLViewApplication::loadPlugins()
 
         ipPlugin->setLocation(path);
         pluginManager->addPlugin(ipPlugin);
+
+        if(!manifest.isCurrent(path) || manifest.entry(path).registered != ipPlugin->getDidLoad())
+        {
+          manifest.setEntry(createManifestEntry(ipPlugin, path));
+        }
       }
       m_PluginLoaders.push_back(loader);
     }
@@ -446,7 +525,116 @@ QVector<ISIMPLibPlugin*> SIMPLViewApplication::loadPlugins()
     }
   }
 
+  StartupTraceScope writeTraceScope("Write Plugin Manifest", "plugins");
+  if(!manifest.write())
+  {
+    qDebug() << "Could not write the plugin manifest to " << PluginManifest::DefaultFilePath();
+  }
+
   return pluginManager->getPluginsVector();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<ISIMPLibPlugin*> SIMPLViewApplication::loadStaticPlugins()
+{
+  FilterManager* filterManager = FilterManager::Instance();
+  FilterWidgetManager* fwm = FilterWidgetManager::Instance();
+  {
+    StartupTraceScope traceScope("RegisterKnownFilters", "plugins");
+    FilterManager::RegisterKnownFilters(filterManager);
+  }
+
+  PluginManager* pluginManager = PluginManager::Instance();
+  QList<PluginProxy::Pointer> proxies = AboutPlugins::readPluginCache();
+  QMap<QString, bool> loadingMap;
+  for(QList<PluginProxy::Pointer>::iterator nameIter = proxies.begin(); nameIter != proxies.end(); nameIter++)
+  {
+    PluginProxy::Pointer proxy = *nameIter;
+    loadingMap.insert(proxy->getPluginName(), proxy->getEnabled());
+  }
+
+  // Every plugin reports the executable as its location since there is no separate library file
+  QString location = QApplication::applicationFilePath();
+  QObjectList staticInstances = QPluginLoader::staticInstances();
+  for(int i = 0; i < staticInstances.size(); i++)
+  {
+    ISIMPLibPlugin* ipPlugin = qobject_cast<ISIMPLibPlugin*>(staticInstances[i]);
+    if(ipPlugin == nullptr)
+    {
+      // Qt's own static plugins (platforms, image formats) show up here as well
+      continue;
+    }
+
+    QString pluginName = ipPlugin->getPluginFileName();
+    StartupTraceScope traceScope(QString("Register %1").arg(pluginName), "plugins");
+    if(loadingMap.value(pluginName, true))
+    {
+      QString msg = QObject::tr("Loading Plugin %1  ").arg(pluginName);
+      this->m_SplashScreen->showMessage(msg, Qt::AlignVCenter | Qt::AlignRight, Qt::white);
+      ipPlugin->registerFilterWidgets(fwm);
+      ipPlugin->registerFilters(filterManager);
+      ipPlugin->setDidLoad(true);
+    }
+    else
+    {
+      ipPlugin->setDidLoad(false);
+    }
+
+    ipPlugin->setLocation(location);
+    pluginManager->addPlugin(ipPlugin);
+  }
+
+  return pluginManager->getPluginsVector();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PluginManifest::PluginEntry SIMPLViewApplication::createManifestEntry(ISIMPLibPlugin* plugin, const QString& filePath)
+{
+  PluginManifest::PluginEntry entry;
+  entry.filePath = filePath;
+  entry.pluginName = plugin->getPluginFileName();
+  entry.displayName = plugin->getPluginDisplayName();
+  entry.baseName = plugin->getPluginBaseName();
+  entry.version = plugin->getVersion();
+  entry.compatibilityVersion = plugin->getCompatibilityVersion();
+  entry.vendor = plugin->getVendor();
+  entry.url = plugin->getURL();
+  entry.description = plugin->getDescription();
+  entry.copyright = plugin->getCopyright();
+  entry.license = plugin->getLicense();
+  entry.registered = plugin->getDidLoad();
+  if(!entry.registered)
+  {
+    return entry;
+  }
+
+  FilterManager* filterManager = FilterManager::Instance();
+  QList<QString> filterNames = plugin->getFilters();
+  for(const QString& filterName : filterNames)
+  {
+    IFilterFactory::Pointer factory = filterManager->getFactoryFromClassName(filterName);
+    if(nullptr == factory)
+    {
+      continue;
+    }
+
+    PluginManifest::FilterEntry filterEntry;
+    filterEntry.className = factory->getFilterClassName();
+    filterEntry.uuid = factory->getUuid().toString();
+    filterEntry.humanLabel = factory->getFilterHumanLabel();
+    filterEntry.group = factory->getFilterGroup();
+    filterEntry.subGroup = factory->getFilterSubGroup();
+    filterEntry.brandingString = factory->getBrandingString();
+    filterEntry.compiledLibraryName = factory->getCompiledLibraryName();
+    filterEntry.htmlSummary = factory->getFilterHtmlSummary();
+    entry.filters.push_back(filterEntry);
+  }
+  return entry;
 }
 
 // -----------------------------------------------------------------------------
@@ -682,6 +870,21 @@ void SIMPLViewApplication::listenShowDataFolderTriggered()
   QtSFileUtils::ShowPathInGui(nullptr, dataDirectory);
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::listenShowPipelineJobsTriggered()
+{
+  if(m_PipelineJobsDialog.isNull())
+  {
+    m_PipelineJobsDialog = new PipelineJobsDialog(m_PipelineJobScheduler);
+    m_PipelineJobsDialog->setAttribute(Qt::WA_DeleteOnClose);
+  }
+  m_PipelineJobsDialog->show();
+  m_PipelineJobsDialog->raise();
+  m_PipelineJobsDialog->activateWindow();
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -745,6 +948,7 @@ void SIMPLViewApplication::versionCheckReply(UpdateCheckData* dataObj)
 // -----------------------------------------------------------------------------
 void SIMPLViewApplication::listenDisplayPluginInfoDialogTriggered()
 {
+  // Deferred plugins are listed through their DeferredPlugin entries without being loaded
   AboutPlugins dialog(nullptr);
   dialog.exec();
 
@@ -797,6 +1001,62 @@ SIMPLView_UI* SIMPLViewApplication::newInstanceFromFile(const QString& filePath)
   return ui;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewApplication::SingleInstanceModeRequested()
+{
+  QByteArray envValue = qgetenv("SIMPLVIEW_SINGLE_INSTANCE");
+  if(!envValue.isEmpty())
+  {
+    return envValue != "0";
+  }
+
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  bool singleInstance = prefs.value("Single Instance", QVariant(false)).toBool();
+  prefs.endGroup();
+  return singleInstance;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLViewApplication::startSingleInstanceServer()
+{
+  if(m_SingleInstanceServer == nullptr)
+  {
+    m_SingleInstanceServer = new SingleInstanceServer(this);
+    connect(m_SingleInstanceServer, SIGNAL(openRequested(const QStringList&)), this, SLOT(openForwardedFiles(const QStringList&)));
+  }
+  return m_SingleInstanceServer->listen();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::openForwardedFiles(const QStringList& filePaths)
+{
+  QList<SIMPLView_UI*> windows;
+  if(filePaths.isEmpty())
+  {
+    SIMPLView_UI* ui = getNewSIMPLViewInstance();
+    ui->show();
+    windows << ui;
+  }
+  foreach(QString filePath, filePaths)
+  {
+    windows << newInstanceFromFile(filePath);
+  }
+
+  // The request came from another process so the window manager will not raise the new windows on its own
+  foreach(SIMPLView_UI* ui, windows)
+  {
+    ui->raise();
+    ui->activateWindow();
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -805,11 +1065,24 @@ SIMPLView_UI* SIMPLViewApplication::getNewSIMPLViewInstance()
   PluginManager* pluginManager = PluginManager::Instance();
   QVector<ISIMPLibPlugin*> plugins = pluginManager->getPluginsVector();
 
-  // Create new SIMPLView instance
-  SIMPLView_UI* newInstance = new SIMPLView_UI(nullptr);
+  // A spare window that was built with another theme or preflight refresh delay would not follow them
+  if(m_SpareWindow != nullptr && Detail::spareWindowSettings() != m_SpareWindowSettings)
+  {
+    discardSpareWindow();
+  }
+
+  // Hand out the window that was built ahead of time, or create a new SIMPLView instance
+  StartupTraceScope traceScope("Create SIMPLView_UI", "window");
+  SIMPLView_UI* newInstance = m_SpareWindow;
+  m_SpareWindow = nullptr;
+  if(newInstance == nullptr)
+  {
+    newInstance = new SIMPLView_UI(nullptr);
+  }
   newInstance->setLoadedPlugins(plugins);
   newInstance->setAttribute(Qt::WA_DeleteOnClose);
   newInstance->setWindowTitle("[*]Untitled Pipeline - " + BrandedStrings::ApplicationName);
+  registerSIMPLViewWindow(newInstance);
 
   if(m_ActiveWindow != nullptr)
   {
@@ -820,9 +1093,68 @@ SIMPLView_UI* SIMPLViewApplication::getNewSIMPLViewInstance()
 
   connect(newInstance, SIGNAL(dream3dWindowChangedState(SIMPLView_UI*)), this, SLOT(dream3dWindowChanged(SIMPLView_UI*)));
 
+  scheduleSpareWindow();
+
   return newInstance;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::scheduleSpareWindow()
+{
+  if(!m_PreCreateWindows || !m_SpareWindowsEnabled || m_SpareWindow != nullptr || m_SpareWindowScheduled)
+  {
+    return;
+  }
+
+  // Wait long enough for the window that was just handed out to be shown and painted
+  m_SpareWindowScheduled = true;
+  QTimer::singleShot(500, this, SLOT(createSpareWindow()));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::setSpareWindowsEnabled(bool enabled)
+{
+  m_SpareWindowsEnabled = enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::createSpareWindow()
+{
+  m_SpareWindowScheduled = false;
+  if(m_SpareWindow != nullptr || !m_SpareWindowsEnabled)
+  {
+    return;
+  }
+
+  // Do not compete with a user who is busy with the application, try again once things are quiet
+  if(QApplication::activePopupWidget() != nullptr || QApplication::activeModalWidget() != nullptr || QApplication::mouseButtons() != Qt::NoButton)
+  {
+    scheduleSpareWindow();
+    return;
+  }
+
+  // The spare window is not registered until it is handed out so it does not show up in the list of
+  // open windows and does not keep the application alive.
+  StartupTraceScope traceScope("Create Spare SIMPLView_UI", "window");
+  m_SpareWindowSettings = Detail::spareWindowSettings();
+  m_SpareWindow = new SIMPLView_UI(nullptr);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLViewApplication::discardSpareWindow()
+{
+  delete m_SpareWindow;
+  m_SpareWindow = nullptr;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -963,6 +1295,10 @@ void SIMPLViewApplication::writeSettings()
   SVStyle* styles = SVStyle::Instance();
   QString themeFilePath = styles->getCurrentThemeFilePath();
   prefs->setValue("Theme File Path", themeFilePath);
+  prefs->setValue("Parallel Plugin Loading", m_ParallelPluginLoading);
+  prefs->setValue("Lazy Plugin Loading", m_LazyPluginLoading);
+  prefs->setValue("Single Instance", m_SingleInstanceMode);
+  prefs->setValue("Pre-Create Windows", m_PreCreateWindows);
 
   #if defined SIMPL_RELATIVE_PATH_CHECK
   SIMPLDataPathValidator* validator = SIMPLDataPathValidator::Instance();
@@ -990,11 +1326,16 @@ void SIMPLViewApplication::readSettings()
   SVStyle* styles = SVStyle::Instance();
   QString themeFilePath = prefs->value("Theme File Path", QString()).toString();
   QFileInfo fi(themeFilePath);
-  if(!themeFilePath.isEmpty() && BrandedStrings::LoadedThemeNames.contains(fi.baseName()))
+  if(!themeFilePath.isEmpty() && BrandedStrings::LoadedThemeNames.contains(fi.baseName()) && themeFilePath != styles->getCurrentThemeFilePath())
   {
-    styles->loadStyleSheet(themeFilePath);
+    StyleSheetCache::Instance()->loadTheme(themeFilePath);
   }
 
+  m_ParallelPluginLoading = prefs->value("Parallel Plugin Loading", QVariant(true)).toBool();
+  m_LazyPluginLoading = prefs->value("Lazy Plugin Loading", QVariant(false)).toBool();
+  m_SingleInstanceMode = prefs->value("Single Instance", QVariant(false)).toBool();
+  m_PreCreateWindows = prefs->value("Pre-Create Windows", QVariant(true)).toBool();
+
   #if defined SIMPL_RELATIVE_PATH_CHECK
   SIMPLDataPathValidator* validator = SIMPLDataPathValidator::Instance();
   QString dataDir = prefs->value("Data Directory", QString()).toString();
@@ -1035,6 +1376,9 @@ void SIMPLViewApplication::createDefaultMenuBar()
   m_ActionClearPipeline = new QAction("Clear Pipeline", m_DefaultMenuBar);
   m_ActionClearPipeline->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_Backspace));
 
+  m_ActionShowPipelineJobs = new QAction("Pipeline Jobs...", m_DefaultMenuBar);
+  connect(m_ActionShowPipelineJobs, &QAction::triggered, this, &SIMPLViewApplication::listenShowPipelineJobsTriggered);
+
   m_ActionUndo = new QAction("Undo", m_DefaultMenuBar);
   m_ActionUndo->setShortcut(QKeySequence::Undo);
 
@@ -1184,6 +1528,8 @@ void SIMPLViewApplication::createDefaultMenuBar()
   // Create Pipeline Menu
   m_DefaultMenuBar->addMenu(m_MenuPipeline);
   m_MenuPipeline->addAction(m_ActionClearPipeline);
+  m_MenuPipeline->addSeparator();
+  m_MenuPipeline->addAction(m_ActionShowPipelineJobs);
 
   // Create Help Menu
   m_DefaultMenuBar->addMenu(m_MenuHelp);
@@ -1228,7 +1574,7 @@ QMenu* SIMPLViewApplication::createThemeMenu(QActionGroup* actionGroup, QWidget*
 
   QString themePath = ":/SIMPL/StyleSheets/Default.json";
   QAction* action = menuThemes->addAction("Default", [=] {
-    style->loadStyleSheet(themePath);
+    StyleSheetCache::Instance()->loadTheme(themePath);
   });
   action->setCheckable(true);
   if(themePath == style->getCurrentThemeFilePath())
@@ -1242,7 +1588,7 @@ QMenu* SIMPLViewApplication::createThemeMenu(QActionGroup* actionGroup, QWidget*
   {
     QString themePath = BrandedStrings::DefaultStyleDirectory + QDir::separator() + themeNames[i] + ".json";
     QAction* action = menuThemes->addAction(themeNames[i], [=] {
-      style->loadStyleSheet(themePath);
+      StyleSheetCache::Instance()->loadTheme(themePath);
     });
     action->setCheckable(true);
     if(themePath == style->getCurrentThemeFilePath())
@@ -1283,3 +1629,11 @@ QMenu* SIMPLViewApplication::getRecentFilesMenu()
 {
   return m_MenuRecentFiles;
 }
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineJobScheduler* SIMPLViewApplication::getPipelineJobScheduler()
+{
+  return m_PipelineJobScheduler;
+}
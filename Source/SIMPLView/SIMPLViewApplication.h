@@ -35,6 +35,8 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
 #include <QtCore/QSet>
 #include <QtCore/QSharedPointer>
 
@@ -44,10 +46,15 @@
 
 #include "SVWidgetsLib/Dialogs/UpdateCheck.h"
 
+#include "SIMPLView/PluginManifest.h"
+
 #define dream3dApp (static_cast<SIMPLViewApplication*>(qApp))
 
+class PipelineJobScheduler;
+class PipelineJobsDialog;
 class QSplashScreen;
 class SIMPLView_UI;
+class SingleInstanceServer;
 class QPluginLoader;
 class ISIMPLibPlugin;
 class SIMPLViewToolbox;
@@ -80,6 +87,35 @@ public:
 
   bool initialize(int argc, char* argv[]);
 
+  /**
+   * @brief Closes the splash screen once the main window has been shown. In Official builds the splash screen
+   * stays up for at least the minimum splash time, which is waited out in the event loop.
+   * @param mainWindow
+   */
+  void finishSplashScreen(QWidget* mainWindow);
+
+  /**
+   * @brief Returns true if the "Single Instance" preference or the SIMPLVIEW_SINGLE_INSTANCE environment
+   * variable asks for launches to be forwarded to an already running SIMPLView. This is called from main()
+   * before the application object exists.
+   * @return
+   */
+  static bool SingleInstanceModeRequested();
+
+  /**
+   * @brief Starts accepting the windows and files that later launches ask to open, see SingleInstanceServer.
+   * @return
+   */
+  bool startSingleInstanceServer();
+
+  /**
+   * @brief Turns the hidden spare window of the "Pre-Create Windows" preference off or on for this session
+   * without changing the preference. The startup benchmark turns it off so that every window it measures is
+   * built from scratch.
+   * @param enabled
+   */
+  void setSpareWindowsEnabled(bool enabled);
+
   /**
    * @brief readSettings
    */
@@ -121,6 +157,12 @@ public:
    */
   QMenu* getRecentFilesMenu();
 
+  /**
+   * @brief Returns the scheduler that admits the pipeline runs of all windows
+   * @return
+   */
+  PipelineJobScheduler* getPipelineJobScheduler();
+
 public slots:
   void listenNewInstanceTriggered();
   void listenOpenPipelineTriggered();
@@ -133,11 +175,19 @@ public slots:
   void listenExitApplicationTriggered();
   void listenSetDataFolderTriggered();
   void listenShowDataFolderTriggered();
+  void listenShowPipelineJobsTriggered();
 
   SIMPLView_UI* getNewSIMPLViewInstance();
 
   SIMPLView_UI* newInstanceFromFile(const QString& filePath);
 
+  /**
+   * @brief Opens the files that another launch of SIMPLView forwarded to this process. An empty list
+   * opens a new, empty window.
+   * @param filePaths
+   */
+  void openForwardedFiles(const QStringList& filePaths);
+
   /**
   * @brief Updates the QMenu 'Recent Files' with the latest list of files. This
   * should be connected to the Signal QtSRecentFileList->fileListChanged
@@ -158,12 +208,58 @@ protected:
   QSplashScreen* m_SplashScreen;
   QVector<QPluginLoader*> m_PluginLoaders;
 
+  // When true the plugin libraries are loaded on the global thread pool before being registered
+  bool m_ParallelPluginLoading;
+
+  // When true the plugins that are described by the plugin manifest are only loaded on first use
+  bool m_LazyPluginLoading;
+
+  // When true later launches hand their files to this process instead of starting from scratch
+  bool m_SingleInstanceMode;
+  SingleInstanceServer* m_SingleInstanceServer;
+
+  // When true a hidden window is built during idle time so that the next New or Open can hand it out
+  bool m_PreCreateWindows;
+  bool m_SpareWindowsEnabled;
+  SIMPLView_UI* m_SpareWindow;
+  QString m_SpareWindowSettings;
+  bool m_SpareWindowScheduled;
+
+  // Admits the pipeline runs of all windows so that together they stay under the thread and memory caps
+  PipelineJobScheduler* m_PipelineJobScheduler;
+  QPointer<PipelineJobsDialog> m_PipelineJobsDialog;
+
   /**
-   * @brief loadPlugins
+   * @brief scheduleSpareWindow Builds the next spare window once the application is idle
+   */
+  void scheduleSpareWindow();
+
+  /**
+   * @brief loadPlugins Finds all of the .guiplugin files and loads them. Plugin directories that have not
+   * changed since the last launch are not enumerated again, see PluginManifest. If the "Lazy Plugin Loading"
+   * preference is on, plugins that are unchanged since the last launch are registered through proxy factories
+   * and only loaded when one of their filters is first created, see LazyPluginRegistry. The plugin libraries are
+   * loaded concurrently unless the "Parallel Plugin Loading" preference is turned off, but the filters
+   * and filter widgets are always registered on the main thread in the order the plugins were found.
    * @return
    */
   QVector<ISIMPLibPlugin*> loadPlugins();
 
+  /**
+   * @brief loadStaticPlugins Registers the plugins that were linked into the executable when it was built with
+   * SIMPLView_STATIC_PLUGINS. No plugin directories are searched and no libraries are loaded at runtime.
+   * @return
+   */
+  QVector<ISIMPLibPlugin*> loadStaticPlugins();
+
+  /**
+   * @brief createManifestEntry Collects the information about a loaded plugin that is stored in the plugin manifest
+   * @param plugin
+   * @param filePath
+   * @return
+   */
+  PluginManifest::PluginEntry createManifestEntry(ISIMPLibPlugin* plugin, const QString& filePath);
+
   /**
    * @brief checkForUpdatesAtStartup
    */
@@ -181,6 +277,17 @@ protected slots:
    */
   void dream3dWindowChanged(SIMPLView_UI* instance);
 
+  /**
+   * @brief createSpareWindow Builds the hidden window that getNewSIMPLViewInstance() hands out next
+   */
+  void createSpareWindow();
+
+  /**
+   * @brief discardSpareWindow Deletes the spare window, for example because it was built with preferences
+   * that have changed since
+   */
+  void discardSpareWindow();
+
 private:
   QMenuBar* m_DefaultMenuBar = nullptr;
   QMenu* m_DockMenu = nullptr;
@@ -218,6 +325,7 @@ private:
   QAction* m_ActionCopy = nullptr;
   QAction* m_ActionPaste = nullptr;
   QAction* m_ActionClearPipeline = nullptr;
+  QAction* m_ActionShowPipelineJobs = nullptr;
   QAction* m_ActionUndo = nullptr;
   QAction* m_ActionRedo = nullptr;
 
@@ -238,6 +346,7 @@ private:
   QActionGroup* m_ThemeActionGroup = nullptr;
 
   int m_minSplashTime;
+  QElapsedTimer m_SplashTimer;
 
 public:
   SIMPLViewApplication(const SIMPLViewApplication&) = delete; // Copy Constructor Not Implemented
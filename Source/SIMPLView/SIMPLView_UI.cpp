@@ -45,13 +45,16 @@
 #include <QtCore/QMimeData>
 #include <QtCore/QProcess>
 #include <QtCore/QString>
+#include <QtCore/QTemporaryFile>
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
 #include <QtCore/QUrl>
 #include <QtGui/QClipboard>
 #include <QtGui/QCloseEvent>
 #include <QtGui/QDesktopServices>
 #include <QtWidgets/QCheckBox>
 #include <QtWidgets/QFileDialog>
+#include <QtWidgets/QInputDialog>
 #include <QtWidgets/QListWidget>
 #include <QtWidgets/QScrollBar>
 #include <QtWidgets/QShortcut>
@@ -99,7 +102,13 @@
 #include "SVWidgetsLib/QtSupport/QtSHelpUrlGenerator.h"
 #endif
 
+#include "Common/ThreadBudget.h"
+
 #include "SIMPLView/AboutSIMPLView.h"
+#include "SIMPLView/LazyPluginRegistry.h"
+#include "SIMPLView/PipelineJobScheduler.h"
+#include "SIMPLView/PipelineProcessRunner.h"
+#include "SIMPLView/StartupTracer.h"
 #include "SIMPLView/SIMPLView.h"
 #include "SIMPLView/SIMPLViewApplication.h"
 #include "SIMPLView/SIMPLViewConstants.h"
@@ -122,21 +131,31 @@ SIMPLView_UI::SIMPLView_UI(QWidget* parent)
 
   // Register all the known filterWidgets
   m_FilterWidgetManager = FilterWidgetManager::Instance();
-  FilterWidgetManager::RegisterKnownFilterWidgets();
+  {
+    StartupTraceScope traceScope("RegisterKnownFilterWidgets", "window");
+    FilterWidgetManager::RegisterKnownFilterWidgets();
+  }
 
   // Calls the Parent Class to do all the Widget Initialization that were created
   // using the QDesigner program
-  m_Ui->setupUi(this);
-
-  dream3dApp->registerSIMPLViewWindow(this);
+  {
+    StartupTraceScope traceScope("setupUi", "window");
+    m_Ui->setupUi(this);
+  }
 
   // Do our own widget initializations
-  setupGui();
+  {
+    StartupTraceScope traceScope("setupGui", "window");
+    setupGui();
+  }
 
   this->setAcceptDrops(true);
 
   // Read various settings
-  readSettings();
+  {
+    StartupTraceScope traceScope("SIMPLView_UI::readSettings", "window");
+    readSettings();
+  }
   if(SIMPLView::DockWidgetSettings::HideDockSetting::OnError == IssuesWidget::GetHideDockSetting())
   {
     m_Ui->issuesDockWidget->setHidden(true);
@@ -321,7 +340,7 @@ void SIMPLView_UI::activateBookmark(const QString& filePath, bool execute)
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::closeEvent(QCloseEvent* event)
 {
-  if(m_Ui->pipelineListWidget->getPipelineView()->isPipelineCurrentlyRunning())
+  if(m_Ui->pipelineListWidget->getPipelineView()->isPipelineCurrentlyRunning() || m_ProcessRunner->isRunning())
   {
     QMessageBox runningPipelineBox;
     runningPipelineBox.setWindowTitle("Pipeline is Running");
@@ -503,6 +522,20 @@ void SIMPLView_UI::setupGui()
   // Set the IssuesWidget as a PipelineMessageObserver Object.
   viewWidget->addPipelineMessageObserver(m_Ui->issuesWidget);
 
+  m_ProcessRunner = new PipelineProcessRunner(this);
+
+  // Typing in a filter input widget preflights the pipeline for every key stroke. The preflight itself still
+  // runs synchronously in SVPipelineView; only the GUI work that follows it is done once the preflights have
+  // settled, for the last one.
+  QtSSettings prefs;
+  prefs.beginGroup("Application Settings");
+  int refreshDelay = prefs.value("Preflight Refresh Delay (ms)", QVariant(150)).toInt();
+  prefs.endGroup();
+  m_PreflightRefreshTimer = new QTimer(this);
+  m_PreflightRefreshTimer->setSingleShot(true);
+  m_PreflightRefreshTimer->setInterval(refreshDelay);
+  connect(m_PreflightRefreshTimer, &QTimer::timeout, this, &SIMPLView_UI::refreshAfterPreflight);
+
   createSIMPLViewMenuSystem();
 
   // Hook up the signals from the various docks to the PipelineViewWidget that will either add a filter
@@ -606,6 +639,9 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   m_ActionCheckForUpdates = new QAction("Check For Updates", this);
   m_ActionPluginInformation = new QAction("Plugin Information", this);
   m_ActionClearCache = new QAction("Reset Preferences", this);
+  m_ActionExecuteOutOfProcess = new QAction("Execute in Separate Process", this);
+  QAction* actionShowPipelineJobs = new QAction("Pipeline Jobs...", this);
+  QAction* actionThreadBudget = new QAction("Thread Budget...", this);
 
   // SIMPLView_UI Actions
   connect(m_ActionNew, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenNewInstanceTriggered);
@@ -619,6 +655,9 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   connect(m_ActionShowSIMPLViewHelp, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenShowSIMPLViewHelpTriggered);
   connect(m_ActionPluginInformation, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenDisplayPluginInfoDialogTriggered);
   connect(m_ActionClearCache, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenClearSIMPLViewCacheTriggered);
+  connect(m_ActionExecuteOutOfProcess, &QAction::triggered, this, &SIMPLView_UI::executePipelineOutOfProcess);
+  connect(actionShowPipelineJobs, &QAction::triggered, dream3dApp, &SIMPLViewApplication::listenShowPipelineJobsTriggered);
+  connect(actionThreadBudget, &QAction::triggered, this, &SIMPLView_UI::setThreadBudget);
 
   m_ActionNew->setShortcut(QKeySequence::New);
   m_ActionOpen->setShortcut(QKeySequence::Open);
@@ -628,6 +667,7 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   m_ActionCheckForUpdates->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_U));
   m_ActionShowSIMPLViewHelp->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_H));
   m_ActionPluginInformation->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_I));
+  m_ActionExecuteOutOfProcess->setShortcut(QKeySequence(Qt::CTRL + Qt::SHIFT + Qt::Key_E));
 
   // Pipeline View Actions
   SVPipelineView* viewWidget = m_Ui->pipelineListWidget->getPipelineView();
@@ -696,6 +736,15 @@ void SIMPLView_UI::createSIMPLViewMenuSystem()
   // Create Pipeline Menu
   m_SIMPLViewMenu->addMenu(m_MenuPipeline);
   m_MenuPipeline->addAction(actionClearPipeline);
+  m_MenuPipeline->addSeparator();
+  m_MenuPipeline->addAction(m_ActionExecuteOutOfProcess);
+  m_MenuPipeline->addAction(actionThreadBudget);
+  m_MenuPipeline->addAction(actionShowPipelineJobs);
+
+  // The budget only reaches runs in a child process; in this process the filters share the cap of the scheduler
+  actionThreadBudget->setToolTip("Limits the threads of the runs of this window that execute in a separate process");
+  connect(m_MenuPipeline, &QMenu::aboutToShow, [=] { actionThreadBudget->setEnabled(PipelineProcessRunner::OutOfProcessExecutionRequested()); });
+  actionThreadBudget->setEnabled(PipelineProcessRunner::OutOfProcessExecutionRequested());
 
   // Create Help Menu
   m_SIMPLViewMenu->addMenu(m_MenuHelp);
@@ -760,11 +809,27 @@ void SIMPLView_UI::connectSignalsSlots()
 
   /* Pipeline List Widget Connections */
   connect(m_Ui->pipelineListWidget, &PipelineListWidget::pipelineCanceled, pipelineView, &SVPipelineView::cancelPipeline);
+  connect(m_Ui->pipelineListWidget, &PipelineListWidget::pipelineCanceled, m_ProcessRunner, &PipelineProcessRunner::cancel);
+
+  /* Out of process execution */
+  connect(m_ProcessRunner, &PipelineProcessRunner::pipelineHasMessage, this, &SIMPLView_UI::processOutOfProcessMessage);
+  connect(m_ProcessRunner, &PipelineProcessRunner::pipelineFinished, this, &SIMPLView_UI::outOfProcessPipelineDidFinish);
+  connect(m_ProcessRunner, &PipelineProcessRunner::dataContainerArrayPublished, this, &SIMPLView_UI::outOfProcessResultsPublished);
+
+  /* Pipeline job scheduler */
+  connect(dream3dApp->getPipelineJobScheduler(), &PipelineJobScheduler::jobCanceled, this, [=](int id) {
+    if(id == m_ScheduledJob)
+    {
+      m_ScheduledJob = -1;
+      addStdOutputMessage("The queued pipeline was removed from the queue");
+    }
+  });
 
   /* Pipeline View Connections */
   connect(pipelineView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &SIMPLView_UI::filterSelectionChanged);
   connect(pipelineView, &SVPipelineView::filterParametersChanged, [=] (AbstractFilter::Pointer filter) {
-    m_Ui->dataBrowserWidget->filterActivated(filter);
+    m_ChangedFilter = filter;
+    m_PreflightRefreshTimer->start();
     markDocumentAsDirty();
   });
   connect(pipelineView, &SVPipelineView::clearDataStructureWidgetTriggered, [=] { m_Ui->dataBrowserWidget->filterActivated(AbstractFilter::NullPointer()); });
@@ -775,9 +840,10 @@ void SIMPLView_UI::connectSignalsSlots()
 
   // Connection that displays issues in the Issue Table when the preflight is finished
   connect(pipelineView, &SVPipelineView::preflightFinished, [=](int32_t pipelineFilterCount, int err) {
-    m_Ui->dataBrowserWidget->refreshData();
-    m_Ui->issuesWidget->displayCachedMessages();
-    m_Ui->pipelineListWidget->preflightFinished(pipelineFilterCount, err);
+    m_PreflightFilterCount = pipelineFilterCount;
+    m_PreflightError = err;
+    m_PreflightRefreshPending = true;
+    m_PreflightRefreshTimer->start();
   });
 
   connect(pipelineView, &SVPipelineView::pipelineHasMessage, this, &SIMPLView_UI::processPipelineMessage);
@@ -876,7 +942,191 @@ void SIMPLView_UI::handlePipelineChanges()
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::executePipeline()
 {
-  m_Ui->pipelineListWidget->getPipelineView()->executePipeline();
+  if(!flushPreflight())
+  {
+    return;
+  }
+
+  if(PipelineProcessRunner::OutOfProcessExecutionRequested())
+  {
+    executePipelineOutOfProcess();
+    return;
+  }
+  submitPipeline(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::executePipelineOutOfProcess()
+{
+  if(m_ProcessRunner->isRunning())
+  {
+    m_ProcessRunner->cancel();
+    return;
+  }
+  if(!flushPreflight())
+  {
+    return;
+  }
+  submitPipeline(true);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLView_UI::flushPreflight()
+{
+  // The issues and the data browser must show the last preflight before the pipeline starts. The preflight
+  // itself already ran when SVPipelineView reported it; only the refresh that follows it waits on the timer.
+  if(m_PreflightRefreshTimer->isActive())
+  {
+    m_PreflightRefreshTimer->stop();
+    refreshAfterPreflight();
+  }
+
+  if(m_PreflightError < 0)
+  {
+    statusBar()->showMessage("The pipeline was not started because its preflight failed");
+    addStdOutputMessage(QString("The pipeline was not started because its preflight failed with error %1, see the Issues").arg(m_PreflightError));
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::submitPipeline(bool outOfProcess)
+{
+  PipelineJobScheduler* scheduler = dream3dApp->getPipelineJobScheduler();
+  if(m_ScheduledJob >= 0)
+  {
+    scheduler->cancelQueued(m_ScheduledJob);
+    return;
+  }
+
+  SVPipelineView* viewWidget = m_Ui->pipelineListWidget->getPipelineView();
+  PipelineModel* model = getPipelineModel();
+  if(viewWidget->isPipelineCurrentlyRunning() || model->isEmpty())
+  {
+    return;
+  }
+
+  QVector<AbstractFilter::Pointer> filters;
+  for(int i = 0; i < model->rowCount(); i++)
+  {
+    filters.push_back(model->filter(model->index(i, PipelineItem::PipelineItemData::Contents)));
+  }
+  QString title = windowFilePath().isEmpty() ? QString("Untitled Pipeline") : QFileInfo(windowFilePath()).fileName();
+  // A run in this process can not be held to the budget of the window, so it does not claim it either
+  int threads = outOfProcess && m_MaxThreads > 0 ? m_MaxThreads : PipelineJobScheduler::ThreadsPerPipelineFromPreferences();
+  m_ProcessRunner->setMaxThreads(threads);
+
+  m_ScheduledJob = scheduler->submit(title, 0, threads, PipelineJobScheduler::EstimatePeakBytes(filters), this, [this, outOfProcess] {
+    if(outOfProcess)
+    {
+      if(!startPipelineOutOfProcess())
+      {
+        finishScheduledJob(-1);
+      }
+      return;
+    }
+    SVPipelineView* pipelineView = m_Ui->pipelineListWidget->getPipelineView();
+    if(getPipelineModel()->isEmpty() || pipelineView->isPipelineCurrentlyRunning())
+    {
+      finishScheduledJob(-1);
+      return;
+    }
+    m_PipelineError = 0;
+    // Arrays that are created through BufferPool::CreateArray() during the run recycle their storage
+    int bufferPoolMB = PipelineProcessRunner::BufferPoolMegabytesFromPreferences();
+    if(bufferPoolMB > 0)
+    {
+      m_BufferPool.reset(new BufferPool(static_cast<qint64>(bufferPoolMB) * 1024 * 1024));
+      m_BufferPoolScope.reset(new BufferPool::Scope(m_BufferPool.get()));
+    }
+    pipelineView->executePipeline();
+  });
+
+  if(scheduler->getUsedThreads() > 0 && scheduler->getUsedThreads() + threads > scheduler->getMaxThreads())
+  {
+    statusBar()->showMessage("The pipeline is queued until other pipelines finish");
+    addStdOutputMessage("The pipeline is queued until other pipelines finish, see Pipeline Jobs");
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::setThreadBudget()
+{
+  bool ok = false;
+  int threads = QInputDialog::getInt(this, "Thread Budget", "Threads for the runs of this window in a separate process (0 uses the preference):", m_MaxThreads, 0, ThreadBudget::DefaultThreads() * 4, 1, &ok);
+  if(ok)
+  {
+    m_MaxThreads = threads;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::finishScheduledJob(int err)
+{
+  // A run of the pipeline view that was started without the scheduler must not end a queued run
+  PipelineJobScheduler* scheduler = dream3dApp->getPipelineJobScheduler();
+  if(m_ScheduledJob < 0 || scheduler->isQueued(m_ScheduledJob))
+  {
+    return;
+  }
+  int id = m_ScheduledJob;
+  m_ScheduledJob = -1;
+  scheduler->finish(id, err);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SIMPLView_UI::startPipelineOutOfProcess()
+{
+  SVPipelineView* viewWidget = m_Ui->pipelineListWidget->getPipelineView();
+  if(viewWidget->isPipelineCurrentlyRunning() || getPipelineModel()->isEmpty())
+  {
+    return false;
+  }
+
+  // The child process reads the pipeline from a file, so the current state of the window is written out first
+  QTemporaryFile pipelineFile(QDir::temp().filePath("SIMPLView-XXXXXX.json"));
+  pipelineFile.setAutoRemove(false);
+  if(!pipelineFile.open())
+  {
+    statusBar()->showMessage("The pipeline could not be written to a temporary file");
+    return false;
+  }
+  m_OutOfProcessPipelineFile = pipelineFile.fileName();
+  pipelineFile.close();
+  if(viewWidget->writePipeline(m_OutOfProcessPipelineFile) < 0)
+  {
+    QFile::remove(m_OutOfProcessPipelineFile);
+    statusBar()->showMessage("The pipeline could not be written to a temporary file");
+    return false;
+  }
+
+  // The previous results stay mapped while the Data Browser shows them, so it lets go of them first
+  if(nullptr != m_OutOfProcessResults.get())
+  {
+    m_Ui->dataBrowserWidget->filterActivated(AbstractFilter::NullPointer());
+    m_OutOfProcessResults.reset();
+  }
+
+  // Stop filters from being added while the pipeline executes, the same as for a pipeline in this process
+  m_Ui->filterListWidget->blockSignals(true);
+  m_Ui->filterLibraryWidget->blockSignals(true);
+  m_Ui->pipelineListWidget->setProgressValue(0);
+  m_ActionExecuteOutOfProcess->setText("Cancel Separate Process");
+  addStdOutputMessage("Executing the pipeline in a separate process");
+  return m_ProcessRunner->start(m_OutOfProcessPipelineFile);
 }
 
 // -----------------------------------------------------------------------------
@@ -931,6 +1181,12 @@ void SIMPLView_UI::populateMenus(QObject* plugin)
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::processPipelineMessage(const PipelineMessage& msg)
 {
+  // The pipeline view only reports a failed run through its messages
+  if(msg.getType() == PipelineMessage::MessageType::Error && m_PipelineError >= 0)
+  {
+    m_PipelineError = msg.getCode() < 0 ? msg.getCode() : -1;
+  }
+
   if(msg.getType() == PipelineMessage::MessageType::ProgressValue)
   {
     float progValue = static_cast<float>(msg.getProgressValue()) / 100;
@@ -976,11 +1232,81 @@ void SIMPLView_UI::processPipelineMessage(const PipelineMessage& msg)
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::processOutOfProcessMessage(const PipelineMessage& msg)
+{
+  if(msg.getType() != PipelineMessage::MessageType::Error && msg.getType() != PipelineMessage::MessageType::Warning)
+  {
+    processPipelineMessage(msg);
+    return;
+  }
+
+  if(SIMPLView::DockWidgetSettings::HideDockSetting::OnError == StandardOutputWidget::GetHideDockSetting() ||
+     SIMPLView::DockWidgetSettings::HideDockSetting::OnStatusAndError == StandardOutputWidget::GetHideDockSetting())
+  {
+    m_Ui->stdOutDockWidget->setVisible(true);
+  }
+
+  QString kind = msg.getType() == PipelineMessage::MessageType::Error ? "Error" : "Warning";
+  addStdOutputMessage(QString("[%1] %2 %3 (%4): %5").arg(msg.getPipelineIndex() + 1).arg(msg.getFilterHumanLabel()).arg(kind).arg(msg.getCode()).arg(msg.getText()));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::outOfProcessPipelineDidFinish(int err, const QString& errorText)
+{
+  QFile::remove(m_OutOfProcessPipelineFile);
+  m_OutOfProcessPipelineFile.clear();
+  m_ActionExecuteOutOfProcess->setText("Execute in Separate Process");
+  finishScheduledJob(err);
+
+  if(err < 0)
+  {
+    addStdOutputMessage(errorText);
+    statusBar()->showMessage(errorText);
+    // Results that were published before the failure do not belong to a finished run
+    m_OutOfProcessResults.reset();
+  }
+  else
+  {
+    addStdOutputMessage("The pipeline finished in the separate process");
+  }
+  pipelineDidFinish();
+
+  if(err >= 0 && nullptr != m_OutOfProcessResults.get())
+  {
+    // The Data Browser shows the data of a filter, so the published results are handed to it through a filter
+    AbstractFilter::Pointer resultsHolder = AbstractFilter::New();
+    resultsHolder->setDataContainerArray(m_OutOfProcessResults->getDataContainerArray());
+    m_Ui->dataBrowserWidget->filterActivated(resultsHolder);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::outOfProcessResultsPublished(SharedDataContainerArray::Pointer results)
+{
+  m_OutOfProcessResults = results;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::pipelineDidFinish()
 {
+  finishScheduledJob(m_PipelineError);
+  m_PipelineError = 0;
+  if(nullptr != m_BufferPool.get())
+  {
+    m_BufferPoolScope.reset();
+    addStdOutputMessage(BufferPool::Summary(m_BufferPool->statistics()));
+    m_BufferPool.reset();
+  }
+
   // Re-enable FilterListToolboxWidget signals - resume adding filters
   m_Ui->filterListWidget->blockSignals(false);
 
@@ -1011,6 +1337,9 @@ void SIMPLView_UI::pipelineDidFinish()
 // -----------------------------------------------------------------------------
 void SIMPLView_UI::showFilterHelp(const QString& className)
 {
+  // The documentation is found through the plugin so make sure that it has been loaded
+  LazyPluginRegistry::Instance()->activatePluginForFilter(className);
+
 // Launch the dialog
 #ifdef SIMPL_USE_QtWebEngine
   SVUserManualDialog::LaunchHelpDialog(className);
@@ -1071,6 +1400,9 @@ void SIMPLView_UI::filterSelectionChanged(const QItemSelection& selected, const
   QModelIndexList selectedIndexes = pipelineView->selectionModel()->selectedRows();
   qSort(selectedIndexes);
 
+  // The selected filter replaces a filter whose changes are still waiting to be shown
+  m_ChangedFilter.reset();
+
   // Animate a selection border for selected indexes
   for(const QModelIndex& index : selected.indexes())
   {
@@ -1101,6 +1433,25 @@ void SIMPLView_UI::filterSelectionChanged(const QItemSelection& selected, const
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SIMPLView_UI::refreshAfterPreflight()
+{
+  if(nullptr != m_ChangedFilter.get())
+  {
+    m_Ui->dataBrowserWidget->filterActivated(m_ChangedFilter);
+    m_ChangedFilter.reset();
+  }
+  if(m_PreflightRefreshPending)
+  {
+    m_PreflightRefreshPending = false;
+    m_Ui->dataBrowserWidget->refreshData();
+    m_Ui->issuesWidget->displayCachedMessages();
+    m_Ui->pipelineListWidget->preflightFinished(m_PreflightFilterCount, m_PreflightError);
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
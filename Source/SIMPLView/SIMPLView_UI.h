@@ -38,6 +38,8 @@
 #pragma once
 
 
+#include <memory>
+
 //-- Qt Includes
 #include <QtCore/QObject>
 #include <QtCore/QString>
@@ -57,6 +59,9 @@
 #include "SVWidgetsLib/Widgets/FilterInputWidget.h"
 #include "SVWidgetsLib/QtSupport/QtSSettings.h"
 
+#include "Common/BufferPool.h"
+#include "Common/SharedDataContainerArray.h"
+
 //-- UIC generated Header
 #include "ui_SIMPLView_UI.h"
 
@@ -69,6 +74,7 @@ class UpdateCheckDialog;
 class UpdateCheckData;
 class UpdateCheck;
 class QToolButton;
+class QTimer;
 class AboutSIMPLView;
 class StatusBarWidget;
 class PipelineTreeView;
@@ -76,6 +82,7 @@ class PipelineModel;
 class PipelineListWidget;
 class SVPipelineViewWidget;
 class SIMPLViewMenuItems;
+class PipelineProcessRunner;
 
 /**
 * @class SIMPLView_UI SIMPLView_UI Applications/SIMPLView/SIMPLView_UI.h
@@ -133,10 +140,18 @@ class SIMPLView_UI : public QMainWindow
     int openPipeline(const QString& filePath);
 
     /**
-     * @brief executePipeline
+     * @brief Executes the pipeline, in a child process if PipelineProcessRunner::OutOfProcessExecutionRequested(),
+     * once the PipelineJobScheduler of the application admits it. This is the path of bookmarks that are
+     * activated for execution; the Start button of the pipeline view executes through SVPipelineView directly.
      */
     void executePipeline();
 
+    /**
+     * @brief Executes the pipeline in a child process once it is admitted, or cancels it if it is already
+     * running there
+     */
+    void executePipelineOutOfProcess();
+
     /**
      * @brief showDockWidget
      */
@@ -284,6 +299,33 @@ class SIMPLView_UI : public QMainWindow
      */
     void processPipelineMessage(const PipelineMessage& msg);
 
+    /**
+     * @brief Receives the messages of a pipeline that executes in a child process. Errors and warnings are
+     * written to the standard output widget, everything else goes to processPipelineMessage().
+     * @param msg
+     */
+    void processOutOfProcessMessage(const PipelineMessage& msg);
+
+    /**
+     * @brief Called when the pipeline that executed in a child process has finished
+     * @param err
+     * @param errorText
+     */
+    void outOfProcessPipelineDidFinish(int err, const QString& errorText);
+
+    /**
+     * @brief Keeps the DataContainerArray that a child process published until the next run, so that
+     * outOfProcessPipelineDidFinish() can show it in the Data Browser
+     * @param results
+     */
+    void outOfProcessResultsPublished(SharedDataContainerArray::Pointer results);
+
+    /**
+     * @brief Updates the data browser, the issues and the pipeline list after the preflights and parameter
+     * changes of the last "Preflight Refresh Delay (ms)" have settled, for the last of them only
+     */
+    void refreshAfterPreflight();
+
     /**
     * @brief setFilterInputWidget
     * @param widget
@@ -357,6 +399,23 @@ class SIMPLView_UI : public QMainWindow
     QAction*                                m_ActionClearCache = nullptr;
     QAction*                                m_ActionSetDataFolder = nullptr;
     QAction*                                m_ActionShowDataFolder = nullptr;
+    QAction*                                m_ActionExecuteOutOfProcess = nullptr;
+
+    PipelineProcessRunner*                  m_ProcessRunner = nullptr;
+    QString                                 m_OutOfProcessPipelineFile;
+    SharedDataContainerArray::Pointer       m_OutOfProcessResults;
+
+    QTimer*                                 m_PreflightRefreshTimer = nullptr;
+    AbstractFilter::Pointer                 m_ChangedFilter;
+    int32_t                                 m_PreflightFilterCount = 0;
+    int                                     m_PreflightError = 0;
+    bool                                    m_PreflightRefreshPending = false;
+
+    int                                     m_ScheduledJob = -1;
+    int                                     m_PipelineError = 0;
+    std::unique_ptr<BufferPool>             m_BufferPool;
+    std::unique_ptr<BufferPool::Scope>      m_BufferPoolScope;
+    int                                     m_MaxThreads = 0;
 
     QActionGroup*                           m_ThemeActionGroup = nullptr;
 
@@ -365,6 +424,38 @@ class SIMPLView_UI : public QMainWindow
      */
     void createSIMPLViewMenuSystem();
 
+    /**
+     * @brief Does the refresh of a pending preflight now so that the last preflight is shown
+     * @return false if that preflight failed, in which case the pipeline must not be started
+     */
+    bool flushPreflight();
+
+    /**
+     * @brief Queues the pipeline with the PipelineJobScheduler of the application. A second request while
+     * the pipeline is still queued takes it out of the queue again.
+     * @param outOfProcess
+     */
+    void submitPipeline(bool outOfProcess);
+
+    /**
+     * @brief Starts executing the pipeline in a child process
+     * @return false if it could not be started
+     */
+    bool startPipelineOutOfProcess();
+
+    /**
+     * @brief Asks for the number of threads the runs of this window in a child process may use, 0 for the
+     * "Threads Per Pipeline" preference. The action is only enabled while bookmarks execute out of process,
+     * because runs in the SIMPLView process can not be held to a budget of their own.
+     */
+    void setThreadBudget();
+
+    /**
+     * @brief Tells the PipelineJobScheduler that the run of this window is over
+     * @param err
+     */
+    void finishScheduledJob(int err);
+
     /**
      * @brief Connects all the dock widget specific signals and slots
      * @param dockWidget
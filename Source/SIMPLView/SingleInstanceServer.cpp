@@ -0,0 +1,219 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "SingleInstanceServer.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+#include "BrandedStrings.h"
+
+namespace
+{
+const QByteArray k_Reply("ok\n");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SingleInstanceServer::SingleInstanceServer(QObject* parent)
+: QObject(parent)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+SingleInstanceServer::~SingleInstanceServer() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString SingleInstanceServer::ServerName()
+{
+  QString user = QString::fromLocal8Bit(qgetenv("USER"));
+  if(user.isEmpty())
+  {
+    user = QString::fromLocal8Bit(qgetenv("USERNAME"));
+  }
+  if(user.isEmpty())
+  {
+    user = QDir::homePath();
+  }
+
+  // Hash the user name so that the socket name only contains characters that are valid on every platform
+  QByteArray userHash = QCryptographicHash::hash(user.toUtf8(), QCryptographicHash::Sha1).toHex().left(12);
+  QString appName = BrandedStrings::ApplicationName;
+  appName.remove(' ');
+  return QString("%1-%2").arg(appName).arg(QString::fromLatin1(userHash));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SingleInstanceServer::ForwardToRunningInstance(const QStringList& filePaths, int timeout)
+{
+  QLocalSocket socket;
+  socket.connectToServer(ServerName());
+  if(!socket.waitForConnected(timeout))
+  {
+    return false;
+  }
+
+  // The running instance has a different working directory so send absolute paths
+  QJsonArray files;
+  foreach(QString filePath, filePaths)
+  {
+    files.append(QFileInfo(filePath).absoluteFilePath());
+  }
+  QJsonObject request;
+  request["files"] = files;
+
+  socket.write(QJsonDocument(request).toJson(QJsonDocument::Compact));
+  socket.write("\n");
+  if(!socket.waitForBytesWritten(timeout))
+  {
+    return false;
+  }
+
+  // Only hand off when the running instance acknowledges the request. A process that is hung or
+  // shutting down never answers and this launch then starts normally.
+  QByteArray reply;
+  while(!reply.endsWith('\n'))
+  {
+    if(socket.bytesAvailable() == 0 && !socket.waitForReadyRead(timeout))
+    {
+      return false;
+    }
+    reply.append(socket.readAll());
+  }
+  socket.disconnectFromServer();
+  return reply == k_Reply;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SingleInstanceServer::listen()
+{
+  if(m_Server != nullptr)
+  {
+    return true;
+  }
+
+  QString name = ServerName();
+  QLocalServer* server = new QLocalServer(this);
+  server->setSocketOptions(QLocalServer::UserAccessOption);
+  if(!server->listen(name))
+  {
+    // A socket file that is left over from a process that crashed makes listen() fail as well. Only
+    // take it over when nobody is answering on it.
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if(probe.waitForConnected(500))
+    {
+      qDebug() << "Another instance is already listening on " << name;
+      delete server;
+      return false;
+    }
+    QLocalServer::removeServer(name);
+    if(!server->listen(name))
+    {
+      qDebug() << "Could not listen on " << name << ": " << server->errorString();
+      delete server;
+      return false;
+    }
+  }
+
+  connect(server, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+  m_Server = server;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SingleInstanceServer::isListening() const
+{
+  return m_Server != nullptr && m_Server->isListening();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SingleInstanceServer::acceptConnection()
+{
+  while(m_Server->hasPendingConnections())
+  {
+    QLocalSocket* socket = m_Server->nextPendingConnection();
+    connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+    connect(socket, &QLocalSocket::readyRead, this, [this, socket] {
+      if(!socket->canReadLine())
+      {
+        return;
+      }
+
+      QByteArray line = socket->readLine();
+      QJsonParseError parseError;
+      QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+      if(parseError.error != QJsonParseError::NoError || !doc.isObject())
+      {
+        qDebug() << "Ignoring malformed request from another instance: " << parseError.errorString();
+        socket->disconnectFromServer();
+        return;
+      }
+
+      QStringList filePaths;
+      QJsonArray files = doc.object()["files"].toArray();
+      for(QJsonValue file : files)
+      {
+        filePaths << file.toString();
+      }
+
+      // Answer before opening anything so the other process can exit right away
+      socket->write(k_Reply);
+      socket->flush();
+      emit openRequested(filePaths);
+    });
+  }
+}
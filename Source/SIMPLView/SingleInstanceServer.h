@@ -0,0 +1,106 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+class QLocalServer;
+
+/**
+ * @brief The SingleInstanceServer class lets a running SIMPLView process open the windows and files that a
+ * later launch was asked to open. The first process calls listen() once it has finished starting up. Each
+ * later launch calls ForwardToRunningInstance() before doing any of the expensive startup work and simply
+ * exits when the running process has accepted the request.
+ *
+ * A request is a single line of JSON terminated by a newline: {"files": ["/abs/path", ...]}. An empty file
+ * list asks for a new, empty window. The server answers with the line "ok".
+ */
+class SingleInstanceServer : public QObject
+{
+  Q_OBJECT
+
+public:
+  SingleInstanceServer(QObject* parent = nullptr);
+  ~SingleInstanceServer() override;
+
+  /**
+   * @brief Returns the name of the local socket. The name is unique per user so that several users on the
+   * same machine each get their own running instance.
+   * @return
+   */
+  static QString ServerName();
+
+  /**
+   * @brief Sends the files to an already running instance.
+   * @param filePaths Files to open. Relative paths are resolved against the current directory.
+   * @param timeout Milliseconds to wait for the running instance to answer
+   * @return true if a running instance accepted the request and this process can exit.
+   */
+  static bool ForwardToRunningInstance(const QStringList& filePaths, int timeout = 5000);
+
+  /**
+   * @brief Starts listening for requests from later launches.
+   * @return false if another live instance already owns the socket or the socket could not be created.
+   */
+  bool listen();
+
+  /**
+   * @brief isListening
+   * @return
+   */
+  bool isListening() const;
+
+signals:
+  /**
+   * @brief Emitted on the main thread for each request. An empty list asks for a new, empty window.
+   * @param filePaths
+   */
+  void openRequested(const QStringList& filePaths);
+
+protected slots:
+  void acceptConnection();
+
+private:
+  QLocalServer* m_Server = nullptr;
+
+public:
+  SingleInstanceServer(const SingleInstanceServer&) = delete;            // Copy Constructor Not Implemented
+  SingleInstanceServer(SingleInstanceServer&&) = delete;                 // Move Constructor Not Implemented
+  SingleInstanceServer& operator=(const SingleInstanceServer&) = delete; // Copy Assignment Not Implemented
+  SingleInstanceServer& operator=(SingleInstanceServer&&) = delete;      // Move Assignment Not Implemented
+};
@@ -0,0 +1,227 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "StartupTracer.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+
+StartupTracer* StartupTracer::self = nullptr;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StartupTracer::StartupTracer()
+{
+  m_Clock.start();
+
+  // The tracer is created by main() so this registers the main thread as thread 0
+  m_ThreadIndices.insert(QThread::currentThreadId(), 0);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StartupTracer::~StartupTracer() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StartupTracer* StartupTracer::Instance()
+{
+  if(self == nullptr)
+  {
+    self = new StartupTracer();
+  }
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void StartupTracer::setOutputFile(const QString& filePath)
+{
+  QMutexLocker locker(&m_Mutex);
+  m_OutputFile = filePath;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString StartupTracer::getOutputFile() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return m_OutputFile;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool StartupTracer::isEnabled() const
+{
+  QMutexLocker locker(&m_Mutex);
+  return !m_OutputFile.isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 StartupTracer::now() const
+{
+  return m_Clock.nsecsElapsed() / 1000;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void StartupTracer::addSpan(const QString& name, const QString& category, qint64 start, qint64 duration)
+{
+  QMutexLocker locker(&m_Mutex);
+  if(m_OutputFile.isEmpty())
+  {
+    return;
+  }
+
+  Span span;
+  span.name = name;
+  span.category = category;
+  span.start = start;
+  span.duration = duration;
+  span.thread = currentThreadIndex();
+  m_Spans.push_back(span);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int StartupTracer::currentThreadIndex()
+{
+  Qt::HANDLE threadId = QThread::currentThreadId();
+  if(!m_ThreadIndices.contains(threadId))
+  {
+    m_ThreadIndices.insert(threadId, m_ThreadIndices.size());
+  }
+  return m_ThreadIndices.value(threadId);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool StartupTracer::write()
+{
+  QMutexLocker locker(&m_Mutex);
+  if(m_OutputFile.isEmpty())
+  {
+    return false;
+  }
+
+  qint64 pid = QCoreApplication::applicationPid();
+  QJsonArray traceEvents;
+
+  // Name the threads so that the viewer shows "Main" instead of a bare thread id
+  for(int thread = 0; thread < m_ThreadIndices.size(); thread++)
+  {
+    QJsonObject args;
+    args["name"] = (thread == 0) ? QString("Main") : QString("Worker %1").arg(thread);
+    QJsonObject event;
+    event["name"] = QString("thread_name");
+    event["ph"] = QString("M");
+    event["pid"] = static_cast<double>(pid);
+    event["tid"] = thread;
+    event["args"] = args;
+    traceEvents.push_back(event);
+  }
+
+  for(const Span& span : m_Spans)
+  {
+    QJsonObject event;
+    event["name"] = span.name;
+    event["cat"] = span.category;
+    event["ph"] = QString("X");
+    event["ts"] = static_cast<double>(span.start);
+    event["dur"] = static_cast<double>(span.duration);
+    event["pid"] = static_cast<double>(pid);
+    event["tid"] = span.thread;
+    traceEvents.push_back(event);
+  }
+
+  QJsonObject root;
+  root["traceEvents"] = traceEvents;
+  root["displayTimeUnit"] = QString("ms");
+
+  QFileInfo fi(m_OutputFile);
+  QDir().mkpath(fi.absolutePath());
+  QFile file(m_OutputFile);
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    qDebug() << "Could not open the startup trace file " << m_OutputFile;
+    return false;
+  }
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StartupTraceScope::StartupTraceScope(const QString& name, const QString& category)
+{
+  StartupTracer* tracer = StartupTracer::Instance();
+  if(tracer->isEnabled())
+  {
+    m_Name = name;
+    m_Category = category;
+    m_Start = tracer->now();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StartupTraceScope::~StartupTraceScope()
+{
+  if(m_Start < 0)
+  {
+    return;
+  }
+  StartupTracer* tracer = StartupTracer::Instance();
+  tracer->addSpan(m_Name, m_Category, m_Start, tracer->now() - m_Start);
+}
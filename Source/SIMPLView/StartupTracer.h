@@ -0,0 +1,156 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+/**
+ * @brief The StartupTracer class records timestamped spans for the phases of the application startup and
+ * writes them out in the Chrome trace event format so that they can be viewed in chrome://tracing or
+ * https://ui.perfetto.dev. Tracing is off until an output file is set, either with the
+ * --startup-trace=<file> command line option or the SIMPLVIEW_STARTUP_TRACE environment variable. Spans
+ * are recorded with StartupTraceScope and may be recorded from any thread.
+ */
+class StartupTracer
+{
+public:
+  virtual ~StartupTracer();
+
+  /**
+   * @brief Returns the singleton instance. The first call starts the trace clock so this should be called
+   * as early as possible in main().
+   * @return
+   */
+  static StartupTracer* Instance();
+
+  /**
+   * @brief Sets the file that the trace is written to. An empty path disables tracing.
+   * @param filePath
+   */
+  void setOutputFile(const QString& filePath);
+
+  /**
+   * @brief getOutputFile
+   * @return
+   */
+  QString getOutputFile() const;
+
+  /**
+   * @brief isEnabled
+   * @return
+   */
+  bool isEnabled() const;
+
+  /**
+   * @brief Returns the number of microseconds since the trace clock was started
+   * @return
+   */
+  qint64 now() const;
+
+  /**
+   * @brief Adds a complete span to the trace for the calling thread
+   * @param name
+   * @param category
+   * @param start Start time in microseconds as returned by now()
+   * @param duration Duration in microseconds
+   */
+  void addSpan(const QString& name, const QString& category, qint64 start, qint64 duration);
+
+  /**
+   * @brief Writes all of the spans recorded so far to the output file
+   * @return
+   */
+  bool write();
+
+protected:
+  StartupTracer();
+
+  /**
+   * @brief Returns a small, stable id for the calling thread. The main thread is always 0.
+   * @return
+   */
+  int currentThreadIndex();
+
+private:
+  struct Span
+  {
+    QString name;
+    QString category;
+    qint64 start;
+    qint64 duration;
+    int thread;
+  };
+
+  static StartupTracer* self;
+
+  QElapsedTimer m_Clock;
+  QString m_OutputFile;
+  mutable QMutex m_Mutex;
+  QVector<Span> m_Spans;
+  QHash<Qt::HANDLE, int> m_ThreadIndices;
+
+public:
+  StartupTracer(const StartupTracer&) = delete;            // Copy Constructor Not Implemented
+  StartupTracer(StartupTracer&&) = delete;                 // Move Constructor Not Implemented
+  StartupTracer& operator=(const StartupTracer&) = delete; // Copy Assignment Not Implemented
+  StartupTracer& operator=(StartupTracer&&) = delete;      // Move Assignment Not Implemented
+};
+
+/**
+ * @brief The StartupTraceScope class records a span from its construction to its destruction. It does
+ * nothing when tracing is not enabled.
+ */
+class StartupTraceScope
+{
+public:
+  StartupTraceScope(const QString& name, const QString& category = QString("startup"));
+  ~StartupTraceScope();
+
+private:
+  QString m_Name;
+  QString m_Category;
+  qint64 m_Start = -1;
+
+public:
+  StartupTraceScope(const StartupTraceScope&) = delete;            // Copy Constructor Not Implemented
+  StartupTraceScope(StartupTraceScope&&) = delete;                 // Move Constructor Not Implemented
+  StartupTraceScope& operator=(const StartupTraceScope&) = delete; // Copy Assignment Not Implemented
+  StartupTraceScope& operator=(StartupTraceScope&&) = delete;      // Move Assignment Not Implemented
+};
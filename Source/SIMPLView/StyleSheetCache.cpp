@@ -0,0 +1,270 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "StyleSheetCache.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMetaProperty>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include <QtGui/QColor>
+#include <QtGui/QFont>
+
+#include <QtWidgets/QApplication>
+
+#include "SVWidgetsLib/Widgets/SVStyle.h"
+
+#include "SIMPLView/PluginManifest.h"
+
+namespace
+{
+const int k_CacheVersion = 1;
+const QString k_ThemePathProperty("CurrentThemeFilePath");
+}
+
+StyleSheetCache* StyleSheetCache::self = nullptr;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StyleSheetCache::StyleSheetCache() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StyleSheetCache::~StyleSheetCache() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+StyleSheetCache* StyleSheetCache::Instance()
+{
+  if(self == nullptr)
+  {
+    self = new StyleSheetCache();
+  }
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString StyleSheetCache::CacheDirectory()
+{
+  QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  return cacheDir + "/StyleSheets";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString StyleSheetCache::themeKey(const QString& themeFilePath) const
+{
+  QFileInfo fi(themeFilePath);
+  QString cssFilePath = fi.path() + "/" + fi.completeBaseName() + ".css";
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(QByteArray::number(k_CacheVersion));
+  hash.addData(PluginManifest::BuildId().toUtf8());
+  hash.addData(themeFilePath.toUtf8());
+  foreach(QString filePath, QStringList() << themeFilePath << cssFilePath)
+  {
+    QFile file(filePath);
+    if(file.open(QIODevice::ReadOnly))
+    {
+      hash.addData(file.readAll());
+    }
+  }
+  return QString::fromLatin1(hash.result().toHex());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool StyleSheetCache::loadTheme(const QString& themeFilePath)
+{
+  SVStyle* style = SVStyle::Instance();
+
+  // Without a way to restore the current theme path the menus and preferences would show the wrong theme
+  if(style->metaObject()->indexOfProperty(k_ThemePathProperty.toLatin1().constData()) < 0)
+  {
+    return style->loadStyleSheet(themeFilePath);
+  }
+
+  QString key = themeKey(themeFilePath);
+  QString cacheFilePath = CacheDirectory() + "/" + key + ".json";
+
+  QJsonObject cached = m_LoadedThemes.value(key);
+  if(cached.isEmpty())
+  {
+    QFile cacheFile(cacheFilePath);
+    if(cacheFile.open(QIODevice::ReadOnly))
+    {
+      cached = QJsonDocument::fromJson(cacheFile.readAll()).object();
+    }
+  }
+  if(!cached.isEmpty() && applyStyle(cached))
+  {
+    m_LoadedThemes.insert(key, cached);
+    return true;
+  }
+
+  // Not cached yet, so let SVStyle do the work and record the result
+  bool success = style->loadStyleSheet(themeFilePath);
+  if(!success)
+  {
+    return false;
+  }
+
+  cached = captureStyle();
+  if(cached.isEmpty())
+  {
+    return true;
+  }
+  m_LoadedThemes.insert(key, cached);
+
+  QDir().mkpath(CacheDirectory());
+  QSaveFile cacheFile(cacheFilePath);
+  if(cacheFile.open(QIODevice::WriteOnly))
+  {
+    cacheFile.write(QJsonDocument(cached).toJson(QJsonDocument::Compact));
+    if(!cacheFile.commit())
+    {
+      qDebug() << "Could not write the style sheet cache " << cacheFilePath;
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject StyleSheetCache::captureStyle() const
+{
+  SVStyle* style = SVStyle::Instance();
+  const QMetaObject* metaObject = style->metaObject();
+
+  QJsonArray properties;
+  for(int i = QObject::staticMetaObject.propertyCount(); i < metaObject->propertyCount(); i++)
+  {
+    QMetaProperty metaProperty = metaObject->property(i);
+    if(!metaProperty.isWritable())
+    {
+      continue;
+    }
+
+    QVariant value = metaProperty.read(style);
+    QJsonObject property;
+    property["Name"] = QString::fromLatin1(metaProperty.name());
+    property["Type"] = static_cast<int>(value.type());
+    switch(static_cast<QMetaType::Type>(value.type()))
+    {
+    case QMetaType::QColor:
+      property["Value"] = value.value<QColor>().name(QColor::HexArgb);
+      break;
+    case QMetaType::QFont:
+      property["Value"] = value.value<QFont>().toString();
+      break;
+    case QMetaType::QString:
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::Double:
+      property["Value"] = QJsonValue::fromVariant(value);
+      break;
+    default:
+      // A property that can not be stored would keep its value from the previous theme
+      qDebug() << "Style sheets are not cached, SVStyle property " << metaProperty.name() << " has an unsupported type";
+      return QJsonObject();
+    }
+    properties.append(property);
+  }
+
+  QJsonObject cached;
+  cached["StyleSheet"] = qApp->styleSheet();
+  cached["Properties"] = properties;
+  return cached;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool StyleSheetCache::applyStyle(const QJsonObject& cached) const
+{
+  SVStyle* style = SVStyle::Instance();
+
+  QJsonArray properties = cached["Properties"].toArray();
+  for(QJsonValue propertyValue : properties)
+  {
+    QJsonObject property = propertyValue.toObject();
+    QByteArray name = property["Name"].toString().toLatin1();
+    QVariant value;
+    switch(static_cast<QMetaType::Type>(property["Type"].toInt()))
+    {
+    case QMetaType::QColor:
+      value = QColor(property["Value"].toString());
+      break;
+    case QMetaType::QFont:
+    {
+      QFont font;
+      font.fromString(property["Value"].toString());
+      value = font;
+      break;
+    }
+    default:
+      value = property["Value"].toVariant();
+      value.convert(property["Type"].toInt());
+      break;
+    }
+    if(!style->setProperty(name.constData(), value))
+    {
+      return false;
+    }
+  }
+
+  // Re-applying an identical style sheet would still re-polish every widget in every open window
+  QString styleSheet = cached["StyleSheet"].toString();
+  if(qApp->styleSheet() != styleSheet)
+  {
+    qApp->setStyleSheet(styleSheet);
+  }
+  return true;
+}
@@ -0,0 +1,107 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+/**
+ * @brief The StyleSheetCache class loads SVStyle themes from a cache of already expanded style sheets. The first
+ * time a theme is loaded it goes through SVStyle::loadStyleSheet(), which parses the theme JSON and substitutes
+ * its variables into the CSS. The resulting application style sheet and the values of all of the SVStyle
+ * properties (colors, fonts, the current theme path) are then saved in the cache directory under a hash of
+ * the theme JSON and CSS. Later loads of the same theme, in this or a later launch, only apply that result.
+ */
+class StyleSheetCache
+{
+public:
+  virtual ~StyleSheetCache();
+
+  /**
+   * @brief Returns the singleton instance
+   * @return
+   */
+  static StyleSheetCache* Instance();
+
+  /**
+   * @brief Returns the directory that the expanded style sheets are written to
+   * @return
+   */
+  static QString CacheDirectory();
+
+  /**
+   * @brief Loads the theme at 'themeFilePath' from the cache or, if it is not cached yet, through SVStyle
+   * @param themeFilePath Path to the theme JSON file. The theme CSS is expected next to it with the same base name.
+   * @return
+   */
+  bool loadTheme(const QString& themeFilePath);
+
+protected:
+  StyleSheetCache();
+
+  /**
+   * @brief Returns the cache key for the theme, which changes whenever the theme files or the application do
+   * @param themeFilePath
+   * @return
+   */
+  QString themeKey(const QString& themeFilePath) const;
+
+  /**
+   * @brief Records the state that SVStyle::loadStyleSheet() left behind. Returns an empty object if one of
+   * the SVStyle properties can not be stored.
+   * @return
+   */
+  QJsonObject captureStyle() const;
+
+  /**
+   * @brief Restores the state recorded by captureStyle()
+   * @param cached
+   * @return
+   */
+  bool applyStyle(const QJsonObject& cached) const;
+
+private:
+  static StyleSheetCache* self;
+
+  QHash<QString, QJsonObject> m_LoadedThemes;
+
+public:
+  StyleSheetCache(const StyleSheetCache&) = delete;            // Copy Constructor Not Implemented
+  StyleSheetCache(StyleSheetCache&&) = delete;                 // Move Constructor Not Implemented
+  StyleSheetCache& operator=(const StyleSheetCache&) = delete; // Copy Assignment Not Implemented
+  StyleSheetCache& operator=(StyleSheetCache&&) = delete;      // Move Assignment Not Implemented
+};
@@ -33,19 +33,34 @@
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+#include <QtCore/QCoreApplication>
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
 #include <QtCore/QSettings>
 #include <QtCore/QString>
 #include <QtCore/QDirIterator>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QJsonDocument>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QTimer>
+
+#include <QtConcurrent/QtConcurrentMap>
 
 #include <QtGui/QFontDatabase>
 
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Filtering/QMetaObjectUtilities.h"
+#include "SIMPLib/Plugin/ISIMPLibPlugin.h"
+
+#include "Common/PipelineWorker.h"
+#include "Common/SIMPLViewPluginLoader.h"
+
 #include "BrandedStrings.h"
 #include "SIMPLView.h"
 #include "SIMPLViewApplication.h"
 #include "SIMPLView_UI.h"
+#include "SingleInstanceServer.h"
+#include "StartupTracer.h"
 #include "StyleSheetEditor.h"
 
 #include "SVWidgetsLib/QtSupport/QtSRecentFileList.h"
@@ -65,30 +80,141 @@
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void InitFonts(const QStringList& fontList)
+QByteArray ReadFontData(const QString& fontPath)
 {
-  int fontID(-1);
+  QFile res(fontPath);
+  // qDebug() << "font path: " << res.fileName();
+  if(!res.open(QIODevice::ReadOnly))
+  {
+    qDebug() << "ERROR opening font resource: " << res.fileName();
+    return QByteArray();
+  }
+  return res.readAll();
+}
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void RegisterFontData(const QByteArray& fontData)
+{
+  if(fontData.isEmpty())
+  {
+    return;
+  }
+  int fontID = QFontDatabase::addApplicationFontFromData(fontData);
+  // qDebug() << "loading font Id " << fontID;
+  if(fontID == -1)
+  {
+    qDebug() << "ERROR loading font id: " << fontID;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void InitFonts(const QStringList& fontList)
+{
   for(QStringList::const_iterator constIterator = fontList.constBegin(); constIterator != fontList.constEnd(); ++constIterator)
   {
-    QFile res(*constIterator);
-    // qDebug() << "font path: " << res.fileName();
-    if(!res.open(QIODevice::ReadOnly))
+    RegisterFontData(ReadFontData(*constIterator));
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Reads the fonts on the global thread pool while the first window is being
+// created and registers them on the main thread once the event loop is running.
+// Widgets that are already visible are told about the new fonts through the
+// QEvent::ApplicationFontChange event.
+// -----------------------------------------------------------------------------
+void InitFontsInBackground(const QStringList& fontList)
+{
+  if(fontList.isEmpty())
+  {
+    return;
+  }
+
+  QFutureWatcher<QByteArray>* watcher = new QFutureWatcher<QByteArray>(qApp);
+  QObject::connect(watcher, &QFutureWatcher<QByteArray>::finished, [watcher] {
+    StartupTraceScope traceScope("Register Deferred Fonts");
+    QList<QByteArray> fontData = watcher->future().results();
+    for(const QByteArray& data : fontData)
     {
-      qDebug() << "ERROR opening font resource: " << res.fileName();
+      RegisterFontData(data);
     }
+    watcher->deleteLater();
+  });
+  watcher->setFuture(QtConcurrent::mapped(fontList, ReadFontData));
+}
 
-    else
+// -----------------------------------------------------------------------------
+// Removes every "--name" or "--name=value" argument from argv so that the
+// remaining arguments can be handed to the QApplication and the file open logic
+// unchanged. Returns the value of the last matching argument and sets found.
+// -----------------------------------------------------------------------------
+QString TakeOption(int& argc, char* argv[], const QString& name, bool& found)
+{
+  QString flag = QString("--%1").arg(name);
+  QString prefix = flag + "=";
+  QString value;
+  int keep = 1;
+  for(int i = 1; i < argc; i++)
+  {
+    QString arg = QString::fromLocal8Bit(argv[i]);
+    if(arg == flag)
     {
-      fontID = QFontDatabase::addApplicationFontFromData(res.readAll());
-      // qDebug() << "loading font Id " << fontID;
-      if(fontID == -1)
-      {
-        qDebug() << "ERROR loading font id: " << fontID;
-      }
-      res.close();
+      found = true;
+      continue;
     }
+    if(arg.startsWith(prefix))
+    {
+      found = true;
+      value = arg.mid(prefix.size());
+      continue;
+    }
+    argv[keep++] = argv[i];
   }
+  argc = keep;
+  argv[argc] = nullptr;
+  return value;
+}
+
+// -----------------------------------------------------------------------------
+// Runs this executable as the child process of a PipelineProcessRunner. Only the filters are registered,
+// there is no QApplication, no window and no display connection.
+// -----------------------------------------------------------------------------
+int RunPipelineWorker(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setOrganizationDomain(BrandedStrings::OrganizationDomain);
+  QCoreApplication::setOrganizationName(BrandedStrings::OrganizationName);
+  QCoreApplication::setApplicationName(BrandedStrings::ApplicationName);
+
+  // The worker claims stdout for its events before the plugins can print anything
+  PipelineWorker worker;
+
+  FilterManager* filterManager = FilterManager::Instance();
+  FilterManager::RegisterKnownFilters(filterManager);
+#ifdef SIMPLView_STATIC_PLUGINS
+  for(QObject* instance : QPluginLoader::staticInstances())
+  {
+    ISIMPLibPlugin* plugin = qobject_cast<ISIMPLibPlugin*>(instance);
+    if(plugin != nullptr)
+    {
+      plugin->registerFilters(filterManager);
+    }
+  }
+#else
+  QStringList pluginFilePaths;
+  foreach(QString pluginDir, SIMPLViewPluginLoader::PluginDirectories(QCoreApplication::applicationDirPath()))
+  {
+    pluginFilePaths << SIMPLViewPluginLoader::FindPluginFiles(pluginDir, "guiplugin");
+  }
+  QVector<QPluginLoader*> loaders;
+  SIMPLViewPluginLoader::LoadPlugins(pluginFilePaths, filterManager, true, loaders);
+#endif
+  QMetaObjectUtilities::RegisterMetaTypes();
+
+  return worker.run();
 }
 
 // -----------------------------------------------------------------------------
@@ -107,6 +233,30 @@ void InitStyleSheetEditor()
 // -----------------------------------------------------------------------------
 int main(int argc, char* argv[])
 {
+  bool pipelineWorker = false;
+  TakeOption(argc, argv, "pipeline-worker", pipelineWorker);
+  if(pipelineWorker)
+  {
+    return RunPipelineWorker(argc, argv);
+  }
+
+  // Start the trace clock before anything else so that the trace covers all of startup
+  StartupTracer* tracer = StartupTracer::Instance();
+  bool traceRequested = false;
+  QString traceFile = TakeOption(argc, argv, "startup-trace", traceRequested);
+  if(traceFile.isEmpty())
+  {
+    traceFile = QString::fromLocal8Bit(qgetenv("SIMPLVIEW_STARTUP_TRACE"));
+  }
+  tracer->setOutputFile(traceFile);
+
+  bool singleInstance = false;
+  TakeOption(argc, argv, "single-instance", singleInstance);
+
+  // Used by the startup benchmark: open N more windows after startup, write the trace and exit
+  bool benchmarkMode = false;
+  int benchmarkWindows = TakeOption(argc, argv, "benchmark-windows", benchmarkMode).toInt();
+
 #ifdef Q_OS_X11
   // Using motif style gives us test failures (and its ugly).
   // Using cleanlooks style gives us errors when using valgrind (Trolltech's bug #179200)
@@ -144,11 +294,38 @@ int main(int argc, char* argv[])
   QCoreApplication::setOrganizationName(BrandedStrings::OrganizationName);
   QCoreApplication::setApplicationName(BrandedStrings::ApplicationName);
 
+  // If another SIMPLView is already running, hand it the files to open and exit before any of the
+  // expensive startup work is done
+  singleInstance = !benchmarkMode && (singleInstance || SIMPLViewApplication::SingleInstanceModeRequested());
+  if(singleInstance)
+  {
+    QStringList filePaths;
+    for(int i = 1; i < argc; i++)
+    {
+      filePaths << QString::fromLocal8Bit(argv[i]);
+    }
+    if(SingleInstanceServer::ForwardToRunningInstance(filePaths))
+    {
+      qDebug() << "Forwarded the launch to the running instance";
+      return 0;
+    }
+  }
+
+  qint64 appBegin = tracer->now();
   SIMPLViewApplication qtapp(argc, argv);
+  tracer->addSpan("Construct SIMPLViewApplication", "startup", appBegin, tracer->now() - appBegin);
+  if(benchmarkMode)
+  {
+    // Whether a pre-built spare window is handed out would depend on timing, so every window is built
+    qtapp.setSpareWindowsEnabled(false);
+  }
 
-  if(!qtapp.initialize(argc, argv))
   {
-    return 1;
+    StartupTraceScope traceScope("Initialize SIMPLViewApplication");
+    if(!qtapp.initialize(argc, argv))
+    {
+      return 1;
+    }
   }
 
 #if defined(Q_OS_MAC)
@@ -159,41 +336,80 @@ int main(int argc, char* argv[])
 
   setlocale(LC_NUMERIC, "C");
 
-  // Load the default font from SIMPL
+  // Load the default font faces from SIMPL. These are needed to lay out the first window.
   QStringList fontList;
-  fontList << QString(":/SIMPL/fonts/FiraSans-Regular.ttf") << QString(":/SIMPL/fonts/Lato-Regular.ttf") << QString(":/SIMPL/fonts/Lato-Black.ttf") << QString(":/SIMPL/fonts/Lato-BlackItalic.ttf")
-           << QString(":/SIMPL/fonts/Lato-Bold.ttf") << QString(":/SIMPL/fonts/Lato-BoldItalic.ttf") << QString(":/SIMPL/fonts/Lato-Hairline.ttf") << QString(":/SIMPL/fonts/Lato-HairlineItalic.ttf")
-           << QString(":/SIMPL/fonts/Lato-Italic.ttf") << QString(":/SIMPL/fonts/Lato-Light.ttf") << QString(":/SIMPL/fonts/Lato-LightItalic.ttf");
+  fontList << QString(":/SIMPL/fonts/FiraSans-Regular.ttf") << QString(":/SIMPL/fonts/Lato-Regular.ttf");
 
-  InitFonts(fontList);
+  {
+    StartupTraceScope traceScope("InitFonts");
+    InitFonts(fontList);
+  }
 
-  // Init any extra fonts that are needed by specialized versions of SIMPLView
-  InitFonts(BrandedStrings::ExtraFonts);
+  // The remaining weights and styles, and any extra fonts that are needed by specialized versions of
+  // SIMPLView, are registered after the first window is up.
+  QStringList deferredFontList;
+  deferredFontList << QString(":/SIMPL/fonts/Lato-Black.ttf") << QString(":/SIMPL/fonts/Lato-BlackItalic.ttf") << QString(":/SIMPL/fonts/Lato-Bold.ttf")
+                   << QString(":/SIMPL/fonts/Lato-BoldItalic.ttf") << QString(":/SIMPL/fonts/Lato-Hairline.ttf") << QString(":/SIMPL/fonts/Lato-HairlineItalic.ttf")
+                   << QString(":/SIMPL/fonts/Lato-Italic.ttf") << QString(":/SIMPL/fonts/Lato-Light.ttf") << QString(":/SIMPL/fonts/Lato-LightItalic.ttf");
+  deferredFontList << BrandedStrings::ExtraFonts;
+  InitFontsInBackground(deferredFontList);
 
 #ifdef SIMPLView_USE_STYLESHEETEDITOR
   InitStyleSheetEditor();
 #endif
 
   // Open pipeline if SIMPLView was opened from a compatible file
+  SIMPLView_UI* ui = nullptr;
   if(argc == 2)
   {
     char* two = argv[1];
     QString filePath = QString::fromLatin1(two);
     if(!filePath.isEmpty())
     {
-      qtapp.newInstanceFromFile(filePath);
+      ui = qtapp.newInstanceFromFile(filePath);
     }
   }
   else
   {
-    SIMPLView_UI* ui = qtapp.getNewSIMPLViewInstance();
+    ui = qtapp.getNewSIMPLViewInstance();
+    StartupTraceScope traceScope("Show SIMPLView_UI");
     ui->show();
   }
+  qtapp.finishSplashScreen(ui);
 
 #ifdef SIMPL_USE_MKDOCS
   QtSDocServer::Instance();
 #endif
 
+  // Only start serving once the plugins are loaded so forwarded files always open in a fully initialized process
+  if(singleInstance && !qtapp.startSingleInstanceServer())
+  {
+    qDebug() << "Single instance mode is not available, another instance may already be serving";
+  }
+
+  if(tracer->isEnabled() || benchmarkMode)
+  {
+    // The first pass through the event loop paints the main window, which is
+    // where startup ends from the user's point of view.
+    QTimer::singleShot(0, [tracer, &qtapp, benchmarkMode, benchmarkWindows] {
+      tracer->addSpan("Startup", "startup", 0, tracer->now());
+      for(int i = 0; i < benchmarkWindows; i++)
+      {
+        SIMPLView_UI* window = qtapp.getNewSIMPLViewInstance();
+        window->show();
+        QApplication::processEvents();
+      }
+      if(tracer->write())
+      {
+        qDebug() << "Wrote startup trace to " << tracer->getOutputFile();
+      }
+      if(benchmarkMode)
+      {
+        QCoreApplication::exit(0);
+      }
+    });
+  }
+
   int err = SIMPLViewApplication::exec();
   return err;
 }
@@ -0,0 +1,236 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "UnitTestSupport.hpp"
+
+#include "Common/BufferPool.h"
+
+class BufferPoolTest
+{
+public:
+  BufferPoolTest() = default;
+  ~BufferPoolTest() = default;
+
+  // -----------------------------------------------------------------------------
+  // Returns one value of the statistics of 'pool'
+  // -----------------------------------------------------------------------------
+  qint64 Statistic(const BufferPool& pool, const QString& key)
+  {
+    return static_cast<qint64>(pool.statistics()[key].toDouble());
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestClassSize()
+  {
+    const size_t megabyte = 1024 * 1024;
+    DREAM3D_REQUIRE_EQUAL(BufferPool::ClassSize(megabyte), megabyte)
+    DREAM3D_REQUIRE_EQUAL(BufferPool::ClassSize(megabyte + 1), megabyte + megabyte / 8)
+    DREAM3D_REQUIRE_EQUAL(BufferPool::ClassSize(100 * megabyte), 104 * megabyte)
+    // At most an eighth is wasted
+    for(size_t size = megabyte; size < 64 * megabyte; size += 777777)
+    {
+      DREAM3D_REQUIRE(BufferPool::ClassSize(size) >= size)
+      DREAM3D_REQUIRE(BufferPool::ClassSize(size) - size <= size / 8)
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestAllocateReleaseReuse()
+  {
+    const size_t size = 3 * 1024 * 1024;
+    const qint64 classSize = static_cast<qint64>(BufferPool::ClassSize(size));
+    BufferPool pool(64 * 1024 * 1024);
+
+    void* first = pool.allocate(size);
+    DREAM3D_REQUIRE(nullptr != first)
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "misses"), 1)
+    pool.release(first, size);
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "pooledBytes"), classSize)
+
+    // A size of the same class gets the freed block back
+    void* second = pool.allocate(size - 1000);
+    DREAM3D_REQUIRE(second == first)
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "hits"), 1)
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "pooledBytes"), 0)
+
+    // Another size class does not
+    void* other = pool.allocate(2 * size);
+    DREAM3D_REQUIRE(other != first)
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "misses"), 2)
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "allocations"), 3)
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "highWaterBytes"), classSize + static_cast<qint64>(BufferPool::ClassSize(2 * size)))
+
+    pool.release(second, size - 1000);
+    pool.release(other, 2 * size);
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "peakPooledBytes"), Statistic(pool, "pooledBytes"))
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestTrimAndLimit()
+  {
+    const size_t size = 4 * 1024 * 1024;
+    const qint64 classSize = static_cast<qint64>(BufferPool::ClassSize(size));
+    BufferPool pool(classSize);
+
+    void* first = pool.allocate(size);
+    void* second = pool.allocate(size);
+    pool.release(first, size);
+    // Only one block fits under the limit, the other one goes back to the system
+    pool.release(second, size);
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "pooledBytes"), classSize)
+
+    pool.trim();
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "pooledBytes"), 0)
+    void* third = pool.allocate(size);
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "hits"), 0)
+    DREAM3D_REQUIRE_EQUAL(Statistic(pool, "misses"), 3)
+    pool.release(third, size);
+
+    // A pool without room keeps nothing
+    BufferPool none(0);
+    void* block = none.allocate(size);
+    none.release(block, size);
+    DREAM3D_REQUIRE_EQUAL(Statistic(none, "pooledBytes"), 0)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestCreateArray()
+  {
+    const size_t numTuples = 1024 * 1024;
+    QVector<size_t> cDims(1, 1);
+
+    // Without an installed pool the array owns its storage as usual
+    FloatArrayType::Pointer plain = BufferPool::CreateArray<float>(numTuples, cDims, "Plain");
+    DREAM3D_REQUIRE(nullptr != plain.get())
+    DREAM3D_REQUIRE_EQUAL(plain->getNumberOfTuples(), numTuples)
+
+    BufferPool pool(64 * 1024 * 1024);
+    {
+      BufferPool::Scope scope(&pool);
+      DREAM3D_REQUIRE(scope.isInstalled())
+      DREAM3D_REQUIRE(BufferPool::Current() == &pool)
+
+      // Only one pool is installed at a time
+      BufferPool other(0);
+      BufferPool::Scope otherScope(&other);
+      DREAM3D_REQUIRE(!otherScope.isInstalled())
+
+      FloatArrayType::Pointer array = BufferPool::CreateArray<float>(numTuples, cDims, "Pooled");
+      DREAM3D_REQUIRE(nullptr != array.get())
+      DREAM3D_REQUIRE_EQUAL(array->getNumberOfTuples(), numTuples)
+      void* storage = array->getVoidPointer(0);
+      array->setValue(numTuples - 1, 1.5f);
+      DREAM3D_REQUIRE_EQUAL(Statistic(pool, "misses"), 1)
+
+      // The storage goes back when the last reference to the array does
+      IDataArray::Pointer held = array;
+      array.reset();
+      DREAM3D_REQUIRE_EQUAL(Statistic(pool, "pooledBytes"), 0)
+      held.reset();
+      DREAM3D_REQUIRE(Statistic(pool, "pooledBytes") > 0)
+
+      Int32ArrayType::Pointer reused = BufferPool::CreateArray<int32_t>(numTuples, cDims, "Reused");
+      DREAM3D_REQUIRE(reused->getVoidPointer(0) == storage)
+      DREAM3D_REQUIRE_EQUAL(Statistic(pool, "hits"), 1)
+
+      // Small arrays are not worth pooling
+      Int32ArrayType::Pointer small = BufferPool::CreateArray<int32_t>(10, cDims, "Small");
+      DREAM3D_REQUIRE_EQUAL(Statistic(pool, "allocations"), 2)
+    }
+    DREAM3D_REQUIRE(nullptr == BufferPool::Current())
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestArrayOutlivesPool()
+  {
+    FloatArrayType::Pointer array;
+    {
+      BufferPool pool(64 * 1024 * 1024);
+      BufferPool::Scope scope(&pool);
+      array = BufferPool::CreateArray<float>(1024 * 1024, QVector<size_t>(1, 1), "Kept");
+    }
+    // The storage stays valid after the run and is freed with the array
+    array->setValue(0, 2.0f);
+    DREAM3D_REQUIRE_EQUAL(array->getValue(0), 2.0f)
+    array.reset();
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    std::cout << "#### BufferPoolTest Starting ####" << std::endl;
+
+    DREAM3D_REGISTER_TEST(TestClassSize())
+    DREAM3D_REGISTER_TEST(TestAllocateReleaseReuse())
+    DREAM3D_REGISTER_TEST(TestTrimAndLimit())
+    DREAM3D_REGISTER_TEST(TestCreateArray())
+    DREAM3D_REGISTER_TEST(TestArrayOutlivesPool())
+  }
+
+public:
+  BufferPoolTest(const BufferPoolTest&) = delete;            // Copy Constructor Not Implemented
+  BufferPoolTest(BufferPoolTest&&) = delete;                 // Move Constructor Not Implemented
+  BufferPoolTest& operator=(const BufferPoolTest&) = delete; // Copy Assignment Not Implemented
+  BufferPoolTest& operator=(BufferPoolTest&&) = delete;      // Move Assignment Not Implemented
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  Q_UNUSED(argc)
+  Q_UNUSED(argv)
+
+  int err = EXIT_SUCCESS;
+  BufferPoolTest test;
+  test();
+  PRINT_TEST_SUMMARY();
+  return err;
+}
@@ -0,0 +1,316 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <QtCore/QDirIterator>
+#include <QtCore/QTemporaryDir>
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "Common/PipelineLiveness.h"
+
+#include "SyntheticPipeline.h"
+
+using SyntheticPipeline::CreateFilter;
+using SyntheticPipeline::Path;
+
+class PipelineLivenessTest
+{
+public:
+  PipelineLivenessTest() = default;
+  ~PipelineLivenessTest() = default;
+
+  // -----------------------------------------------------------------------------
+  // Returns the paths as sorted "DC/AM/Array" strings
+  // -----------------------------------------------------------------------------
+  QStringList Paths(const QVector<DataArrayPath>& paths)
+  {
+    QStringList strings;
+    for(const DataArrayPath& path : paths)
+    {
+      strings << path.serialize("/");
+    }
+    strings.sort();
+    return strings;
+  }
+
+  // -----------------------------------------------------------------------------
+  // Returns the number of .dream3d files below 'directory'
+  // -----------------------------------------------------------------------------
+  int CountFiles(const QString& directory)
+  {
+    int count = 0;
+    QDirIterator iter(directory, QStringList() << "*.dream3d", QDir::Files, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+      iter.next();
+      count++;
+    }
+    return count;
+  }
+
+  // -----------------------------------------------------------------------------
+  // A pipeline that creates A/Cell/x, then the unrelated B/Cell/y and B/Cell/z, and then writes everything
+  // to a file
+  // -----------------------------------------------------------------------------
+  FilterPipeline::FilterContainerType WriterPipeline()
+  {
+    FilterPipeline::FilterContainerType filters;
+    filters << CreateFilter({{"DataArrayCreationWidget", Path("A", "Cell", "x")}}, {"A/Cell/x"});
+    filters << CreateFilter({{"DataArrayCreationWidget", Path("B", "Cell", "y")}}, {"A/Cell/x", "B/Cell/y"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("B", "Cell", "y")}, {"DataArrayCreationWidget", Path("B", "Cell", "z")}}, {"A/Cell/x", "B/Cell/y", "B/Cell/z"});
+    filters << CreateFilter({{"OutputFileWidget", "Result.dream3d"}, {"BooleanWidget", true}}, {"A/Cell/x", "B/Cell/y", "B/Cell/z"});
+    return filters;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestReleaseAfterLastUse()
+  {
+    FilterPipeline::FilterContainerType filters;
+    filters << CreateFilter({{"DataArrayCreationWidget", Path("A", "Cell", "x")}, {"DataArrayCreationWidget", Path("A", "Cell", "y")}}, {"A/Cell/x", "A/Cell/y"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("A", "Cell", "x")}, {"DataArrayCreationWidget", Path("A", "Cell", "z")}}, {"A/Cell/x", "A/Cell/y", "A/Cell/z"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("A", "Cell", "y")}, {"DataArrayCreationWidget", Path("A", "Cell", "w")}}, {"A/Cell/x", "A/Cell/y", "A/Cell/z", "A/Cell/w"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("A", "Cell", "z")}}, {"A/Cell/x", "A/Cell/y", "A/Cell/z", "A/Cell/w"});
+
+    QVector<PipelineLiveness::Step> steps = PipelineLiveness::Plan(filters, false, false);
+    DREAM3D_REQUIRE_EQUAL(steps.size(), 5)
+    DREAM3D_REQUIRE(Paths(steps[0].releaseAfter).isEmpty())
+    DREAM3D_REQUIRE(Paths(steps[1].releaseAfter) == QStringList({"A/Cell/x"}))
+    DREAM3D_REQUIRE(Paths(steps[2].releaseAfter) == QStringList({"A/Cell/w", "A/Cell/y"}))
+    // The last filter and the end of the pipeline release nothing, the arrays go with the DataContainerArray
+    DREAM3D_REQUIRE(Paths(steps[3].releaseAfter).isEmpty())
+    DREAM3D_REQUIRE(Paths(steps[4].releaseAfter).isEmpty())
+
+    // Disabled filters do not use anything
+    filters[2]->setEnabled(false);
+    steps = PipelineLiveness::Plan(filters, false, false);
+    DREAM3D_REQUIRE(Paths(steps[0].releaseAfter) == QStringList({"A/Cell/y"}))
+    DREAM3D_REQUIRE(Paths(steps[2].releaseAfter).isEmpty())
+    filters[2]->setEnabled(true);
+
+    // The results are the arrays that remain, so none of them is released
+    steps = PipelineLiveness::Plan(filters, false, true);
+    for(const PipelineLiveness::Step& step : steps)
+    {
+      DREAM3D_REQUIRE(step.releaseAfter.isEmpty())
+      DREAM3D_REQUIRE(step.spillAfter.isEmpty())
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestRenameAndRemove()
+  {
+    FilterPipeline::FilterContainerType filters;
+    filters << CreateFilter({{"DataArrayCreationWidget", Path("A", "Cell", "x")}}, {"A/Cell/x"});
+    // Renames A to C, the new name is a plain string
+    filters << CreateFilter({{"DataContainerSelectionWidget", "A"}, {"StringWidget", "C"}}, {"C/Cell/x"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("C", "Cell", "x")}, {"DataArrayCreationWidget", Path("B", "Cell", "y")}}, {"B/Cell/y", "C/Cell/x"});
+    // Removes C
+    filters << CreateFilter({{"DataContainerSelectionWidget", "C"}}, {"B/Cell/y"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("B", "Cell", "y")}}, {"B/Cell/y"});
+
+    QVector<PipelineLiveness::Step> steps = PipelineLiveness::Plan(filters, false, false);
+    DREAM3D_REQUIRE(Paths(steps[0].releaseAfter).isEmpty())
+    DREAM3D_REQUIRE(Paths(steps[1].releaseAfter) == QStringList({"A/Cell/x"}))
+    DREAM3D_REQUIRE(Paths(steps[2].releaseAfter).isEmpty())
+    DREAM3D_REQUIRE(Paths(steps[3].releaseAfter) == QStringList({"C/Cell/x"}))
+    DREAM3D_REQUIRE(Paths(steps[4].releaseAfter).isEmpty())
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestBarriers()
+  {
+    FilterPipeline::FilterContainerType filters;
+    filters << CreateFilter({{"DataArrayCreationWidget", Path("A", "Cell", "x")}, {"DataArrayCreationWidget", Path("A", "Cell", "y")}}, {"A/Cell/x", "A/Cell/y"});
+    // A parameter of an unknown kind may name any data
+    filters << CreateFilter({{"CustomPluginWidget", 5}}, {"A/Cell/x", "A/Cell/y"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("A", "Cell", "x")}}, {"A/Cell/x", "A/Cell/y"});
+    filters << CreateFilter({{"DataArrayCreationWidget", Path("A", "Cell", "z")}}, {"A/Cell/x", "A/Cell/y", "A/Cell/z"});
+
+    QVector<PipelineLiveness::Step> steps = PipelineLiveness::Plan(filters, false, false);
+    DREAM3D_REQUIRE(Paths(steps[0].releaseAfter).isEmpty())
+    DREAM3D_REQUIRE(Paths(steps[1].releaseAfter) == QStringList({"A/Cell/y"}))
+    DREAM3D_REQUIRE(Paths(steps[2].releaseAfter) == QStringList({"A/Cell/x"}))
+
+    // Without a structure of its own the filter may use everything before it, and the filter after it finds
+    // everything new
+    filters[1]->setDataContainerArray(DataContainerArray::NullPointer());
+    steps = PipelineLiveness::Plan(filters, false, false);
+    DREAM3D_REQUIRE(Paths(steps[1].releaseAfter).isEmpty())
+    DREAM3D_REQUIRE(Paths(steps[2].releaseAfter) == QStringList({"A/Cell/x", "A/Cell/y"}))
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestWriterSpill()
+  {
+    FilterPipeline::FilterContainerType filters = WriterPipeline();
+
+    // A/Cell/x waits two filters for the writer, B/Cell/y and B/Cell/z are used right before it
+    QVector<PipelineLiveness::Step> steps = PipelineLiveness::Plan(filters, true, false);
+    DREAM3D_REQUIRE(Paths(steps[0].spillAfter) == QStringList({"A/Cell/x"}))
+    DREAM3D_REQUIRE(Paths(steps[3].restoreBefore) == QStringList({"A/Cell/x"}))
+    for(int i = 0; i < steps.size(); i++)
+    {
+      DREAM3D_REQUIRE(steps[i].releaseAfter.isEmpty())
+      DREAM3D_REQUIRE(i == 0 || steps[i].spillAfter.isEmpty())
+      DREAM3D_REQUIRE(i == 3 || steps[i].restoreBefore.isEmpty())
+    }
+
+    steps = PipelineLiveness::Plan(filters, false, false);
+    for(const PipelineLiveness::Step& step : steps)
+    {
+      DREAM3D_REQUIRE(step.spillAfter.isEmpty())
+      DREAM3D_REQUIRE(step.restoreBefore.isEmpty())
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestKeepResultsSpill()
+  {
+    FilterPipeline::FilterContainerType filters;
+    filters << CreateFilter({{"DataArrayCreationWidget", Path("A", "Cell", "x")}, {"DataArrayCreationWidget", Path("A", "Cell", "y")}}, {"A/Cell/x", "A/Cell/y"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("A", "Cell", "x")}, {"DataArrayCreationWidget", Path("A", "Cell", "z")}}, {"A/Cell/x", "A/Cell/y", "A/Cell/z"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("A", "Cell", "z")}}, {"A/Cell/x", "A/Cell/y", "A/Cell/z"});
+
+    // The end of the pipeline reads back everything that waits for it
+    QVector<PipelineLiveness::Step> steps = PipelineLiveness::Plan(filters, true, true);
+    DREAM3D_REQUIRE_EQUAL(steps.size(), 4)
+    DREAM3D_REQUIRE(Paths(steps[0].spillAfter) == QStringList({"A/Cell/y"}))
+    DREAM3D_REQUIRE(Paths(steps[1].spillAfter) == QStringList({"A/Cell/x"}))
+    DREAM3D_REQUIRE(Paths(steps[2].spillAfter).isEmpty())
+    DREAM3D_REQUIRE(Paths(steps[3].restoreBefore) == QStringList({"A/Cell/x", "A/Cell/y"}))
+    for(const PipelineLiveness::Step& step : steps)
+    {
+      DREAM3D_REQUIRE(step.releaseAfter.isEmpty())
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestSpillRoundTrip()
+  {
+    QTemporaryDir spillDir;
+    DREAM3D_REQUIRE(spillDir.isValid())
+
+    PipelineLiveness liveness(spillDir.path());
+    liveness.plan(WriterPipeline(), false);
+
+    // The data as the first filter leaves it
+    DataContainerArray::Pointer dca = SyntheticPipeline::Structure({"A/Cell/x"});
+    dca->getDataContainer("A")->setGeometry(ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry));
+    Int32ArrayType::Pointer x = std::dynamic_pointer_cast<Int32ArrayType>(dca->getDataContainer("A")->getAttributeMatrix("Cell")->getAttributeArray("x"));
+    for(size_t i = 0; i < x->getNumberOfTuples(); i++)
+    {
+      x->setValue(i, static_cast<int32_t>(i * 3));
+    }
+
+    qint64 bytes = 0;
+    QString warning;
+    DREAM3D_REQUIRE_EQUAL(liveness.releaseAfter(0, dca, bytes, warning), 1)
+    DREAM3D_REQUIRE(warning.isEmpty())
+    DREAM3D_REQUIRE_EQUAL(bytes, static_cast<qint64>(10 * sizeof(int32_t)))
+    DREAM3D_REQUIRE(nullptr == dca->getDataContainer("A")->getAttributeMatrix("Cell")->getAttributeArray("x").get())
+    DREAM3D_REQUIRE_EQUAL(CountFiles(spillDir.path()), 1)
+
+    // Filters that do not need the array run while it is on disk
+    SyntheticPipeline::AddPaths(dca, {"B/Cell/y", "B/Cell/z"});
+    DREAM3D_REQUIRE_EQUAL(liveness.releaseAfter(1, dca, bytes, warning), 0)
+    DREAM3D_REQUIRE_EQUAL(liveness.releaseAfter(2, dca, bytes, warning), 0)
+
+    QString errorMessage;
+    DREAM3D_REQUIRE(liveness.restoreBefore(3, dca, errorMessage))
+    DREAM3D_REQUIRE(errorMessage.isEmpty())
+    Int32ArrayType::Pointer restored = std::dynamic_pointer_cast<Int32ArrayType>(dca->getDataContainer("A")->getAttributeMatrix("Cell")->getAttributeArray("x"));
+    DREAM3D_REQUIRE(nullptr != restored.get())
+    DREAM3D_REQUIRE_EQUAL(restored->getNumberOfTuples(), static_cast<size_t>(10))
+    for(size_t i = 0; i < restored->getNumberOfTuples(); i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(restored->getValue(i), static_cast<int32_t>(i * 3))
+    }
+    // The file goes away once everything in it is back
+    DREAM3D_REQUIRE_EQUAL(CountFiles(spillDir.path()), 0)
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    std::cout << "#### PipelineLivenessTest Starting ####" << std::endl;
+
+    DREAM3D_REGISTER_TEST(TestReleaseAfterLastUse())
+    DREAM3D_REGISTER_TEST(TestRenameAndRemove())
+    DREAM3D_REGISTER_TEST(TestBarriers())
+    DREAM3D_REGISTER_TEST(TestWriterSpill())
+    DREAM3D_REGISTER_TEST(TestKeepResultsSpill())
+    DREAM3D_REGISTER_TEST(TestSpillRoundTrip())
+  }
+
+public:
+  PipelineLivenessTest(const PipelineLivenessTest&) = delete;            // Copy Constructor Not Implemented
+  PipelineLivenessTest(PipelineLivenessTest&&) = delete;                 // Move Constructor Not Implemented
+  PipelineLivenessTest& operator=(const PipelineLivenessTest&) = delete; // Copy Assignment Not Implemented
+  PipelineLivenessTest& operator=(PipelineLivenessTest&&) = delete;      // Move Assignment Not Implemented
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  Q_UNUSED(argc)
+  Q_UNUSED(argv)
+
+  int err = EXIT_SUCCESS;
+  PipelineLivenessTest test;
+  test();
+  PRINT_TEST_SUMMARY();
+  return err;
+}
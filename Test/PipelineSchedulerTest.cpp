@@ -0,0 +1,226 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QCoreApplication>
+
+#include "UnitTestSupport.hpp"
+
+#include "Common/PipelineScheduler.h"
+
+#include "SyntheticPipeline.h"
+
+using SyntheticPipeline::CreateFilter;
+using SyntheticPipeline::Path;
+
+class PipelineSchedulerTest
+{
+public:
+  PipelineSchedulerTest() = default;
+  ~PipelineSchedulerTest() = default;
+
+  // -----------------------------------------------------------------------------
+  // Returns the dependencies of every node, by pipeline index
+  // -----------------------------------------------------------------------------
+  QVector<QVector<int>> Dependencies(const FilterPipeline::FilterContainerType& filters)
+  {
+    QVector<PipelineScheduler::Node> nodes = PipelineScheduler::BuildGraph(filters, 0);
+    QVector<QVector<int>> dependencies;
+    for(const PipelineScheduler::Node& node : nodes)
+    {
+      QVector<int> indices;
+      for(int n : node.dependencies)
+      {
+        indices.push_back(nodes[n].index);
+      }
+      dependencies.push_back(indices);
+    }
+    return dependencies;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestIndependentBranches()
+  {
+    FilterPipeline::FilterContainerType filters;
+    filters << CreateFilter({{"DataContainerCreationWidget", "A"}}, {"A/Cell/x"});
+    filters << CreateFilter({{"DataContainerCreationWidget", "B"}}, {"A/Cell/x", "B/Cell/x"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("A", "Cell", "x")}, {"DataArrayCreationWidget", Path("A", "Cell", "y")}}, {"A/Cell/x", "A/Cell/y", "B/Cell/x"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("B", "Cell", "x")}, {"DataArrayCreationWidget", Path("B", "Cell", "y")}},
+                            {"A/Cell/x", "A/Cell/y", "B/Cell/x", "B/Cell/y"});
+
+    QVector<QVector<int>> dependencies = Dependencies(filters);
+    DREAM3D_REQUIRE_EQUAL(dependencies.size(), 4)
+    DREAM3D_REQUIRE(dependencies[1].isEmpty())
+    DREAM3D_REQUIRE(dependencies[2] == QVector<int>({0}))
+    DREAM3D_REQUIRE(dependencies[3] == QVector<int>({1}))
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestRenameAndRemove()
+  {
+    FilterPipeline::FilterContainerType filters;
+    filters << CreateFilter({{"DataContainerCreationWidget", "A"}}, {"A/Cell/x"});
+    filters << CreateFilter({{"DataContainerCreationWidget", "B"}}, {"A/Cell/x", "B/Cell/x"});
+    // Renames A to C, the new name is a plain string
+    filters << CreateFilter({{"DataContainerSelectionWidget", "A"}, {"StringWidget", "C"}}, {"B/Cell/x", "C/Cell/x"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("C", "Cell", "x")}, {"DataArrayCreationWidget", Path("C", "Cell", "y")}}, {"B/Cell/x", "C/Cell/x", "C/Cell/y"});
+    // Removes B
+    filters << CreateFilter({{"DataContainerSelectionWidget", "B"}}, {"C/Cell/x", "C/Cell/y"});
+
+    QVector<QVector<int>> dependencies = Dependencies(filters);
+    DREAM3D_REQUIRE(dependencies[2] == QVector<int>({0}))
+    DREAM3D_REQUIRE(dependencies[3] == QVector<int>({2}))
+    DREAM3D_REQUIRE(dependencies[4] == QVector<int>({1}))
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestFileWriterBarrier()
+  {
+    FilterPipeline::FilterContainerType filters;
+    filters << CreateFilter({{"InputFileWidget", "a.dream3d"}, {"DataContainerCreationWidget", "A"}}, {"A/Cell/x"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("A", "Cell", "x")}, {"DataArrayCreationWidget", Path("A", "Cell", "y")}}, {"A/Cell/x", "A/Cell/y"});
+    filters << CreateFilter({{"InputFileWidget", "b.dream3d"}, {"DataContainerCreationWidget", "B"}}, {"A/Cell/x", "A/Cell/y", "B/Cell/x"});
+    // Writes everything without naming any data
+    filters << CreateFilter({{"OutputFileWidget", "out.dream3d"}, {"BooleanWidget", true}}, {"A/Cell/x", "A/Cell/y", "B/Cell/x"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("B", "Cell", "x")}, {"DataArrayCreationWidget", Path("B", "Cell", "y")}},
+                            {"A/Cell/x", "A/Cell/y", "B/Cell/x", "B/Cell/y"});
+
+    QVector<PipelineScheduler::Node> nodes = PipelineScheduler::BuildGraph(filters, 0);
+    QVector<QVector<int>> dependencies = Dependencies(filters);
+    // Files are read in pipeline order, but the second reader does not wait for the work on A
+    DREAM3D_REQUIRE(dependencies[2] == QVector<int>({0}))
+    DREAM3D_REQUIRE(nodes[3].exclusive)
+    DREAM3D_REQUIRE(dependencies[3] == QVector<int>({0, 1, 2}))
+    DREAM3D_REQUIRE(dependencies[4].contains(3))
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestUnknownParameterBarrier()
+  {
+    FilterPipeline::FilterContainerType filters;
+    filters << CreateFilter({{"DataContainerCreationWidget", "A"}}, {"A/Cell/x"});
+    filters << CreateFilter({{"DataContainerCreationWidget", "B"}}, {"A/Cell/x", "B/Cell/x"});
+    filters << CreateFilter({{"CustomPluginWidget", 5}}, {"A/Cell/x", "B/Cell/x"});
+    filters << CreateFilter({{"DataArraySelectionWidget", Path("B", "Cell", "x")}, {"DataArrayCreationWidget", Path("B", "Cell", "y")}}, {"A/Cell/x", "B/Cell/x", "B/Cell/y"});
+    // A filter without a structure of its own is a barrier too
+    SyntheticPipeline::Filter::Pointer unknown = CreateFilter({{"DataContainerCreationWidget", "C"}}, {});
+    unknown->setDataContainerArray(DataContainerArray::NullPointer());
+    filters << unknown;
+
+    QVector<PipelineScheduler::Node> nodes = PipelineScheduler::BuildGraph(filters, 0);
+    QVector<QVector<int>> dependencies = Dependencies(filters);
+    DREAM3D_REQUIRE(nodes[2].exclusive)
+    DREAM3D_REQUIRE(dependencies[2] == QVector<int>({0, 1}))
+    DREAM3D_REQUIRE(dependencies[3] == QVector<int>({1, 2}))
+    DREAM3D_REQUIRE(nodes[4].exclusive)
+    DREAM3D_REQUIRE(dependencies[4] == QVector<int>({0, 1, 2, 3}))
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void TestContainerOrder()
+  {
+    FilterPipeline::FilterContainerType filters;
+    SyntheticPipeline::Filter::Pointer create =
+        CreateFilter({{"DataContainerCreationWidget", "A"}, {"DataContainerCreationWidget", "B"}, {"DataContainerCreationWidget", "C"}}, {"A/Cell/x", "B/Cell/x", "C/Cell/x"});
+    create->action = [](DataContainerArray::Pointer dca) { SyntheticPipeline::AddPaths(dca, {"A/Cell/x", "B/Cell/x", "C/Cell/x"}); };
+    filters << create;
+
+    // Replaces B with a new container of the same name
+    SyntheticPipeline::Filter::Pointer replace =
+        CreateFilter({{"DataArraySelectionWidget", Path("B", "Cell", "x")}, {"DataArrayCreationWidget", Path("B", "Cell", "y")}}, {"A/Cell/x", "B/Cell/x", "B/Cell/y", "C/Cell/x"});
+    replace->action = [](DataContainerArray::Pointer dca) {
+      dca->removeDataContainer("B");
+      SyntheticPipeline::AddPaths(dca, {"B/Cell/x", "B/Cell/y"});
+    };
+    filters << replace;
+
+    // Does not depend on the others, so it may well finish first
+    SyntheticPipeline::Filter::Pointer append = CreateFilter({{"DataContainerCreationWidget", "D"}}, {"A/Cell/x", "B/Cell/x", "B/Cell/y", "C/Cell/x", "D/Cell/x"});
+    append->action = [](DataContainerArray::Pointer dca) { SyntheticPipeline::AddPaths(dca, {"D/Cell/x"}); };
+    filters << append;
+
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    PipelineScheduler scheduler(2);
+    int err = scheduler.execute(filters, 0, dca);
+    DREAM3D_REQUIRE_EQUAL(err, 0)
+    DREAM3D_REQUIRE(SyntheticPipeline::DataContainerNames(dca) == QStringList({"A", "B", "C", "D"}))
+    DREAM3D_REQUIRE(nullptr != dca->getDataContainer("B")->getAttributeMatrix("Cell")->getAttributeArray("y").get())
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    std::cout << "#### PipelineSchedulerTest Starting ####" << std::endl;
+
+    DREAM3D_REGISTER_TEST(TestIndependentBranches())
+    DREAM3D_REGISTER_TEST(TestRenameAndRemove())
+    DREAM3D_REGISTER_TEST(TestFileWriterBarrier())
+    DREAM3D_REGISTER_TEST(TestUnknownParameterBarrier())
+    DREAM3D_REGISTER_TEST(TestContainerOrder())
+  }
+
+public:
+  PipelineSchedulerTest(const PipelineSchedulerTest&) = delete;            // Copy Constructor Not Implemented
+  PipelineSchedulerTest(PipelineSchedulerTest&&) = delete;                 // Move Constructor Not Implemented
+  PipelineSchedulerTest& operator=(const PipelineSchedulerTest&) = delete; // Copy Assignment Not Implemented
+  PipelineSchedulerTest& operator=(PipelineSchedulerTest&&) = delete;      // Move Assignment Not Implemented
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  // The scheduler waits for the filters in an event loop
+  QCoreApplication app(argc, argv);
+
+  int err = EXIT_SUCCESS;
+  PipelineSchedulerTest test;
+  test();
+  PRINT_TEST_SUMMARY();
+  return err;
+}
@@ -0,0 +1,377 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* Launches SIMPLView under the offscreen platform plugin several times and reads the
+ * startup trace that each launch writes (see StartupTracer) to time initialize(),
+ * loadPlugins() and getNewSIMPLViewInstance(). Launches are done with both a cold and
+ * a warm page cache. The medians are written to a JSON file and compared against a
+ * stored baseline; the benchmark fails when a phase is slower than the baseline by
+ * more than the tolerance.
+ */
+
+#include <algorithm>
+#include <iostream>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMap>
+#include <QtCore/QProcess>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QVector>
+
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+const QString k_StartupSpan("Startup");
+const QString k_InitializeSpan("Initialize SIMPLViewApplication");
+const QString k_LoadPluginsSpan("loadPlugins");
+const QString k_NewInstanceSpan("Create SIMPLView_UI");
+}
+
+using PhaseTimes = QMap<QString, QVector<double>>;
+
+// -----------------------------------------------------------------------------
+// Asks the kernel to drop the cached pages of every file below 'dirPath' so the
+// next launch has to read the executable, libraries and plugins from disk again.
+// -----------------------------------------------------------------------------
+bool EvictFromPageCache(const QString& dirPath)
+{
+#if defined(Q_OS_LINUX)
+  QDirIterator iter(dirPath, QDir::Files | QDir::NoSymLinks, QDirIterator::Subdirectories);
+  while(iter.hasNext())
+  {
+    QByteArray filePath = QFile::encodeName(iter.next());
+    int fd = ::open(filePath.constData(), O_RDONLY);
+    if(fd < 0)
+    {
+      continue;
+    }
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+  }
+  return true;
+#else
+  Q_UNUSED(dirPath)
+  return false;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double Median(QVector<double> values)
+{
+  if(values.isEmpty())
+  {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  int mid = values.size() / 2;
+  if(values.size() % 2 == 0)
+  {
+    return (values[mid - 1] + values[mid]) / 2.0;
+  }
+  return values[mid];
+}
+
+// -----------------------------------------------------------------------------
+// Runs the application once and adds the durations of the interesting spans of
+// the main thread, in milliseconds, to 'times'.
+// -----------------------------------------------------------------------------
+bool RunOnce(const QString& appPath, const QString& workDir, int run, int windows, int timeout, PhaseTimes& times)
+{
+  QString traceFile = QString("%1/trace_%2.json").arg(workDir).arg(run);
+  QFile::remove(traceFile);
+
+  // Keep the preferences and caches of the launches away from the ones of the user
+  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+  env.insert("QT_QPA_PLATFORM", "offscreen");
+  env.insert("XDG_CONFIG_HOME", workDir + "/config");
+  env.insert("XDG_CACHE_HOME", workDir + "/cache");
+  env.remove("SIMPLVIEW_SINGLE_INSTANCE");
+  env.remove("SIMPLVIEW_STARTUP_TRACE");
+
+  QProcess process;
+  process.setProcessEnvironment(env);
+  process.setWorkingDirectory(QFileInfo(appPath).absolutePath());
+  process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+  process.setStandardOutputFile(QProcess::nullDevice());
+  process.start(appPath, QStringList() << QString("--startup-trace=%1").arg(traceFile) << QString("--benchmark-windows=%1").arg(windows));
+  if(!process.waitForStarted(timeout) || !process.waitForFinished(timeout))
+  {
+    std::cout << "  " << appPath.toStdString() << " did not finish: " << process.errorString().toStdString() << std::endl;
+    process.kill();
+    return false;
+  }
+  if(process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+  {
+    std::cout << "  " << appPath.toStdString() << " exited with code " << process.exitCode() << std::endl;
+    return false;
+  }
+
+  QFile file(traceFile);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    std::cout << "  No startup trace was written to " << traceFile.toStdString() << std::endl;
+    return false;
+  }
+  QJsonArray events = QJsonDocument::fromJson(file.readAll()).object()["traceEvents"].toArray();
+
+  // Start time and duration of every window that was created
+  QVector<QPair<double, double>> instances;
+  for(QJsonValue value : events)
+  {
+    QJsonObject event = value.toObject();
+    if(event["ph"].toString() != "X" || event["tid"].toInt() != 0)
+    {
+      continue;
+    }
+    QString name = event["name"].toString();
+    double duration = event["dur"].toDouble() / 1000.0;
+    if(name == k_NewInstanceSpan)
+    {
+      instances.push_back(qMakePair(event["ts"].toDouble(), duration));
+    }
+    else if(name == k_StartupSpan || name == k_InitializeSpan || name == k_LoadPluginsSpan)
+    {
+      times[name].push_back(duration);
+    }
+  }
+
+  // The first window belongs to startup; the rest are the ones that were asked for
+  std::sort(instances.begin(), instances.end());
+  for(int i = 1; i < instances.size(); i++)
+  {
+    times[k_NewInstanceSpan].push_back(instances[i].second);
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("SIMPLViewStartupBenchmark");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Measures the startup and window creation time of SIMPLView");
+  parser.addHelpOption();
+  QCommandLineOption appOption("app", "Path to the SIMPLView executable.", "path");
+  QCommandLineOption runsOption("runs", "Number of launches with a warm page cache.", "count", "5");
+  QCommandLineOption coldRunsOption("cold-runs", "Number of launches with a cold page cache (Linux only).", "count", "3");
+  QCommandLineOption windowsOption("windows", "Number of additional windows to create in each launch.", "count", "5");
+  QCommandLineOption evictOption("evict", "Additional directory whose files are dropped from the page cache before a cold launch.", "dir");
+  QCommandLineOption outputOption("output", "JSON file that the results are written to.", "file");
+  QCommandLineOption baselineOption("baseline", "JSON file with the results of an earlier run to compare against.", "file");
+  QCommandLineOption toleranceOption("tolerance", "Allowed slowdown against the baseline in percent.", "percent", "20");
+  QCommandLineOption updateBaselineOption("update-baseline", "Write the results to the baseline file instead of comparing against it.");
+  QCommandLineOption timeoutOption("timeout", "Seconds to wait for each launch.", "seconds", "300");
+  parser.addOptions({appOption, runsOption, coldRunsOption, windowsOption, evictOption, outputOption, baselineOption, toleranceOption, updateBaselineOption, timeoutOption});
+  parser.process(app);
+
+  QString appPath = parser.value(appOption);
+  if(appPath.isEmpty() || !QFileInfo(appPath).isExecutable())
+  {
+    std::cout << "The SIMPLView executable must be given with --app" << std::endl;
+    return 2;
+  }
+  int runs = parser.value(runsOption).toInt();
+  int coldRuns = parser.value(coldRunsOption).toInt();
+  int windows = parser.value(windowsOption).toInt();
+  double tolerance = parser.value(toleranceOption).toDouble();
+  int timeout = parser.value(timeoutOption).toInt() * 1000;
+
+  QTemporaryDir workDir;
+  if(!workDir.isValid())
+  {
+    std::cout << "Could not create a temporary directory" << std::endl;
+    return 2;
+  }
+
+  // Everything the application reads at startup lives in or next to its own directory
+  QDir appDir = QFileInfo(appPath).absoluteDir();
+  QStringList evictDirs;
+  evictDirs << appDir.absolutePath();
+  foreach(QString sibling, QStringList() << "Plugins"
+                                         << "lib")
+  {
+    if(appDir.exists("../" + sibling))
+    {
+      evictDirs << QDir::cleanPath(appDir.absoluteFilePath("../" + sibling));
+    }
+  }
+  evictDirs << parser.values(evictOption);
+
+  // The first launch fills the plugin manifest and the style sheet cache so that all of the timed
+  // launches see the same application state and only the page cache differs.
+  int run = 0;
+  PhaseTimes discarded;
+  std::cout << "Warming up " << appPath.toStdString() << std::endl;
+  if(!RunOnce(appPath, workDir.path(), run++, 0, timeout, discarded))
+  {
+    return 2;
+  }
+
+  PhaseTimes coldTimes;
+  for(int i = 0; i < coldRuns; i++)
+  {
+    bool evicted = true;
+    foreach(QString dir, evictDirs)
+    {
+      evicted = EvictFromPageCache(dir) && evicted;
+    }
+    if(!evicted)
+    {
+      std::cout << "Cold launches are not supported on this platform" << std::endl;
+      break;
+    }
+    std::cout << "Cold launch " << (i + 1) << " of " << coldRuns << std::endl;
+    if(!RunOnce(appPath, workDir.path(), run++, windows, timeout, coldTimes))
+    {
+      return 2;
+    }
+  }
+
+  PhaseTimes warmTimes;
+  for(int i = 0; i < runs; i++)
+  {
+    std::cout << "Warm launch " << (i + 1) << " of " << runs << std::endl;
+    if(!RunOnce(appPath, workDir.path(), run++, windows, timeout, warmTimes))
+    {
+      return 2;
+    }
+  }
+
+  QJsonObject metrics;
+  for(PhaseTimes::const_iterator iter = coldTimes.constBegin(); iter != coldTimes.constEnd(); ++iter)
+  {
+    metrics["Cold " + iter.key()] = Median(iter.value());
+  }
+  for(PhaseTimes::const_iterator iter = warmTimes.constBegin(); iter != warmTimes.constEnd(); ++iter)
+  {
+    metrics["Warm " + iter.key()] = Median(iter.value());
+  }
+
+  QJsonObject results;
+  results["Application"] = QFileInfo(appPath).absoluteFilePath();
+  results["Date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+  results["Runs"] = runs;
+  results["ColdRuns"] = coldRuns;
+  results["Windows"] = windows;
+  results["Unit"] = QString("ms");
+  results["Metrics"] = metrics;
+
+  if(parser.isSet(outputOption))
+  {
+    QFile outFile(parser.value(outputOption));
+    if(!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+      std::cout << "Could not write " << outFile.fileName().toStdString() << std::endl;
+      return 2;
+    }
+    outFile.write(QJsonDocument(results).toJson());
+  }
+
+  QString baselinePath = parser.value(baselineOption);
+  QJsonObject baselineMetrics;
+  QFile baselineFile(baselinePath);
+  bool writeBaseline = parser.isSet(updateBaselineOption);
+  if(!baselinePath.isEmpty() && !writeBaseline)
+  {
+    if(baselineFile.open(QIODevice::ReadOnly))
+    {
+      baselineMetrics = QJsonDocument::fromJson(baselineFile.readAll()).object()["Metrics"].toObject();
+      baselineFile.close();
+    }
+    else
+    {
+      // The first run on a machine records the baseline for the next ones
+      std::cout << "No baseline at " << baselinePath.toStdString() << ", recording this run as the baseline" << std::endl;
+      writeBaseline = true;
+    }
+  }
+  if(!baselinePath.isEmpty() && writeBaseline)
+  {
+    QFileInfo(baselinePath).absoluteDir().mkpath(".");
+    if(!baselineFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+      std::cout << "Could not write " << baselinePath.toStdString() << std::endl;
+      return 2;
+    }
+    baselineFile.write(QJsonDocument(results).toJson());
+  }
+
+  int regressions = 0;
+  std::cout << std::endl;
+  for(QJsonObject::const_iterator iter = metrics.constBegin(); iter != metrics.constEnd(); ++iter)
+  {
+    double value = iter.value().toDouble();
+    std::cout << "  " << iter.key().toStdString() << ": " << value << " ms";
+    if(baselineMetrics.contains(iter.key()))
+    {
+      double baseline = baselineMetrics[iter.key()].toDouble();
+      double change = (baseline > 0.0) ? (value - baseline) / baseline * 100.0 : 0.0;
+      std::cout << " (baseline " << baseline << " ms, " << (change >= 0.0 ? "+" : "") << change << "%)";
+      if(change > tolerance)
+      {
+        std::cout << " REGRESSION";
+        regressions++;
+      }
+    }
+    std::cout << std::endl;
+  }
+
+  if(regressions > 0)
+  {
+    std::cout << regressions << " phase(s) are more than " << tolerance << "% slower than the baseline" << std::endl;
+    return 1;
+  }
+  return 0;
+}
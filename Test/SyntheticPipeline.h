@@ -0,0 +1,214 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/FilterParameters/FilterParameter.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief Builds preflighted pipelines out of filters that only carry what the pipeline execution code looks
+ * at: parameters with a widget type and a value, the data structure the preflight left after the filter and,
+ * for tests that execute, what the filter does to its DataContainerArray. No plugins are needed.
+ */
+namespace SyntheticPipeline
+{
+using Parameters = QList<QPair<QString, QVariant>>;
+
+/**
+ * @brief A filter parameter that is only a widget type
+ */
+class Parameter : public FilterParameter
+{
+public:
+  SIMPL_SHARED_POINTERS(Parameter)
+
+  static Pointer New(const QString& propertyName, const QString& widgetType)
+  {
+    Pointer parameter(new Parameter(widgetType));
+    parameter->setHumanLabel(propertyName);
+    parameter->setPropertyName(propertyName);
+    return parameter;
+  }
+
+  ~Parameter() override = default;
+
+  QString getWidgetType() const override
+  {
+    return m_WidgetType;
+  }
+
+protected:
+  explicit Parameter(const QString& widgetType)
+  : m_WidgetType(widgetType)
+  {
+  }
+
+private:
+  QString m_WidgetType;
+};
+
+/**
+ * @brief A filter whose execute() calls 'action' with its DataContainerArray
+ */
+class Filter : public AbstractFilter
+{
+public:
+  SIMPL_SHARED_POINTERS(Filter)
+
+  static Pointer New()
+  {
+    return Pointer(new Filter);
+  }
+
+  ~Filter() override = default;
+
+  /**
+   * @brief Adds a parameter and stores its value in a property of the same name
+   * @param widgetType
+   * @param value
+   */
+  void addParameter(const QString& widgetType, const QVariant& value)
+  {
+    QString name = QString("Parameter%1").arg(getFilterParameters().size());
+    FilterParameterVectorType parameters = getFilterParameters();
+    parameters.push_back(Parameter::New(name, widgetType));
+    setFilterParameters(parameters);
+    setProperty(name.toLatin1().constData(), value);
+  }
+
+  void execute() override
+  {
+    if(action)
+    {
+      action(getDataContainerArray());
+    }
+  }
+
+  std::function<void(DataContainerArray::Pointer)> action;
+
+protected:
+  Filter() = default;
+};
+
+// -----------------------------------------------------------------------------
+// Returns a DataArrayPath as a parameter value
+// -----------------------------------------------------------------------------
+inline QVariant Path(const QString& dcName, const QString& amName, const QString& daName)
+{
+  return QVariant::fromValue(DataArrayPath(dcName, amName, daName));
+}
+
+// -----------------------------------------------------------------------------
+// Adds the data containers, attribute matrices and arrays of "DC", "DC/AM" and "DC/AM/Array" paths to
+// 'dca'. The attribute matrices have 10 tuples and the arrays are int32.
+// -----------------------------------------------------------------------------
+inline DataContainerArray::Pointer AddPaths(DataContainerArray::Pointer dca, const QStringList& paths)
+{
+  for(const QString& path : paths)
+  {
+    QStringList parts = path.split('/');
+    DataContainer::Pointer dc = dca->getDataContainer(parts[0]);
+    if(nullptr == dc.get())
+    {
+      dc = DataContainer::New(parts[0]);
+      dca->addDataContainer(dc);
+    }
+    if(parts.size() < 2)
+    {
+      continue;
+    }
+    AttributeMatrix::Pointer am = dc->getAttributeMatrix(parts[1]);
+    if(nullptr == am.get())
+    {
+      am = AttributeMatrix::New(QVector<size_t>(1, 10), parts[1], AttributeMatrix::Type::Cell);
+      dc->addAttributeMatrix(parts[1], am);
+    }
+    if(parts.size() > 2)
+    {
+      am->addAttributeArray(parts[2], Int32ArrayType::CreateArray(10, QVector<size_t>(1, 1), parts[2], true));
+    }
+  }
+  return dca;
+}
+
+// -----------------------------------------------------------------------------
+// Returns a new DataContainerArray that holds 'paths'
+// -----------------------------------------------------------------------------
+inline DataContainerArray::Pointer Structure(const QStringList& paths)
+{
+  return AddPaths(DataContainerArray::New(), paths);
+}
+
+// -----------------------------------------------------------------------------
+// Returns a filter as the preflight leaves it: with its parameters and the structure after it
+// -----------------------------------------------------------------------------
+inline Filter::Pointer CreateFilter(const Parameters& parameters, const QStringList& structure)
+{
+  Filter::Pointer filter = Filter::New();
+  for(const QPair<QString, QVariant>& parameter : parameters)
+  {
+    filter->addParameter(parameter.first, parameter.second);
+  }
+  filter->setDataContainerArray(Structure(structure));
+  return filter;
+}
+
+// -----------------------------------------------------------------------------
+// Returns the names of the data containers of 'dca' in their order
+// -----------------------------------------------------------------------------
+inline QStringList DataContainerNames(DataContainerArray::Pointer dca)
+{
+  QStringList names;
+  for(DataContainer::Pointer dc : dca->getDataContainers())
+  {
+    names << dc->getName();
+  }
+  return names;
+}
+} // namespace SyntheticPipeline
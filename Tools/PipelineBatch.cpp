@@ -0,0 +1,406 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineBatch.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+
+namespace
+{
+// -----------------------------------------------------------------------------
+// Splits CSV text into rows of cells. Quoted cells may contain separators, doubled quotes and line breaks.
+// -----------------------------------------------------------------------------
+QVector<QStringList> ParseCsv(const QString& text)
+{
+  QVector<QStringList> rows;
+  QStringList row;
+  QString cell;
+  bool quoted = false;
+  for(int i = 0; i < text.size(); i++)
+  {
+    QChar c = text[i];
+    if(quoted)
+    {
+      if(c == '"' && i + 1 < text.size() && text[i + 1] == '"')
+      {
+        cell.append('"');
+        i++;
+      }
+      else if(c == '"')
+      {
+        quoted = false;
+      }
+      else
+      {
+        cell.append(c);
+      }
+    }
+    else if(c == '"')
+    {
+      quoted = true;
+    }
+    else if(c == ',')
+    {
+      row << cell;
+      cell.clear();
+    }
+    else if(c == '\n' || c == '\r')
+    {
+      if(c == '\r' && i + 1 < text.size() && text[i + 1] == '\n')
+      {
+        i++;
+      }
+      row << cell;
+      cell.clear();
+      if(row.size() > 1 || !row.first().trimmed().isEmpty())
+      {
+        rows.push_back(row);
+      }
+      row.clear();
+    }
+    else
+    {
+      cell.append(c);
+    }
+  }
+  row << cell;
+  if(row.size() > 1 || !row.first().trimmed().isEmpty())
+  {
+    rows.push_back(row);
+  }
+  return rows;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString AbsolutePath(const QDir& baseDir, const QString& path)
+{
+  if(path.isEmpty())
+  {
+    return path;
+  }
+  return QDir::cleanPath(baseDir.absoluteFilePath(path));
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineBatch::PipelineBatch(QObject* parent)
+: QObject(parent)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineBatch::~PipelineBatch() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineBatch::ReadManifest(const QString& manifestFile, const QString& defaultPipeline, QVector<PipelineJob>& jobs, QString& errorMessage)
+{
+  QFile file(manifestFile);
+  if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    errorMessage = QString("The manifest '%1' could not be opened").arg(manifestFile);
+    return false;
+  }
+  QByteArray contents = file.readAll();
+  QDir manifestDir = QFileInfo(manifestFile).absoluteDir();
+  QString pipeline = defaultPipeline;
+
+  if(QFileInfo(manifestFile).suffix().compare("json", Qt::CaseInsensitive) == 0)
+  {
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(contents, &parseError);
+    if(parseError.error != QJsonParseError::NoError)
+    {
+      errorMessage = QString("The manifest '%1' is not valid JSON: %2").arg(manifestFile).arg(parseError.errorString());
+      return false;
+    }
+    QJsonArray jobArray = doc.array();
+    if(doc.isObject())
+    {
+      jobArray = doc.object()["jobs"].toArray();
+      if(doc.object().contains("pipeline"))
+      {
+        pipeline = AbsolutePath(manifestDir, doc.object()["pipeline"].toString());
+      }
+    }
+    for(int i = 0; i < jobArray.size(); i++)
+    {
+      QJsonObject obj = jobArray[i].toObject();
+      PipelineJob job;
+      job.id = obj["id"].toString(QString("job-%1").arg(i + 1));
+      job.pipelineFile = obj.contains("pipeline") ? AbsolutePath(manifestDir, obj["pipeline"].toString()) : pipeline;
+      job.overrides = obj["overrides"].toObject();
+      jobs.push_back(job);
+    }
+  }
+  else
+  {
+    QVector<QStringList> rows = ParseCsv(QString::fromUtf8(contents));
+    if(rows.isEmpty())
+    {
+      errorMessage = QString("The manifest '%1' has no header row").arg(manifestFile);
+      return false;
+    }
+    QStringList header = rows.takeFirst();
+    for(QString& column : header)
+    {
+      column = column.trimmed();
+    }
+    int idColumn = header.indexOf("id");
+    int pipelineColumn = header.indexOf("pipeline");
+    for(int r = 0; r < rows.size(); r++)
+    {
+      const QStringList& row = rows[r];
+      if(row.size() > header.size())
+      {
+        errorMessage = QString("Row %1 of the manifest '%2' has more cells than the header").arg(r + 2).arg(manifestFile);
+        return false;
+      }
+      PipelineJob job;
+      job.id = QString("job-%1").arg(r + 1);
+      job.pipelineFile = pipeline;
+      for(int c = 0; c < row.size(); c++)
+      {
+        if(row[c].isEmpty())
+        {
+          continue;
+        }
+        if(c == idColumn)
+        {
+          job.id = row[c].trimmed();
+        }
+        else if(c == pipelineColumn)
+        {
+          job.pipelineFile = AbsolutePath(manifestDir, row[c].trimmed());
+        }
+        else
+        {
+          job.overrides[header[c]] = row[c];
+        }
+      }
+      jobs.push_back(job);
+    }
+  }
+
+  QSet<QString> ids;
+  for(const PipelineJob& job : jobs)
+  {
+    if(job.pipelineFile.isEmpty())
+    {
+      errorMessage = QString("The job '%1' has no pipeline file").arg(job.id);
+      return false;
+    }
+    if(ids.contains(job.id))
+    {
+      errorMessage = QString("The job id '%1' is used more than once").arg(job.id);
+      return false;
+    }
+    ids.insert(job.id);
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineBatch::run(const QVector<PipelineJob>& jobs, const QString& workerProgram, const QStringList& workerArguments, int maxWorkers, const QString& reportFile)
+{
+  m_JobCount = jobs.size();
+  m_Results.clear();
+  maxWorkers = qMax(1, qMin(maxWorkers, m_JobCount));
+  std::cout << "Executing " << m_JobCount << " jobs with " << maxWorkers << " workers" << std::endl;
+
+  QElapsedTimer timer;
+  timer.start();
+  if(m_JobCount > 0)
+  {
+    QEventLoop loop;
+    PipelineWorkerPool pool(workerProgram, workerArguments, maxWorkers);
+    connect(&pool, &PipelineWorkerPool::jobMessage, this, &PipelineBatch::jobMessage);
+    connect(&pool, &PipelineWorkerPool::jobFinished, this, &PipelineBatch::jobFinished);
+    connect(&pool, &PipelineWorkerPool::idle, &loop, &QEventLoop::quit);
+    for(const PipelineJob& job : jobs)
+    {
+      pool.submit(job);
+    }
+    if(m_Results.size() < m_JobCount)
+    {
+      loop.exec();
+    }
+  }
+  qint64 wallMs = timer.elapsed();
+
+  printSummary(jobs, maxWorkers, wallMs);
+  if(!reportFile.isEmpty() && !writeReport(reportFile, jobs, maxWorkers, wallMs))
+  {
+    std::cout << "The report could not be written to " << reportFile.toStdString() << std::endl;
+  }
+
+  int failed = 0;
+  for(const Result& result : m_Results)
+  {
+    if(result.error < 0)
+    {
+      failed++;
+    }
+  }
+  return failed;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineBatch::jobMessage(const QString& id, const QJsonObject& message)
+{
+  if(message["type"].toString() == "Error")
+  {
+    std::cout << "  " << id.toStdString() << ": [" << message["index"].toInt() + 1 << "] " << message["filter"].toString().toStdString() << ": ERROR "
+              << message["code"].toInt() << ": " << message["text"].toString().toStdString() << std::endl;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineBatch::jobFinished(const QString& id, int error, qint64 elapsedMs, const QString& errorText)
+{
+  Result result;
+  result.error = error;
+  result.elapsedMs = elapsedMs;
+  result.errorText = errorText;
+  m_Results.insert(id, result);
+
+  int width = QString::number(m_JobCount).size();
+  QString line = QString("[%1/%2] %3: ").arg(m_Results.size(), width).arg(m_JobCount).arg(id);
+  if(error < 0)
+  {
+    line += QString("FAILED after %1 ms: %2").arg(elapsedMs).arg(errorText);
+  }
+  else
+  {
+    line += QString("OK in %1 ms").arg(elapsedMs);
+  }
+  std::cout << line.toStdString() << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineBatch::printSummary(const QVector<PipelineJob>& jobs, int maxWorkers, qint64 wallMs) const
+{
+  QVector<qint64> times;
+  QStringList failures;
+  for(const PipelineJob& job : jobs)
+  {
+    const Result result = m_Results.value(job.id);
+    times.push_back(result.elapsedMs);
+    if(result.error < 0)
+    {
+      failures << job.id;
+    }
+  }
+  std::sort(times.begin(), times.end());
+
+  std::cout << "----------------------------------------------------------------" << std::endl;
+  std::cout << "Jobs:       " << jobs.size() << " (" << jobs.size() - failures.size() << " succeeded, " << failures.size() << " failed)" << std::endl;
+  std::cout << "Workers:    " << maxWorkers << std::endl;
+  std::cout << "Wall time:  " << wallMs << " ms" << std::endl;
+  if(!times.isEmpty())
+  {
+    double total = 0.0;
+    for(qint64 t : times)
+    {
+      total += t;
+    }
+    double jobsPerMinute = wallMs > 0 ? jobs.size() * 60000.0 / wallMs : 0.0;
+    std::cout << "Throughput: " << QString::number(jobsPerMinute, 'f', 2).toStdString() << " jobs/min" << std::endl;
+    std::cout << "Job time:   min " << times.first() << " ms, median " << times[times.size() / 2] << " ms, max " << times.last() << " ms, mean "
+              << QString::number(total / times.size(), 'f', 0).toStdString() << " ms" << std::endl;
+  }
+  if(!failures.isEmpty())
+  {
+    std::cout << "Failed:     " << failures.join(", ").toStdString() << std::endl;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineBatch::writeReport(const QString& reportFile, const QVector<PipelineJob>& jobs, int maxWorkers, qint64 wallMs) const
+{
+  QJsonArray jobArray;
+  for(const PipelineJob& job : jobs)
+  {
+    const Result result = m_Results.value(job.id);
+    QJsonObject obj;
+    obj["id"] = job.id;
+    obj["pipeline"] = job.pipelineFile;
+    obj["overrides"] = job.overrides;
+    obj["error"] = result.error;
+    obj["elapsedMs"] = static_cast<double>(result.elapsedMs);
+    obj["errorText"] = result.errorText;
+    jobArray.append(obj);
+  }
+  QJsonObject report;
+  report["workers"] = maxWorkers;
+  report["wallMs"] = static_cast<double>(wallMs);
+  report["jobs"] = jobArray;
+
+  QSaveFile file(reportFile);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(QJsonDocument(report).toJson());
+  return file.commit();
+}
@@ -0,0 +1,115 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "Common/PipelineWorkerPool.h"
+
+/**
+ * @brief The PipelineBatch class runs one pipeline over many inputs. The jobs come from a manifest and are
+ * executed by a PipelineWorkerPool. A line is printed when each job finishes, followed by a summary of the
+ * throughput and the failures.
+ *
+ * A CSV manifest has a header row. The "id" and "pipeline" columns are optional and every other column
+ * is an override of the form "<filter index>:<parameter name>":
+ *
+ *   id,0:InputFile,7:OutputFile
+ *   scan01,/data/scan01.h5,/results/scan01.dream3d
+ *
+ * A JSON manifest is an array of jobs or an object with a "jobs" array and an optional "pipeline":
+ *
+ *   {"pipeline": "Segment.json", "jobs": [{"id": "scan01", "overrides": {"0:InputFile": "/data/scan01.h5"}}]}
+ *
+ * Pipeline paths in a manifest are relative to the manifest. Empty CSV cells leave the parameter unchanged.
+ */
+class PipelineBatch : public QObject
+{
+  Q_OBJECT
+
+public:
+  PipelineBatch(QObject* parent = nullptr);
+  ~PipelineBatch() override;
+
+  /**
+   * @brief Reads the jobs of a .csv or .json manifest
+   * @param manifestFile
+   * @param defaultPipeline The pipeline of jobs that do not name one
+   * @param jobs
+   * @param errorMessage
+   * @return
+   */
+  static bool ReadManifest(const QString& manifestFile, const QString& defaultPipeline, QVector<PipelineJob>& jobs, QString& errorMessage);
+
+  /**
+   * @brief Executes the jobs in worker processes and prints the progress and the summary
+   * @param jobs
+   * @param workerProgram
+   * @param workerArguments
+   * @param maxWorkers
+   * @param reportFile If not empty, a JSON report of all jobs is written here
+   * @return The number of jobs that failed
+   */
+  int run(const QVector<PipelineJob>& jobs, const QString& workerProgram, const QStringList& workerArguments, int maxWorkers, const QString& reportFile);
+
+protected slots:
+  void jobMessage(const QString& id, const QJsonObject& message);
+  void jobFinished(const QString& id, int error, qint64 elapsedMs, const QString& errorText);
+
+private:
+  struct Result
+  {
+    int error = 0;
+    qint64 elapsedMs = 0;
+    QString errorText;
+  };
+
+  int m_JobCount = 0;
+  QMap<QString, Result> m_Results;
+
+  void printSummary(const QVector<PipelineJob>& jobs, int maxWorkers, qint64 wallMs) const;
+  bool writeReport(const QString& reportFile, const QVector<PipelineJob>& jobs, int maxWorkers, qint64 wallMs) const;
+
+public:
+  PipelineBatch(const PipelineBatch&) = delete;            // Copy Constructor Not Implemented
+  PipelineBatch(PipelineBatch&&) = delete;                 // Move Constructor Not Implemented
+  PipelineBatch& operator=(const PipelineBatch&) = delete; // Copy Assignment Not Implemented
+  PipelineBatch& operator=(PipelineBatch&&) = delete;      // Move Assignment Not Implemented
+};
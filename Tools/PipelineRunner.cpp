@@ -0,0 +1,364 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* Runs a .json or .dream3d pipeline without any user interface. The plugins are found
+ * the same way SIMPLView finds them, but the ".plugin" libraries are loaded instead of
+ * the ".guiplugin" ones so that no widgets, fonts or platform plugins are needed.
+ * Progress is written to stdout one line per message.
+ *
+ * With --batch the pipeline is executed once for every job of a manifest by a pool of
+ * worker processes. The workers are this executable started with --worker; each loads
+ * the plugins once and then executes jobs until the batch is done. --sweep uses the same
+ * workers to execute the runs of a parameter sweep.
+ *
+ * --checkpoint-dir writes checkpoints of the DataContainerArray during a single run or
+ * during every --batch job, and --resume continues from the last checkpoint whose upstream
+ * filters did not change. --result-cache looks up the longest prefix of the pipeline in a
+ * cache directory that other sessions and machines share and stores expensive results there.
+ *
+ * --threads gives every run a fixed number of threads, so a --batch with --workers 4 and
+ * --threads 8 uses exactly 32 cores. SIMPL_NUM_THREADS sets the same default for all runs.
+ *
+ * --release-dead-arrays lowers the peak memory of a run by releasing every array as soon as
+ * no later filter reads it. Arrays that are only written at the end wait in --spill-dir.
+ *
+ * --service keeps running and accepts jobs from other programs on a local socket, see
+ * PipelineService for the protocol.
+ */
+
+#include <iostream>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Filtering/QMetaObjectUtilities.h"
+#include "SIMPLib/SIMPLibVersion.h"
+
+#include "Common/PipelineCheckpoint.h"
+#include "Common/PipelineExecutor.h"
+#include "Common/PipelineResultCache.h"
+#include "Common/PipelineService.h"
+#include "Common/PipelineWorker.h"
+#include "Common/SIMPLViewPluginLoader.h"
+
+#include "PipelineBatch.h"
+#include "PipelineSweep.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setOrganizationName("BlueQuartz Software");
+  QCoreApplication::setOrganizationDomain("bluequartz.net");
+  QCoreApplication::setApplicationName("PipelineRunner");
+  QCoreApplication::setApplicationVersion(SIMPLib::Version::Complete());
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Executes a SIMPL pipeline file without a user interface");
+  parser.addHelpOption();
+  parser.addVersionOption();
+  QCommandLineOption pipelineOption(QStringList() << "p"
+                                                  << "pipeline",
+                                    "Pipeline file (.json or .dream3d) to execute.", "file");
+  QCommandLineOption serialOption("serial-plugin-loading", "Load the plugin libraries one after another instead of concurrently.");
+  QCommandLineOption batchOption("batch", "Executes the pipeline once for every job of a .csv or .json manifest.", "manifest");
+  QCommandLineOption sweepOption("sweep", "Executes the runs of a JSON parameter sweep file.", "file");
+  QCommandLineOption noShareOption("no-shared-upstream", "Executes the filters that the --sweep does not change again for every run.");
+  QCommandLineOption serviceOption("service", "Runs as a pipeline execution service on a local socket until a client sends \"shutdown\".");
+  QCommandLineOption socketOption("socket", "Socket name for --service.", "name", PipelineService::DefaultServerName());
+  QCommandLineOption workersOption("workers", "Number of worker processes for --batch, --sweep and --service. The default is the number of cores.", "count",
+                                   QString::number(QThread::idealThreadCount()));
+  QCommandLineOption reportOption("report", "Writes a JSON report of all --batch jobs or --sweep runs to this file.", "file");
+  QCommandLineOption checkpointDirOption("checkpoint-dir", "Directory for checkpoints of the DataContainerArray, preferably on fast local scratch storage.", "dir");
+  QCommandLineOption checkpointEveryOption("checkpoint-every", "Writes a checkpoint after every N filters.", "N", "0");
+  QCommandLineOption checkpointSecondsOption("checkpoint-after-seconds", "Writes a checkpoint after any filter that takes at least this long.", "seconds", "0");
+  QCommandLineOption checkpointFiltersOption("checkpoint-after", "Writes a checkpoint after the filters with these comma separated indices.", "indices");
+  QCommandLineOption resumeOption("resume", "Resumes from the last valid checkpoint in --checkpoint-dir.");
+  QCommandLineOption resultCacheOption("result-cache", "Shared result cache directory, which may be on a network file system.", "dir");
+  QCommandLineOption resultCacheSizeOption("result-cache-size", "Size cap of the --result-cache in GB.", "GB", "50");
+  QCommandLineOption resultCacheSecondsOption("result-cache-min-seconds", "Stores the results of filters that take at least this long in the --result-cache.", "seconds", "10");
+  QCommandLineOption resultCacheStatsOption("result-cache-stats", "Prints the hit and miss counters and the size of the --result-cache and exits.");
+  QCommandLineOption concurrentOption("concurrent-filters", "Executes up to N filters that work on different data containers at the same time.", "N", "1");
+  QCommandLineOption threadsOption("threads", "Number of threads each pipeline run may use. The default is SIMPL_NUM_THREADS or the number of cores.", "N", "0");
+  QCommandLineOption bufferPoolOption("buffer-pool", "Keeps up to this much freed array storage for reuse by later filters of a run.", "MB", "0");
+  QCommandLineOption releaseOption("release-dead-arrays", "Releases every array as soon as no later filter reads it. Ignored while checkpoints or caches are used.");
+  QCommandLineOption spillDirOption("spill-dir", "With --release-dead-arrays, keeps arrays that a later filter only writes to a file in this directory until then.", "dir");
+  QCommandLineOption workerOption("worker", "Runs as a worker process of --batch, --sweep and --service. Jobs are read from stdin.");
+  parser.addOption(pipelineOption);
+  parser.addOption(serialOption);
+  parser.addOption(batchOption);
+  parser.addOption(sweepOption);
+  parser.addOption(noShareOption);
+  parser.addOption(serviceOption);
+  parser.addOption(socketOption);
+  parser.addOption(workersOption);
+  parser.addOption(reportOption);
+  parser.addOption(checkpointDirOption);
+  parser.addOption(checkpointEveryOption);
+  parser.addOption(checkpointSecondsOption);
+  parser.addOption(checkpointFiltersOption);
+  parser.addOption(resumeOption);
+  parser.addOption(resultCacheOption);
+  parser.addOption(resultCacheSizeOption);
+  parser.addOption(resultCacheSecondsOption);
+  parser.addOption(resultCacheStatsOption);
+  parser.addOption(concurrentOption);
+  parser.addOption(threadsOption);
+  parser.addOption(bufferPoolOption);
+  parser.addOption(releaseOption);
+  parser.addOption(spillDirOption);
+  parser.addOption(workerOption);
+  parser.addPositionalArgument("pipeline", "Pipeline file to execute if --pipeline is not given.", "[pipeline]");
+  parser.process(app);
+
+  QString pipelineFile = parser.value(pipelineOption);
+  if(pipelineFile.isEmpty() && !parser.positionalArguments().isEmpty())
+  {
+    pipelineFile = parser.positionalArguments().first();
+  }
+  // Loading the plugins may change the working directory
+  if(!pipelineFile.isEmpty())
+  {
+    pipelineFile = QDir::current().absoluteFilePath(pipelineFile);
+  }
+
+  PipelineCheckpointPolicy checkpointPolicy;
+  if(parser.isSet(checkpointDirOption))
+  {
+    checkpointPolicy.directory = QDir::current().absoluteFilePath(parser.value(checkpointDirOption));
+  }
+  checkpointPolicy.everyFilters = parser.value(checkpointEveryOption).toInt();
+  checkpointPolicy.minimumSeconds = parser.value(checkpointSecondsOption).toDouble();
+  for(const QString& index : parser.value(checkpointFiltersOption).split(',', QString::SkipEmptyParts))
+  {
+    checkpointPolicy.afterFilters.push_back(index.trimmed().toInt());
+  }
+  checkpointPolicy.resume = parser.isSet(resumeOption);
+  if(checkpointPolicy.directory.isEmpty() && (checkpointPolicy.resume || checkpointPolicy.everyFilters > 0 || checkpointPolicy.minimumSeconds > 0.0 || !checkpointPolicy.afterFilters.isEmpty()))
+  {
+    std::cout << "Checkpoints need a --checkpoint-dir." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  QString spillDirectory;
+  if(parser.isSet(spillDirOption))
+  {
+    if(!parser.isSet(releaseOption))
+    {
+      std::cout << "--spill-dir needs --release-dead-arrays." << std::endl;
+      return EXIT_FAILURE;
+    }
+    spillDirectory = QDir::current().absoluteFilePath(parser.value(spillDirOption));
+  }
+
+  QJsonObject resultCacheSettings;
+  if(parser.isSet(resultCacheOption))
+  {
+    resultCacheSettings["directory"] = QDir::current().absoluteFilePath(parser.value(resultCacheOption));
+    resultCacheSettings["maxGB"] = parser.value(resultCacheSizeOption).toDouble();
+    resultCacheSettings["minimumSeconds"] = parser.value(resultCacheSecondsOption).toDouble();
+  }
+  if(parser.isSet(resultCacheStatsOption))
+  {
+    if(resultCacheSettings.isEmpty())
+    {
+      std::cout << "--result-cache-stats needs a --result-cache." << std::endl;
+      return EXIT_FAILURE;
+    }
+    QJsonObject stats = PipelineResultCache::ReadStatistics(resultCacheSettings["directory"].toString());
+    std::cout << QJsonDocument(stats).toJson().toStdString();
+    return EXIT_SUCCESS;
+  }
+
+  QStringList workerArguments;
+  workerArguments << "--worker";
+  if(parser.isSet(serialOption))
+  {
+    workerArguments << "--serial-plugin-loading";
+  }
+
+  // The execution settings that the jobs of --batch, --sweep and --service pass on to the workers
+  PipelineJob jobSettings;
+  jobSettings.resultCache = resultCacheSettings;
+  jobSettings.concurrentFilters = parser.value(concurrentOption).toInt();
+  jobSettings.threads = parser.value(threadsOption).toInt();
+  jobSettings.bufferPoolMB = parser.value(bufferPoolOption).toInt();
+  jobSettings.releaseDeadArrays = parser.isSet(releaseOption);
+  jobSettings.spillDirectory = spillDirectory;
+
+  if(checkpointPolicy.isEnabled() && (parser.isSet(serviceOption) || parser.isSet(sweepOption)))
+  {
+    // All jobs would write their checkpoints to the same directory
+    std::cout << "Checkpoints can only be used with a single pipeline or --batch." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if(parser.isSet(serviceOption))
+  {
+    PipelineService service(QCoreApplication::applicationFilePath(), workerArguments, parser.value(workersOption).toInt());
+    service.setJobSettings(jobSettings);
+    if(!service.listen(parser.value(socketOption)))
+    {
+      std::cout << "The service could not listen on " << parser.value(socketOption).toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+    QObject::connect(&service, &PipelineService::shutdownRequested, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+    std::cout << "Listening on " << service.fullServerName().toStdString() << " with " << parser.value(workersOption).toStdString() << " workers" << std::endl;
+    return app.exec();
+  }
+
+  if(parser.isSet(sweepOption))
+  {
+    QString errorMessage;
+    PipelineSweep sweep;
+    if(!sweep.readSweepFile(parser.value(sweepOption), errorMessage))
+    {
+      std::cout << errorMessage.toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+    sweep.setJobSettings(jobSettings);
+    int failed = sweep.run(QCoreApplication::applicationFilePath(), workerArguments, parser.value(workersOption).toInt(), !parser.isSet(noShareOption), parser.value(reportOption));
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  if(parser.isSet(batchOption))
+  {
+    QVector<PipelineJob> jobs;
+    QString errorMessage;
+    if(!PipelineBatch::ReadManifest(parser.value(batchOption), pipelineFile, jobs, errorMessage))
+    {
+      std::cout << errorMessage.toStdString() << std::endl;
+      return EXIT_FAILURE;
+    }
+    if(checkpointPolicy.isEnabled())
+    {
+      for(PipelineJob& job : jobs)
+      {
+        job.checkpointPolicy = checkpointPolicy.toJson();
+      }
+    }
+    for(PipelineJob& job : jobs)
+    {
+      job.resultCache = jobSettings.resultCache;
+      job.concurrentFilters = jobSettings.concurrentFilters;
+      job.threads = jobSettings.threads;
+      job.bufferPoolMB = jobSettings.bufferPoolMB;
+      job.releaseDeadArrays = jobSettings.releaseDeadArrays;
+      job.spillDirectory = jobSettings.spillDirectory;
+    }
+    PipelineBatch batch;
+    int failed = batch.run(jobs, QCoreApplication::applicationFilePath(), workerArguments, parser.value(workersOption).toInt(), parser.value(reportOption));
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  bool workerMode = parser.isSet(workerOption);
+  if(pipelineFile.isEmpty() && !workerMode)
+  {
+    std::cout << "A pipeline file must be given." << std::endl;
+    parser.showHelp(EXIT_FAILURE);
+  }
+
+  // The worker claims stdout for its events before anything, including the plugins, can print to it
+  QScopedPointer<PipelineWorker> worker;
+  if(workerMode)
+  {
+    worker.reset(new PipelineWorker);
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Register all the filters including trying to load those from Plugins
+  FilterManager* filterManager = FilterManager::Instance();
+  FilterManager::RegisterKnownFilters(filterManager);
+  QStringList pluginFilePaths;
+  foreach(QString pluginDir, SIMPLViewPluginLoader::PluginDirectories(QCoreApplication::applicationDirPath()))
+  {
+    pluginFilePaths << SIMPLViewPluginLoader::FindPluginFiles(pluginDir, "plugin");
+  }
+  QVector<QPluginLoader*> loaders;
+  QVector<ISIMPLibPlugin*> plugins = SIMPLViewPluginLoader::LoadPlugins(pluginFilePaths, filterManager, !parser.isSet(serialOption), loaders);
+  QMetaObjectUtilities::RegisterMetaTypes();
+  if(nullptr != worker.data())
+  {
+    return worker->run();
+  }
+  std::cout << "Loaded " << plugins.size() << " plugins in " << timer.elapsed() << " ms" << std::endl;
+
+  QString errorMessage;
+  FilterPipeline::Pointer pipeline = PipelineExecutor::ReadPipelineFromFile(pipelineFile, errorMessage);
+  if(nullptr == pipeline.get())
+  {
+    std::cout << errorMessage.toStdString() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Pipeline File: " << pipelineFile.toStdString() << std::endl;
+
+  timer.restart();
+  PipelineExecutor executor;
+  executor.setCheckpointPolicy(checkpointPolicy);
+  PipelineResultCache resultCache;
+  resultCache.configure(resultCacheSettings);
+  executor.setResultCache(&resultCache);
+  executor.setMaxConcurrentFilters(parser.value(concurrentOption).toInt());
+  executor.setMaxThreads(parser.value(threadsOption).toInt());
+  executor.setBufferPoolSize(parser.value(bufferPoolOption).toLongLong() * 1024 * 1024);
+  executor.setReleaseDeadArrays(parser.isSet(releaseOption), spillDirectory);
+  int err = executor.execute(pipeline);
+  if(resultCache.isEnabled())
+  {
+    QJsonObject stats = resultCache.statistics();
+    std::cout << "Result cache: " << stats["hits"].toInt() << " hits, " << stats["misses"].toInt() << " misses, " << stats["stores"].toInt() << " stored, "
+              << stats["evictions"].toInt() << " evicted" << std::endl;
+  }
+  if(err < 0)
+  {
+    std::cout << "The pipeline failed with error " << err << " after " << timer.elapsed() << " ms" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "The pipeline finished in " << timer.elapsed() << " ms" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,565 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "PipelineSweep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTemporaryDir>
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int FilterIndexOfKey(const QString& key)
+{
+  bool ok = false;
+  int index = key.left(key.indexOf(':')).toInt(&ok);
+  if(key.indexOf(':') < 0 || !ok || index < 0)
+  {
+    return -1;
+  }
+  return index;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ValueToString(const QJsonValue& value)
+{
+  if(value.isString())
+  {
+    return value.toString();
+  }
+  if(value.isDouble())
+  {
+    return QString::number(value.toDouble());
+  }
+  if(value.isBool())
+  {
+    return value.toBool() ? "true" : "false";
+  }
+  QJsonArray wrapper;
+  wrapper.append(value);
+  QByteArray json = QJsonDocument(wrapper).toJson(QJsonDocument::Compact);
+  return QString::fromUtf8(json.mid(1, json.size() - 2));
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineSweep::PipelineSweep(QObject* parent)
+: QObject(parent)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+PipelineSweep::~PipelineSweep() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineSweep::readSweepFile(const QString& sweepFile, QString& errorMessage)
+{
+  QFile file(sweepFile);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    errorMessage = QString("The sweep file '%1' could not be opened").arg(sweepFile);
+    return false;
+  }
+  QJsonParseError parseError;
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+  if(parseError.error != QJsonParseError::NoError || !doc.isObject())
+  {
+    errorMessage = QString("The sweep file '%1' is not a JSON object: %2").arg(sweepFile).arg(parseError.errorString());
+    return false;
+  }
+  QJsonObject sweep = doc.object();
+
+  if(sweep["pipeline"].toString().isEmpty())
+  {
+    errorMessage = "The sweep file does not name a \"pipeline\"";
+    return false;
+  }
+  QDir sweepDir = QFileInfo(sweepFile).absoluteDir();
+  m_SweepDir = sweepDir.absolutePath();
+  m_PipelineFile = QDir::cleanPath(sweepDir.absoluteFilePath(sweep["pipeline"].toString()));
+  m_Mode = sweep["mode"].toString("cartesian");
+  m_Samples = sweep["samples"].toInt();
+  m_Seed = static_cast<unsigned int>(sweep["seed"].toInt(1));
+  m_Outputs = sweep["outputs"].toObject();
+
+  int firstChangingFilter = std::numeric_limits<int>::max();
+  for(QJsonObject::const_iterator iter = m_Outputs.constBegin(); iter != m_Outputs.constEnd(); ++iter)
+  {
+    int index = FilterIndexOfKey(iter.key());
+    if(index < 0)
+    {
+      errorMessage = QString("The output '%1' must have the form <filter index>:<parameter name>").arg(iter.key());
+      return false;
+    }
+    firstChangingFilter = qMin(firstChangingFilter, index);
+  }
+
+  m_Dimensions.clear();
+  QJsonObject parameters = sweep["parameters"].toObject();
+  for(QJsonObject::const_iterator iter = parameters.constBegin(); iter != parameters.constEnd(); ++iter)
+  {
+    Dimension dimension;
+    dimension.key = iter.key();
+    dimension.filterIndex = FilterIndexOfKey(iter.key());
+    if(dimension.filterIndex < 0)
+    {
+      errorMessage = QString("The parameter '%1' must have the form <filter index>:<parameter name>").arg(iter.key());
+      return false;
+    }
+    QJsonObject range = iter.value().toObject();
+    if(iter.value().isArray())
+    {
+      dimension.values = iter.value().toArray();
+    }
+    else if(range.contains("values"))
+    {
+      dimension.values = range["values"].toArray();
+    }
+    else if(range.contains("min") && range.contains("max"))
+    {
+      dimension.range = true;
+      dimension.min = range["min"].toDouble();
+      dimension.max = range["max"].toDouble();
+      dimension.steps = range["steps"].toInt(2);
+      dimension.integer = range["integer"].toBool();
+    }
+    if(!dimension.range && dimension.values.isEmpty())
+    {
+      errorMessage = QString("The parameter '%1' needs a list of values or a \"min\" and \"max\"").arg(iter.key());
+      return false;
+    }
+    firstChangingFilter = qMin(firstChangingFilter, dimension.filterIndex);
+    m_Dimensions.push_back(dimension);
+  }
+  if(m_Dimensions.isEmpty())
+  {
+    errorMessage = "The sweep file has no \"parameters\"";
+    return false;
+  }
+  m_SharedFilters = firstChangingFilter;
+
+  m_Runs.clear();
+  if(m_Mode == "cartesian")
+  {
+    expandCartesian();
+  }
+  else if(m_Mode == "latin-hypercube")
+  {
+    if(m_Samples <= 0)
+    {
+      errorMessage = "A latin-hypercube sweep needs a positive number of \"samples\"";
+      return false;
+    }
+    expandLatinHypercube();
+  }
+  else
+  {
+    errorMessage = QString("Unknown sweep mode '%1'. Use \"cartesian\" or \"latin-hypercube\"").arg(m_Mode);
+    return false;
+  }
+
+  int width = QString::number(m_Runs.size()).size();
+  m_RunIndices.clear();
+  for(int i = 0; i < m_Runs.size(); i++)
+  {
+    m_Runs[i].id = QString("run-%1").arg(i + 1, width, 10, QChar('0'));
+    m_RunIndices.insert(m_Runs[i].id, i);
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineSweep::runCount() const
+{
+  return m_Runs.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonArray PipelineSweep::RangeValues(const Dimension& dimension)
+{
+  QJsonArray values;
+  int steps = qMax(1, dimension.steps);
+  for(int i = 0; i < steps; i++)
+  {
+    double value = steps == 1 ? dimension.min : dimension.min + (dimension.max - dimension.min) * i / (steps - 1);
+    if(dimension.integer)
+    {
+      value = std::round(value);
+      if(!values.isEmpty() && values.last().toDouble() == value)
+      {
+        continue;
+      }
+    }
+    values.append(value);
+  }
+  return values;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSweep::expandCartesian()
+{
+  QVector<QJsonArray> values;
+  for(const Dimension& dimension : m_Dimensions)
+  {
+    values.push_back(dimension.range ? RangeValues(dimension) : dimension.values);
+  }
+
+  // Count through the combinations with the last parameter changing fastest
+  QVector<int> counter(values.size(), 0);
+  while(true)
+  {
+    Run run;
+    for(int d = 0; d < values.size(); d++)
+    {
+      run.parameters[m_Dimensions[d].key] = values[d][counter[d]];
+    }
+    m_Runs.push_back(run);
+
+    int d = values.size() - 1;
+    while(d >= 0 && ++counter[d] == values[d].size())
+    {
+      counter[d] = 0;
+      d--;
+    }
+    if(d < 0)
+    {
+      break;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSweep::expandLatinHypercube()
+{
+  std::mt19937 generator(m_Seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  m_Runs.resize(m_Samples);
+
+  // Every parameter visits each of the 'm_Samples' strata of its range exactly once, in a random order
+  for(const Dimension& dimension : m_Dimensions)
+  {
+    std::vector<int> strata(m_Samples);
+    std::iota(strata.begin(), strata.end(), 0);
+    std::shuffle(strata.begin(), strata.end(), generator);
+    for(int s = 0; s < m_Samples; s++)
+    {
+      double u = (strata[s] + uniform(generator)) / m_Samples;
+      QJsonValue value;
+      if(!dimension.range)
+      {
+        int index = qMin(static_cast<int>(u * dimension.values.size()), dimension.values.size() - 1);
+        value = dimension.values[index];
+      }
+      else if(dimension.integer)
+      {
+        double span = dimension.max - dimension.min + 1.0;
+        value = qMin(std::floor(dimension.min + u * span), dimension.max);
+      }
+      else
+      {
+        value = dimension.min + u * (dimension.max - dimension.min);
+      }
+      m_Runs[s].parameters[dimension.key] = value;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject PipelineSweep::runOverrides(int index) const
+{
+  QJsonObject overrides = m_Runs[index].parameters;
+  for(QJsonObject::const_iterator iter = m_Outputs.constBegin(); iter != m_Outputs.constEnd(); ++iter)
+  {
+    QJsonValue value = iter.value();
+    if(value.isString())
+    {
+      QString text = value.toString();
+      text.replace("{id}", m_Runs[index].id);
+      text.replace("{run}", QString::number(index + 1));
+      text.replace("{dir}", m_SweepDir);
+      value = text;
+    }
+    overrides[iter.key()] = value;
+  }
+  return overrides;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSweep::setJobSettings(const PipelineJob& settings)
+{
+  m_JobSettings = settings;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int PipelineSweep::run(const QString& workerProgram, const QStringList& workerArguments, int maxWorkers, bool shareUpstream, const QString& reportFile)
+{
+  m_FinishedRuns = 0;
+  m_UpstreamMs = -1;
+  maxWorkers = qMax(1, qMin(maxWorkers, m_Runs.size()));
+  std::cout << "Sweeping " << m_Dimensions.size() << " parameters of " << m_PipelineFile.toStdString() << " in " << m_Runs.size() << " runs with " << maxWorkers << " workers"
+            << std::endl;
+
+  QElapsedTimer timer;
+  timer.start();
+  QTemporaryDir checkpointDir;
+  QEventLoop loop;
+  PipelineWorkerPool pool(workerProgram, workerArguments, maxWorkers);
+  m_Pool = &pool;
+  connect(&pool, &PipelineWorkerPool::jobFinished, this, &PipelineSweep::jobFinished);
+  connect(&pool, &PipelineWorkerPool::idle, &loop, &QEventLoop::quit);
+  connect(&pool, &PipelineWorkerPool::jobMessage, this, [](const QString& id, const QJsonObject& message) {
+    if(message["type"].toString() == "Error")
+    {
+      std::cout << "  " << id.toStdString() << ": [" << message["index"].toInt() + 1 << "] " << message["filter"].toString().toStdString() << ": ERROR "
+                << message["code"].toInt() << ": " << message["text"].toString().toStdString() << std::endl;
+    }
+  });
+
+  if(shareUpstream && m_SharedFilters > 0 && checkpointDir.isValid())
+  {
+    m_CheckpointFile = checkpointDir.filePath("Upstream.dream3d");
+    std::cout << "Executing the first " << m_SharedFilters << " filters once for all runs" << std::endl;
+    PipelineJob job = m_JobSettings;
+    job.id = "upstream";
+    job.pipelineFile = m_PipelineFile;
+    job.checkpointFile = m_CheckpointFile;
+    job.checkpointFilters = m_SharedFilters;
+    job.writeCheckpoint = true;
+    pool.submit(job);
+  }
+  else
+  {
+    submitRuns(false);
+  }
+  if(m_FinishedRuns < m_Runs.size())
+  {
+    loop.exec();
+  }
+  m_Pool = nullptr;
+  qint64 wallMs = timer.elapsed();
+
+  printReport(wallMs);
+  if(!reportFile.isEmpty() && !writeReport(reportFile, wallMs))
+  {
+    std::cout << "The report could not be written to " << reportFile.toStdString() << std::endl;
+  }
+
+  int failed = 0;
+  for(const Run& run : m_Runs)
+  {
+    if(run.error < 0)
+    {
+      failed++;
+    }
+  }
+  return failed;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSweep::submitRuns(bool useCheckpoint)
+{
+  for(int i = 0; i < m_Runs.size(); i++)
+  {
+    PipelineJob job = m_JobSettings;
+    job.id = m_Runs[i].id;
+    job.pipelineFile = m_PipelineFile;
+    job.overrides = runOverrides(i);
+    if(useCheckpoint)
+    {
+      job.checkpointFile = m_CheckpointFile;
+      job.checkpointFilters = m_SharedFilters;
+    }
+    m_Pool->submit(job);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSweep::jobFinished(const QString& id, int error, qint64 elapsedMs, const QString& errorText)
+{
+  if(!m_RunIndices.contains(id))
+  {
+    m_UpstreamMs = elapsedMs;
+    if(error < 0)
+    {
+      std::cout << "The shared filters failed after " << elapsedMs << " ms (" << errorText.toStdString() << "). Every run executes the whole pipeline." << std::endl;
+      m_SharedFilters = 0;
+      submitRuns(false);
+    }
+    else
+    {
+      std::cout << "The shared filters finished in " << elapsedMs << " ms" << std::endl;
+      submitRuns(true);
+    }
+    return;
+  }
+
+  Run& run = m_Runs[m_RunIndices[id]];
+  run.error = error;
+  run.elapsedMs = elapsedMs;
+  run.errorText = errorText;
+  m_FinishedRuns++;
+
+  QStringList values;
+  for(const Dimension& dimension : m_Dimensions)
+  {
+    values << QString("%1=%2").arg(dimension.key).arg(ValueToString(run.parameters[dimension.key]));
+  }
+  int width = QString::number(m_Runs.size()).size();
+  QString line = QString("[%1/%2] %3 %4: ").arg(m_FinishedRuns, width).arg(m_Runs.size()).arg(id).arg(values.join(" "));
+  line += error < 0 ? QString("FAILED after %1 ms: %2").arg(elapsedMs).arg(errorText) : QString("OK in %1 ms").arg(elapsedMs);
+  std::cout << line.toStdString() << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PipelineSweep::printReport(qint64 wallMs) const
+{
+  QStringList columns;
+  columns << "Run";
+  for(const Dimension& dimension : m_Dimensions)
+  {
+    columns << dimension.key;
+  }
+  columns << "Result"
+          << "Time (ms)";
+
+  int failed = 0;
+  std::cout << "----------------------------------------------------------------" << std::endl;
+  std::cout << columns.join("\t").toStdString() << std::endl;
+  for(const Run& run : m_Runs)
+  {
+    QStringList cells;
+    cells << run.id;
+    for(const Dimension& dimension : m_Dimensions)
+    {
+      cells << ValueToString(run.parameters[dimension.key]);
+    }
+    cells << (run.error < 0 ? QString("FAILED %1").arg(run.error) : QString("OK")) << QString::number(run.elapsedMs);
+    std::cout << cells.join("\t").toStdString() << std::endl;
+    if(run.error < 0)
+    {
+      failed++;
+    }
+  }
+  std::cout << "----------------------------------------------------------------" << std::endl;
+  std::cout << "Runs:           " << m_Runs.size() << " (" << m_Runs.size() - failed << " succeeded, " << failed << " failed)" << std::endl;
+  if(m_UpstreamMs >= 0)
+  {
+    std::cout << "Shared filters: " << m_SharedFilters << " executed once in " << m_UpstreamMs << " ms" << std::endl;
+  }
+  std::cout << "Wall time:      " << wallMs << " ms" << std::endl;
+  if(wallMs > 0)
+  {
+    std::cout << "Throughput:     " << QString::number(m_Runs.size() * 60000.0 / wallMs, 'f', 2).toStdString() << " runs/min" << std::endl;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool PipelineSweep::writeReport(const QString& reportFile, qint64 wallMs) const
+{
+  QJsonArray runs;
+  for(int i = 0; i < m_Runs.size(); i++)
+  {
+    const Run& run = m_Runs[i];
+    QJsonObject obj;
+    obj["id"] = run.id;
+    obj["parameters"] = run.parameters;
+    obj["overrides"] = runOverrides(i);
+    obj["error"] = run.error;
+    obj["elapsedMs"] = static_cast<double>(run.elapsedMs);
+    obj["errorText"] = run.errorText;
+    runs.append(obj);
+  }
+  QJsonObject report;
+  report["pipeline"] = m_PipelineFile;
+  report["mode"] = m_Mode;
+  report["seed"] = static_cast<double>(m_Seed);
+  report["sharedFilters"] = m_UpstreamMs >= 0 ? m_SharedFilters : 0;
+  report["sharedFiltersMs"] = static_cast<double>(m_UpstreamMs);
+  report["wallMs"] = static_cast<double>(wallMs);
+  report["runs"] = runs;
+
+  QSaveFile file(reportFile);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(QJsonDocument(report).toJson());
+  return file.commit();
+}
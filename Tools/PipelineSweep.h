@@ -0,0 +1,187 @@
+/* ============================================================================
+* Copyright (c) 2009-2016 BlueQuartz Software, LLC
+*
+* Redistribution and use in source and binary forms, with or without modification,
+* are permitted provided that the following conditions are met:
+*
+* Redistributions of source code must retain the above copyright notice, this
+* list of conditions and the following disclaimer.
+*
+* Redistributions in binary form must reproduce the above copyright notice, this
+* list of conditions and the following disclaimer in the documentation and/or
+* other materials provided with the distribution.
+*
+* Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+* contributors may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+* USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* The code contained herein was partially funded by the followig contracts:
+*    United States Air Force Prime Contract FA8650-07-D-5800
+*    United States Air Force Prime Contract FA8650-10-D-5210
+*    United States Prime Contract Navy N00173-07-C-2068
+*
+* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "Common/PipelineWorkerPool.h"
+
+/**
+ * @brief The PipelineSweep class executes a pipeline for every combination of a set of filter parameter values.
+ * The sweep is described by a JSON file:
+ *
+ *   {
+ *     "pipeline": "Segment.json",
+ *     "mode": "cartesian",
+ *     "parameters": {
+ *       "5:MisorientationTolerance": [3.0, 4.0, 5.0],
+ *       "8:MinAllowedFeatureSize": {"min": 4, "max": 64, "steps": 5, "integer": true}
+ *     },
+ *     "outputs": {"12:OutputFile": "{dir}/Results/{id}.dream3d"}
+ *   }
+ *
+ * "cartesian" executes every combination of the parameter values, where a {"min", "max", "steps"} range is
+ * divided into 'steps' evenly spaced values. "latin-hypercube" executes "samples" runs whose values are
+ * stratified over every range or list independently, using the random "seed". The "outputs" are overrides
+ * that are the same for every run except for the {id} (run id), {run} (run number) and {dir} (directory of
+ * the sweep file) placeholders, so that each run writes its own files.
+ *
+ * The filters before the first one with a swept parameter or output are the same for every run. They are
+ * executed once and their result is shared with all runs through a checkpoint file, see PipelineCheckpoint.
+ * The runs are executed by a PipelineWorkerPool and a single report with the parameter values, the result
+ * and the time of every run is printed and optionally written as JSON.
+ */
+class PipelineSweep : public QObject
+{
+  Q_OBJECT
+
+public:
+  PipelineSweep(QObject* parent = nullptr);
+  ~PipelineSweep() override;
+
+  /**
+   * @brief Reads a sweep file and expands it into the runs
+   * @param sweepFile
+   * @param errorMessage
+   * @return
+   */
+  bool readSweepFile(const QString& sweepFile, QString& errorMessage);
+
+  /**
+   * @brief Returns the number of runs of the sweep
+   * @return
+   */
+  int runCount() const;
+
+  /**
+   * @brief Sets the result cache, concurrency, thread, buffer pool and dead array settings that every run
+   * and the shared upstream filters are executed with. The id, pipeline and overrides of 'settings' are
+   * not used.
+   * @param settings
+   */
+  void setJobSettings(const PipelineJob& settings);
+
+  /**
+   * @brief Executes the runs and prints the report
+   * @param workerProgram
+   * @param workerArguments
+   * @param maxWorkers
+   * @param shareUpstream Execute the filters that do not change once for all runs
+   * @param reportFile If not empty, the report is written here as JSON
+   * @return The number of runs that failed
+   */
+  int run(const QString& workerProgram, const QStringList& workerArguments, int maxWorkers, bool shareUpstream, const QString& reportFile);
+
+protected slots:
+  void jobFinished(const QString& id, int error, qint64 elapsedMs, const QString& errorText);
+
+private:
+  struct Dimension
+  {
+    QString key;
+    int filterIndex = 0;
+    QJsonArray values;
+    bool range = false;
+    double min = 0.0;
+    double max = 0.0;
+    int steps = 0;
+    bool integer = false;
+  };
+
+  struct Run
+  {
+    QString id;
+    QJsonObject parameters;
+    int error = 0;
+    qint64 elapsedMs = 0;
+    QString errorText;
+  };
+
+  QString m_PipelineFile;
+  QString m_Mode;
+  int m_Samples = 0;
+  unsigned int m_Seed = 1;
+  QVector<Dimension> m_Dimensions;
+  QJsonObject m_Outputs;
+  QString m_SweepDir;
+  QVector<Run> m_Runs;
+  QMap<QString, int> m_RunIndices;
+  int m_FinishedRuns = 0;
+
+  int m_SharedFilters = 0;
+  QString m_CheckpointFile;
+  PipelineJob m_JobSettings;
+  PipelineWorkerPool* m_Pool = nullptr;
+  qint64 m_UpstreamMs = -1;
+
+  /**
+   * @brief Converts a {"min", "max", "steps"} range to its list of values
+   * @param dimension
+   * @return
+   */
+  static QJsonArray RangeValues(const Dimension& dimension);
+
+  void expandCartesian();
+  void expandLatinHypercube();
+
+  /**
+   * @brief Returns the overrides of a run: its parameter values and the outputs with the placeholders replaced
+   * @param index
+   * @return
+   */
+  QJsonObject runOverrides(int index) const;
+
+  /**
+   * @brief Queues all runs, starting from the checkpoint if the upstream filters were executed
+   * @param useCheckpoint
+   */
+  void submitRuns(bool useCheckpoint);
+
+  void printReport(qint64 wallMs) const;
+  bool writeReport(const QString& reportFile, qint64 wallMs) const;
+
+public:
+  PipelineSweep(const PipelineSweep&) = delete;            // Copy Constructor Not Implemented
+  PipelineSweep(PipelineSweep&&) = delete;                 // Move Constructor Not Implemented
+  PipelineSweep& operator=(const PipelineSweep&) = delete; // Copy Assignment Not Implemented
+  PipelineSweep& operator=(PipelineSweep&&) = delete;      // Move Assignment Not Implemented
+};